@@ -0,0 +1,522 @@
+#pragma once
+
+#include "main.h"
+#include "Util/DataTypes.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		static const uint16_t COLONY_NO_INDEX = 0xFFFF;
+
+		template <typename T>
+		union ColonySlot
+		{
+			T value;
+
+			//The first slot of a run of erased slots links the runs of its block into a free list
+			struct
+			{
+				uint16_t m_prev;
+				uint16_t m_next;
+			} m_free;
+
+			ColonySlot() {}
+			~ColonySlot() {}
+		};
+
+		template <typename T>
+		struct ColonyBlock
+		{
+			ColonyBlock* m_next;
+			ColonyBlock* m_prev;
+			ColonyBlock* m_nextWithFree;
+			ColonyBlock* m_prevWithFree;
+
+			ColonySlot<T>* m_slots;
+
+			//Jump-counting skipfield: 0 for live slots. The first and the last slot of a run of erased slots
+			//hold the length of the run, so iteration jumps over the whole run in one step. It has one entry
+			//more than there are slots, which stays 0.
+			uint16_t* m_skipfield;
+
+			byte* m_allocation;
+			size_t m_allocationSize;
+
+			size_t m_capacity;
+			size_t m_high; //Slots from here on were never used
+			size_t m_live;
+			uint16_t m_freeHead;
+			bool m_hasFreeRuns;
+		};
+	}
+
+	//Bucketed container with stable element addresses. Elements live in blocks of growing size. Erased slots
+	//are jumped over during iteration with a skipfield and reused by later inserts. Insert and erase are O(1),
+	//a block is given back as soon as its last element is erased.
+	template <typename T, typename Allocator = std::allocator<byte>>
+	class Colony
+	{
+	private:
+		typedef INTERNAL::ColonySlot<T> Slot;
+		typedef INTERNAL::ColonyBlock<T> Block;
+
+		static const size_t COLONY_MIN_BLOCK_CAPACITY = 16;
+		static const size_t COLONY_MAX_BLOCK_CAPACITY = 8192;
+
+	public:
+		class Iterator
+		{
+		private:
+			friend class Colony;
+
+			Block* m_block;
+			size_t m_index;
+
+			Iterator(Block* block, size_t index)
+				: m_block(block), m_index(index)
+			{
+				skipToLive();
+			}
+
+			void skipToLive()
+			{
+				while (m_block != nullptr)
+				{
+					m_index += m_block->m_skipfield[m_index];
+					if (m_index < m_block->m_high)
+					{
+						return;
+					}
+					m_block = m_block->m_next;
+					m_index = 0;
+				}
+			}
+
+		public:
+			T& operator*() const
+			{
+				return m_block->m_slots[m_index].value;
+			}
+
+			T* operator->() const
+			{
+				return &m_block->m_slots[m_index].value;
+			}
+
+			Iterator& operator++()
+			{
+				m_index++;
+				skipToLive();
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const
+			{
+				return m_block == other.m_block && m_index == other.m_index;
+			}
+
+			bool operator!=(const Iterator& other) const
+			{
+				return !(*this == other);
+			}
+		};
+
+	private:
+		Block* m_first = nullptr;
+		Block* m_last = nullptr;
+		Block* m_firstWithFree = nullptr; //Blocks which have erased slots to reuse
+		size_t m_length = 0;
+		size_t m_nextCapacity = COLONY_MIN_BLOCK_CAPACITY;
+
+		Allocator* m_parentAllocator = nullptr;
+		bool m_needsToDeleteParentAllocator = false;
+
+		void appendBlock()
+		{
+			const size_t capacity = m_nextCapacity;
+			if (m_nextCapacity < COLONY_MAX_BLOCK_CAPACITY)
+			{
+				m_nextCapacity *= 2;
+			}
+
+			//Header, slots and skipfield are one allocation, the header and the slots are aligned for Slot
+			const size_t slotOffset = (sizeof(Block) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+			const size_t skipfieldOffset = slotOffset + capacity * sizeof(Slot);
+			const size_t allocationSize = skipfieldOffset + (capacity + 1) * sizeof(uint16_t) + alignof(Slot) + alignof(Block);
+
+			byte* allocation = m_parentAllocator->allocate(allocationSize);
+			const size_t alignment = alignof(Slot) > alignof(Block) ? alignof(Slot) : alignof(Block);
+			byte* start = allocation + (alignment - (size_t)allocation % alignment) % alignment;
+
+			Block* block = new (start) Block();
+			block->m_slots = reinterpret_cast<Slot*>(start + slotOffset);
+			block->m_skipfield = reinterpret_cast<uint16_t*>(start + skipfieldOffset);
+			std::memset(block->m_skipfield, 0, (capacity + 1) * sizeof(uint16_t));
+			block->m_allocation = allocation;
+			block->m_allocationSize = allocationSize;
+			block->m_capacity = capacity;
+			block->m_high = 0;
+			block->m_live = 0;
+			block->m_freeHead = INTERNAL::COLONY_NO_INDEX;
+			block->m_hasFreeRuns = false;
+			block->m_nextWithFree = nullptr;
+			block->m_prevWithFree = nullptr;
+			block->m_next = nullptr;
+			block->m_prev = m_last;
+
+			if (m_last != nullptr)
+			{
+				m_last->m_next = block;
+			}
+			else
+			{
+				m_first = block;
+			}
+			m_last = block;
+		}
+
+		void freeBlock(Block* block)
+		{
+			unlinkFromFree(block);
+
+			if (block->m_prev != nullptr)
+			{
+				block->m_prev->m_next = block->m_next;
+			}
+			else
+			{
+				m_first = block->m_next;
+			}
+			if (block->m_next != nullptr)
+			{
+				block->m_next->m_prev = block->m_prev;
+			}
+			else
+			{
+				m_last = block->m_prev;
+			}
+
+			m_parentAllocator->deallocate(block->m_allocation, block->m_allocationSize);
+		}
+
+		void linkToFree(Block* block)
+		{
+			if (block->m_hasFreeRuns)
+			{
+				return;
+			}
+			block->m_hasFreeRuns = true;
+			block->m_prevWithFree = nullptr;
+			block->m_nextWithFree = m_firstWithFree;
+			if (m_firstWithFree != nullptr)
+			{
+				m_firstWithFree->m_prevWithFree = block;
+			}
+			m_firstWithFree = block;
+		}
+
+		void unlinkFromFree(Block* block)
+		{
+			if (!block->m_hasFreeRuns)
+			{
+				return;
+			}
+			block->m_hasFreeRuns = false;
+			if (block->m_prevWithFree != nullptr)
+			{
+				block->m_prevWithFree->m_nextWithFree = block->m_nextWithFree;
+			}
+			else
+			{
+				m_firstWithFree = block->m_nextWithFree;
+			}
+			if (block->m_nextWithFree != nullptr)
+			{
+				block->m_nextWithFree->m_prevWithFree = block->m_prevWithFree;
+			}
+		}
+
+		//The runs of erased slots of a block form a doubly linked list through their first slots
+		static void pushRun(Block* block, size_t index)
+		{
+			Slot& slot = block->m_slots[index];
+			slot.m_free.m_prev = INTERNAL::COLONY_NO_INDEX;
+			slot.m_free.m_next = block->m_freeHead;
+			if (block->m_freeHead != INTERNAL::COLONY_NO_INDEX)
+			{
+				block->m_slots[block->m_freeHead].m_free.m_prev = (uint16_t)index;
+			}
+			block->m_freeHead = (uint16_t)index;
+		}
+
+		static void removeRun(Block* block, size_t index)
+		{
+			Slot& slot = block->m_slots[index];
+			if (slot.m_free.m_prev != INTERNAL::COLONY_NO_INDEX)
+			{
+				block->m_slots[slot.m_free.m_prev].m_free.m_next = slot.m_free.m_next;
+			}
+			else
+			{
+				block->m_freeHead = slot.m_free.m_next;
+			}
+			if (slot.m_free.m_next != INTERNAL::COLONY_NO_INDEX)
+			{
+				block->m_slots[slot.m_free.m_next].m_free.m_prev = slot.m_free.m_prev;
+			}
+		}
+
+		//The run starting at oldIndex starts at newIndex from now on
+		static void moveRun(Block* block, size_t oldIndex, size_t newIndex)
+		{
+			Slot& slot = block->m_slots[newIndex];
+			slot.m_free = block->m_slots[oldIndex].m_free;
+			if (slot.m_free.m_prev != INTERNAL::COLONY_NO_INDEX)
+			{
+				block->m_slots[slot.m_free.m_prev].m_free.m_next = (uint16_t)newIndex;
+			}
+			else
+			{
+				block->m_freeHead = (uint16_t)newIndex;
+			}
+			if (slot.m_free.m_next != INTERNAL::COLONY_NO_INDEX)
+			{
+				block->m_slots[slot.m_free.m_next].m_free.m_prev = (uint16_t)newIndex;
+			}
+		}
+
+		//Reuses the first slot of the first erased run of a block with erased slots
+		size_t takeErasedSlot(Block* block)
+		{
+			const size_t index = block->m_freeHead;
+			uint16_t* skipfield = block->m_skipfield;
+			const size_t runLength = skipfield[index];
+
+			if (runLength > 1)
+			{
+				moveRun(block, index, index + 1);
+				skipfield[index + 1] = (uint16_t)(runLength - 1);
+				skipfield[index + runLength - 1] = (uint16_t)(runLength - 1);
+			}
+			else
+			{
+				removeRun(block, index);
+				if (block->m_freeHead == INTERNAL::COLONY_NO_INDEX)
+				{
+					unlinkFromFree(block);
+				}
+			}
+			skipfield[index] = 0;
+			return index;
+		}
+
+		//Updates the skipfield and the runs, returns the length of the erased run right of index
+		size_t markErased(Block* block, size_t index)
+		{
+			uint16_t* skipfield = block->m_skipfield;
+			const size_t left = index > 0 ? skipfield[index - 1] : 0;
+			const size_t right = skipfield[index + 1];
+
+			if (left == 0 && right == 0)
+			{
+				skipfield[index] = 1;
+				pushRun(block, index);
+			}
+			else if (right == 0)
+			{
+				//Extends the run on the left, which keeps its first slot
+				skipfield[index - left] = (uint16_t)(left + 1);
+				skipfield[index] = (uint16_t)(left + 1);
+			}
+			else if (left == 0)
+			{
+				//The run on the right starts one slot earlier now
+				moveRun(block, index + 1, index);
+				skipfield[index] = (uint16_t)(right + 1);
+				skipfield[index + right] = (uint16_t)(right + 1);
+			}
+			else
+			{
+				//Joins both runs into the one on the left
+				removeRun(block, index + 1);
+				skipfield[index - left] = (uint16_t)(left + right + 1);
+				skipfield[index + right] = (uint16_t)(left + right + 1);
+			}
+
+			linkToFree(block);
+			return right;
+		}
+
+		Iterator erase(Block* block, size_t index)
+		{
+			block->m_slots[index].value.~T();
+			block->m_live--;
+			m_length--;
+
+			if (block->m_live == 0)
+			{
+				Block* next = block->m_next;
+				freeBlock(block);
+				return Iterator(next, 0);
+			}
+
+			const size_t right = markErased(block, index);
+			return Iterator(block, index + right + 1);
+		}
+
+	public:
+		explicit Colony(Allocator* parentAllocator = nullptr)
+			: m_parentAllocator(parentAllocator)
+		{
+			if (parentAllocator == nullptr)
+			{
+				m_parentAllocator = new Allocator();
+				m_needsToDeleteParentAllocator = true;
+			}
+		}
+
+		Colony(const Colony& other) = delete;
+		Colony(Colony&& other) = delete;
+		Colony& operator=(const Colony& other) = delete;
+		Colony& operator=(Colony&& other) = delete;
+
+		~Colony()
+		{
+			clear();
+
+			if (m_needsToDeleteParentAllocator)
+			{
+				delete m_parentAllocator;
+			}
+		}
+
+		//The address of the element stays valid until it is erased
+		template <typename... arguments>
+		Iterator emplace(arguments&&... args)
+		{
+			Block* block;
+			size_t index;
+
+			if (m_firstWithFree != nullptr)
+			{
+				block = m_firstWithFree;
+				index = takeErasedSlot(block);
+			}
+			else
+			{
+				if (m_last == nullptr || m_last->m_high == m_last->m_capacity)
+				{
+					appendBlock();
+				}
+				block = m_last;
+				index = block->m_high++;
+			}
+
+			new (std::addressof(block->m_slots[index].value)) T(std::forward<arguments>(args)...);
+			block->m_live++;
+			m_length++;
+			return Iterator(block, index);
+		}
+
+		Iterator insert(const T& value)
+		{
+			return emplace(value);
+		}
+
+		Iterator insert(T&& value)
+		{
+			return emplace(std::move(value));
+		}
+
+		//Iterators stay valid until their element is erased, so they can be kept as O(1) handles.
+		//Returns the iterator to the element behind the erased one.
+		Iterator erase(Iterator iterator)
+		{
+			return erase(iterator.m_block, iterator.m_index);
+		}
+
+		//Has to search the block of data, O(amount of blocks)
+		void erase(T* data)
+		{
+			Slot* slot = reinterpret_cast<Slot*>(data);
+			for (Block* block = m_first; block != nullptr; block = block->m_next)
+			{
+				if (slot >= block->m_slots && slot < block->m_slots + block->m_high)
+				{
+					erase(block, slot - block->m_slots);
+					return;
+				}
+			}
+
+			//TODO add further error handling
+			DEBUG_BREAK;
+		}
+
+		void clear()
+		{
+			while (m_first != nullptr)
+			{
+				Block* block = m_first;
+				for (Iterator it(block, 0); it.m_block == block; ++it)
+				{
+					it->~T();
+				}
+				freeBlock(block);
+			}
+			m_length = 0;
+			m_nextCapacity = COLONY_MIN_BLOCK_CAPACITY;
+		}
+
+		//function(T&) for every element, a bit faster than iterating with Iterator
+		template <typename Function>
+		void forEach(Function function)
+		{
+			for (Block* block = m_first; block != nullptr; block = block->m_next)
+			{
+				Slot* slots = block->m_slots;
+				const uint16_t* skipfield = block->m_skipfield;
+				const size_t high = block->m_high;
+
+				for (size_t i = skipfield[0]; i < high; i++, i += skipfield[i])
+				{
+					function(slots[i].value);
+				}
+			}
+		}
+
+		Iterator begin()
+		{
+			return Iterator(m_first, 0);
+		}
+
+		Iterator end()
+		{
+			return Iterator(nullptr, 0);
+		}
+
+		size_t getLength() const
+		{
+			return m_length;
+		}
+
+		bool isEmpty() const
+		{
+			return m_length == 0;
+		}
+
+		size_t getBlockCount() const
+		{
+			size_t count = 0;
+			for (Block* block = m_first; block != nullptr; block = block->m_next)
+			{
+				count++;
+			}
+			return count;
+		}
+	};
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "main.h"
+#include "List.h"
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		static const uint32_t DARY_HEAP_NOT_QUEUED = 0xFFFFFFFF;
+
+		template <typename T>
+		struct DaryHeapEntry
+		{
+			T value;
+			uint32_t handle;
+		};
+	}
+
+	//Index of an element pushed into a DaryHeap. It stays valid until the element is popped or removed, after
+	//that the heap hands it out again for new elements.
+	typedef uint32_t HeapHandle;
+
+	//Priority queue as an implicit d-ary heap in a List. Unlike std::priority_queue the top is the smallest
+	//element by Compare, and elements can be moved with decreaseKey or update through the handle returned by push.
+	//An arity of 4 keeps the heap half as deep as a binary one while all children of a node share a cache line.
+	template <typename T, typename Compare = std::less<T>, size_t Arity = 4>
+	class DaryHeap
+	{
+	private:
+		static_assert(Arity >= 2, "A heap needs at least two children per node!");
+
+		typedef INTERNAL::DaryHeapEntry<T> Entry;
+
+		List<Entry> m_heap;
+		List<uint32_t> m_positions; //Heap position of every handle
+		List<HeapHandle> m_freeHandles;
+		Compare m_compare;
+
+		void place(size_t position, Entry&& entry)
+		{
+			m_positions[entry.handle] = (uint32_t)position;
+			m_heap[position] = std::move(entry);
+		}
+
+		//The entry is taken out of position, and the hole moves up until the entry fits in
+		void siftUp(size_t position)
+		{
+			Entry entry = std::move(m_heap[position]);
+			while (position > 0)
+			{
+				size_t parent = (position - 1) / Arity;
+				if (!m_compare(entry.value, m_heap[parent].value))
+				{
+					break;
+				}
+				place(position, std::move(m_heap[parent]));
+				position = parent;
+			}
+			place(position, std::move(entry));
+		}
+
+		void siftDown(size_t position)
+		{
+			const size_t length = m_heap.getLength();
+			Entry entry = std::move(m_heap[position]);
+			while (true)
+			{
+				size_t firstChild = position * Arity + 1;
+				if (firstChild >= length)
+				{
+					break;
+				}
+
+				size_t lastChild = firstChild + Arity < length ? firstChild + Arity : length;
+				size_t smallest = firstChild;
+				for (size_t child = firstChild + 1; child < lastChild; child++)
+				{
+					if (m_compare(m_heap[child].value, m_heap[smallest].value))
+					{
+						smallest = child;
+					}
+				}
+
+				if (!m_compare(m_heap[smallest].value, entry.value))
+				{
+					break;
+				}
+				place(position, std::move(m_heap[smallest]));
+				position = smallest;
+			}
+			place(position, std::move(entry));
+		}
+
+		//Moves the entry at position up or down, whichever restores the heap
+		void restore(size_t position)
+		{
+			if (position > 0 && m_compare(m_heap[position].value, m_heap[(position - 1) / Arity].value))
+			{
+				siftUp(position);
+			}
+			else
+			{
+				siftDown(position);
+			}
+		}
+
+		//Fills the hole at position with the last entry. The value at position may already be moved out.
+		void removeAt(size_t position)
+		{
+			m_positions[m_heap[position].handle] = INTERNAL::DARY_HEAP_NOT_QUEUED;
+			m_freeHandles.pushBack(m_heap[position].handle);
+
+			const size_t last = m_heap.getLength() - 1;
+			if (position != last)
+			{
+				place(position, std::move(m_heap[last]));
+				m_heap.popBack();
+				restore(position);
+			}
+			else
+			{
+				m_heap.popBack();
+			}
+		}
+
+		size_t getPosition(HeapHandle handle) const
+		{
+			if (!contains(handle))
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+			}
+			return m_positions[handle];
+		}
+
+	public:
+		explicit DaryHeap(const Compare& compare = Compare())
+			: m_compare(compare)
+		{
+		}
+
+		DaryHeap(const DaryHeap& other) = delete;
+		DaryHeap(DaryHeap&& other) = delete;
+		DaryHeap& operator=(const DaryHeap& other) = delete;
+		DaryHeap& operator=(DaryHeap&& other) = delete;
+
+		HeapHandle push(const T& value)
+		{
+			return push(T(value));
+		}
+
+		HeapHandle push(T&& value)
+		{
+			HeapHandle handle;
+			if (!m_freeHandles.isEmpty())
+			{
+				handle = m_freeHandles.last();
+				m_freeHandles.popBack();
+			}
+			else
+			{
+				handle = (HeapHandle)m_positions.getLength();
+				m_positions.pushBack(INTERNAL::DARY_HEAP_NOT_QUEUED);
+			}
+
+			m_heap.pushBack(Entry{ std::move(value), handle });
+			siftUp(m_heap.getLength() - 1);
+			return handle;
+		}
+
+		const T& top() const
+		{
+			if (isEmpty())
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+			}
+			return m_heap[0].value;
+		}
+
+		HeapHandle topHandle() const
+		{
+			if (isEmpty())
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+			}
+			return m_heap[0].handle;
+		}
+
+		T pop()
+		{
+			T value = std::move(m_heap.first().value);
+			removeAt(0);
+			return value;
+		}
+
+		bool contains(HeapHandle handle) const
+		{
+			return handle < m_positions.getLength() && m_positions[handle] != INTERNAL::DARY_HEAP_NOT_QUEUED;
+		}
+
+		const T& get(HeapHandle handle) const
+		{
+			return m_heap[getPosition(handle)].value;
+		}
+
+		//value must not be greater than the current one, which makes it cheaper than update
+		void decreaseKey(HeapHandle handle, const T& value)
+		{
+			const size_t position = getPosition(handle);
+			if (m_compare(m_heap[position].value, value))
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+				return;
+			}
+			m_heap[position].value = value;
+			siftUp(position);
+		}
+
+		void update(HeapHandle handle, const T& value)
+		{
+			const size_t position = getPosition(handle);
+			m_heap[position].value = value;
+			restore(position);
+		}
+
+		T remove(HeapHandle handle)
+		{
+			const size_t position = getPosition(handle);
+			T value = std::move(m_heap[position].value);
+			removeAt(position);
+			return value;
+		}
+
+		void clear()
+		{
+			for (size_t i = 0; i < m_heap.getLength(); i++)
+			{
+				m_positions[m_heap[i].handle] = INTERNAL::DARY_HEAP_NOT_QUEUED;
+				m_freeHandles.pushBack(m_heap[i].handle);
+			}
+			m_heap.clear();
+		}
+
+		void reserve(size_t amount)
+		{
+			m_heap.resizeCapacity(amount);
+			m_positions.resizeCapacity(amount);
+		}
+
+		size_t getLength() const
+		{
+			return m_heap.getLength();
+		}
+
+		bool isEmpty() const
+		{
+			return m_heap.getLength() == 0;
+		}
+	};
+}
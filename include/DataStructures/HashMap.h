@@ -0,0 +1,434 @@
+#pragma once
+
+#include "main.h"
+#include "Util/DataTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BBE_HASH_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		//Control byte of a slot. Full slots store the lower 7 bits of the hash, so the high bit tells
+		//empty and deleted slots apart from full ones.
+		static const int8_t HASH_MAP_EMPTY = (int8_t)0x80;
+		static const int8_t HASH_MAP_DELETED = (int8_t)0xFE;
+		static const size_t HASH_MAP_GROUP_SIZE = 16;
+
+		inline uint32_t countTrailingZeros(uint32_t value)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, value);
+			return index;
+#else
+			return __builtin_ctz(value);
+#endif
+		}
+
+		//The 16 control bytes of a group, compared all at once. Every bit of a returned mask is one slot.
+		class HashMapGroup
+		{
+		private:
+#ifdef BBE_HASH_MAP_SSE2
+			__m128i m_ctrl;
+#else
+			int8_t m_ctrl[HASH_MAP_GROUP_SIZE];
+#endif
+
+		public:
+			explicit HashMapGroup(const int8_t *ctrl)
+			{
+#ifdef BBE_HASH_MAP_SSE2
+				m_ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+				std::memcpy(m_ctrl, ctrl, HASH_MAP_GROUP_SIZE);
+#endif
+			}
+
+			uint32_t match(int8_t value) const
+			{
+#ifdef BBE_HASH_MAP_SSE2
+				return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(value)));
+#else
+				uint32_t mask = 0;
+				for (size_t i = 0; i < HASH_MAP_GROUP_SIZE; i++)
+				{
+					mask |= (uint32_t)(m_ctrl[i] == value) << i;
+				}
+				return mask;
+#endif
+			}
+
+			uint32_t matchEmpty() const
+			{
+				return match(HASH_MAP_EMPTY);
+			}
+
+			uint32_t matchEmptyOrDeleted() const
+			{
+#ifdef BBE_HASH_MAP_SSE2
+				return (uint32_t)_mm_movemask_epi8(m_ctrl);
+#else
+				uint32_t mask = 0;
+				for (size_t i = 0; i < HASH_MAP_GROUP_SIZE; i++)
+				{
+					mask |= (uint32_t)(m_ctrl[i] < 0) << i;
+				}
+				return mask;
+#endif
+			}
+		};
+
+		template <typename Key, typename Value>
+		union HashMapSlot
+		{
+			std::pair<const Key, Value> value;
+
+			HashMapSlot() {}
+			~HashMapSlot() {}
+		};
+	}
+
+	//Open addressing hash map with SwissTable style control bytes. Slots are probed a group of 16 at a time:
+	//one SIMD compare finds all slots of the group whose 7 bit hash fragment matches, so keys are only compared
+	//for likely hits. The control bytes and slots are one block from the byte allocator.
+	template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Allocator = std::allocator<byte>>
+	class HashMap
+	{
+	private:
+		typedef INTERNAL::HashMapSlot<Key, Value> Slot;
+		static_assert(alignof(Slot) <= alignof(std::max_align_t), "HashMap does not support over aligned keys or values!");
+
+		//Grows at 7/8 of the capacity, counting deleted slots as well
+		static size_t getMaxLoad(size_t capacity)
+		{
+			return capacity - capacity / 8;
+		}
+
+		int8_t* m_ctrl = nullptr;
+		Slot* m_slots = nullptr;
+		size_t m_capacity = 0; //Multiple of HASH_MAP_GROUP_SIZE and power of two
+		size_t m_length = 0;
+		size_t m_deleted = 0;
+		size_t m_allocationSize = 0;
+		byte* m_allocation = nullptr;
+
+		Hash m_hash;
+		Allocator* m_parentAllocator = nullptr;
+		bool m_needsToDeleteParentAllocator = false;
+
+		size_t hashOf(const Key &key) const
+		{
+			//std::hash is the identity for integers, mix it so h1 and h2 both depend on every bit
+			uint64_t hash = (uint64_t)m_hash(key) * 0x9E3779B97F4A7C15ull;
+			return (size_t)(hash ^ (hash >> 32));
+		}
+
+		static int8_t h2(size_t hash)
+		{
+			return (int8_t)(hash & 0x7F);
+		}
+
+		size_t getGroupMask() const
+		{
+			return m_capacity / INTERNAL::HASH_MAP_GROUP_SIZE - 1;
+		}
+
+		void allocateSlots(size_t capacity)
+		{
+			const size_t slotOffset = (capacity + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+			m_capacity = capacity;
+			m_allocationSize = slotOffset + capacity * sizeof(Slot) + INTERNAL::HASH_MAP_GROUP_SIZE;
+			m_allocation = m_parentAllocator->allocate(m_allocationSize);
+
+			//The groups are loaded with aligned loads
+			byte* ctrl = m_allocation + (INTERNAL::HASH_MAP_GROUP_SIZE - (size_t)m_allocation % INTERNAL::HASH_MAP_GROUP_SIZE) % INTERNAL::HASH_MAP_GROUP_SIZE;
+			m_ctrl = reinterpret_cast<int8_t*>(ctrl);
+			m_slots = reinterpret_cast<Slot*>(ctrl + slotOffset);
+			std::memset(m_ctrl, (byte)INTERNAL::HASH_MAP_EMPTY, capacity);
+			m_deleted = 0;
+		}
+
+		void freeSlots()
+		{
+			if (m_allocation != nullptr)
+			{
+				m_parentAllocator->deallocate(m_allocation, m_allocationSize);
+			}
+			m_allocation = nullptr;
+			m_ctrl = nullptr;
+			m_slots = nullptr;
+			m_capacity = 0;
+		}
+
+		void destroyAll()
+		{
+			for (size_t i = 0; i < m_capacity; i++)
+			{
+				if (m_ctrl[i] >= 0)
+				{
+					m_slots[i].value.~pair();
+				}
+			}
+		}
+
+		//Index of the first empty or deleted slot along the probe sequence of hash
+		size_t findFreeSlot(size_t hash) const
+		{
+			size_t group = (hash >> 7) & getGroupMask();
+			for (size_t step = 1;; step++)
+			{
+				uint32_t mask = INTERNAL::HashMapGroup(m_ctrl + group * INTERNAL::HASH_MAP_GROUP_SIZE).matchEmptyOrDeleted();
+				if (mask != 0)
+				{
+					return group * INTERNAL::HASH_MAP_GROUP_SIZE + INTERNAL::countTrailingZeros(mask);
+				}
+				group = (group + step) & getGroupMask(); //Triangular numbers visit every group
+			}
+		}
+
+		size_t find(const Key &key, size_t hash) const
+		{
+			if (m_capacity == 0)
+			{
+				return m_capacity;
+			}
+
+			size_t group = (hash >> 7) & getGroupMask();
+			for (size_t step = 1; step <= m_capacity / INTERNAL::HASH_MAP_GROUP_SIZE; step++)
+			{
+				INTERNAL::HashMapGroup ctrl(m_ctrl + group * INTERNAL::HASH_MAP_GROUP_SIZE);
+				for (uint32_t mask = ctrl.match(h2(hash)); mask != 0; mask &= mask - 1)
+				{
+					size_t index = group * INTERNAL::HASH_MAP_GROUP_SIZE + INTERNAL::countTrailingZeros(mask);
+					if (m_slots[index].value.first == key)
+					{
+						return index;
+					}
+				}
+
+				//An empty slot ends every probe sequence which reached this group
+				if (ctrl.matchEmpty() != 0)
+				{
+					return m_capacity;
+				}
+				group = (group + step) & getGroupMask();
+			}
+			return m_capacity;
+		}
+
+		void rehash(size_t newCapacity)
+		{
+			int8_t* oldCtrl = m_ctrl;
+			Slot* oldSlots = m_slots;
+			size_t oldCapacity = m_capacity;
+			size_t oldAllocationSize = m_allocationSize;
+			byte* oldAllocation = m_allocation;
+
+			allocateSlots(newCapacity);
+
+			for (size_t i = 0; i < oldCapacity; i++)
+			{
+				if (oldCtrl[i] >= 0)
+				{
+					size_t hash = hashOf(oldSlots[i].value.first);
+					size_t index = findFreeSlot(hash);
+					m_ctrl[index] = h2(hash);
+					new (std::addressof(m_slots[index].value)) std::pair<const Key, Value>(std::move(const_cast<Key&>(oldSlots[i].value.first)), std::move(oldSlots[i].value.second));
+					oldSlots[i].value.~pair();
+				}
+			}
+
+			if (oldAllocation != nullptr)
+			{
+				m_parentAllocator->deallocate(oldAllocation, oldAllocationSize);
+			}
+		}
+
+		void growIfNeeded()
+		{
+			if (m_capacity == 0)
+			{
+				rehash(INTERNAL::HASH_MAP_GROUP_SIZE);
+			}
+			else if (m_length + m_deleted + 1 > getMaxLoad(m_capacity))
+			{
+				//Mostly tombstones: rehashing at the same size is enough to get rid of them
+				rehash(m_length + 1 > getMaxLoad(m_capacity) / 2 ? m_capacity * 2 : m_capacity);
+			}
+		}
+
+		template <typename... arguments>
+		std::pair<Value*, bool> emplace(const Key &key, arguments&&... args)
+		{
+			size_t hash = hashOf(key);
+			size_t index = find(key, hash);
+			if (index != m_capacity)
+			{
+				return std::make_pair(&m_slots[index].value.second, false);
+			}
+
+			growIfNeeded();
+			index = findFreeSlot(hash);
+			if (m_ctrl[index] == INTERNAL::HASH_MAP_DELETED)
+			{
+				m_deleted--;
+			}
+			m_ctrl[index] = h2(hash);
+			new (std::addressof(m_slots[index].value)) std::pair<const Key, Value>(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<arguments>(args)...));
+			m_length++;
+			return std::make_pair(&m_slots[index].value.second, true);
+		}
+
+	public:
+		explicit HashMap(Allocator* parentAllocator = nullptr)
+			: m_parentAllocator(parentAllocator)
+		{
+			if (parentAllocator == nullptr)
+			{
+				m_parentAllocator = new Allocator();
+				m_needsToDeleteParentAllocator = true;
+			}
+		}
+
+		HashMap(const HashMap& other) = delete;
+		HashMap(HashMap&& other) = delete;
+		HashMap& operator=(const HashMap& other) = delete;
+		HashMap& operator=(HashMap&& other) = delete;
+
+		~HashMap()
+		{
+			destroyAll();
+			freeSlots();
+
+			if (m_needsToDeleteParentAllocator)
+			{
+				delete m_parentAllocator;
+			}
+		}
+
+		//Returns false and leaves the map unchanged, if key is already in the map
+		bool add(const Key &key, const Value &value)
+		{
+			return emplace(key, value).second;
+		}
+
+		bool add(const Key &key, Value &&value)
+		{
+			return emplace(key, std::move(value)).second;
+		}
+
+		//Default constructs the value, if key is not in the map yet
+		Value& operator[](const Key &key)
+		{
+			return *emplace(key).first;
+		}
+
+		Value* get(const Key &key)
+		{
+			size_t index = find(key, hashOf(key));
+			return index == m_capacity ? nullptr : &m_slots[index].value.second;
+		}
+
+		const Value* get(const Key &key) const
+		{
+			size_t index = find(key, hashOf(key));
+			return index == m_capacity ? nullptr : &m_slots[index].value.second;
+		}
+
+		bool contains(const Key &key) const
+		{
+			return find(key, hashOf(key)) != m_capacity;
+		}
+
+		bool remove(const Key &key)
+		{
+			size_t index = find(key, hashOf(key));
+			if (index == m_capacity)
+			{
+				return false;
+			}
+
+			m_slots[index].value.~pair();
+			m_length--;
+
+			//If the group still has an empty slot, no probe sequence went past it, so the slot can become empty again
+			size_t group = index / INTERNAL::HASH_MAP_GROUP_SIZE * INTERNAL::HASH_MAP_GROUP_SIZE;
+			if (INTERNAL::HashMapGroup(m_ctrl + group).matchEmpty() != 0)
+			{
+				m_ctrl[index] = INTERNAL::HASH_MAP_EMPTY;
+			}
+			else
+			{
+				m_ctrl[index] = INTERNAL::HASH_MAP_DELETED;
+				m_deleted++;
+			}
+			return true;
+		}
+
+		//Makes room for amount entries without growing in between
+		void reserve(size_t amount)
+		{
+			size_t capacity = INTERNAL::HASH_MAP_GROUP_SIZE;
+			while (getMaxLoad(capacity) < amount)
+			{
+				capacity *= 2;
+			}
+			if (capacity > m_capacity)
+			{
+				rehash(capacity);
+			}
+		}
+
+		void clear()
+		{
+			destroyAll();
+			if (m_capacity > 0)
+			{
+				std::memset(m_ctrl, (byte)INTERNAL::HASH_MAP_EMPTY, m_capacity);
+			}
+			m_length = 0;
+			m_deleted = 0;
+		}
+
+		//function(const Key&, Value&) for every entry, in no particular order
+		template <typename Function>
+		void forEach(Function function)
+		{
+			for (size_t group = 0; group < m_capacity; group += INTERNAL::HASH_MAP_GROUP_SIZE)
+			{
+				uint32_t full = ~INTERNAL::HashMapGroup(m_ctrl + group).matchEmptyOrDeleted() & 0xFFFF;
+				for (; full != 0; full &= full - 1)
+				{
+					std::pair<const Key, Value> &entry = m_slots[group + INTERNAL::countTrailingZeros(full)].value;
+					function(entry.first, entry.second);
+				}
+			}
+		}
+
+		size_t getLength() const
+		{
+			return m_length;
+		}
+
+		size_t getCapacity() const
+		{
+			return m_capacity;
+		}
+	};
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "main.h"
+#include <cstddef>
+
+namespace bbe
+{
+	//Hook of an IntrusiveList. Objects derive from one node per list they can be linked into, the Tag tells the
+	//nodes apart: struct Enemy : IntrusiveListNode<AliveTag>, IntrusiveListNode<DirtyTag>.
+	template <typename Tag = void>
+	class IntrusiveListNode
+	{
+		template <typename T, typename ListTag>
+		friend class IntrusiveList;
+
+	private:
+		IntrusiveListNode* m_prev = nullptr;
+		IntrusiveListNode* m_next = nullptr;
+
+	public:
+		IntrusiveListNode() = default;
+
+		//A copy is a different object, which is not linked anywhere
+		IntrusiveListNode(const IntrusiveListNode&)
+		{
+		}
+
+		IntrusiveListNode& operator=(const IntrusiveListNode&)
+		{
+			return *this;
+		}
+
+		~IntrusiveListNode()
+		{
+			if (isLinked())
+			{
+				//Destroying a linked object leaves the list with a dangling pointer
+				DEBUG_BREAK;
+			}
+		}
+
+		bool isLinked() const
+		{
+			return m_next != nullptr;
+		}
+	};
+
+	//Doubly linked list of objects which embed their own links, so linking and unlinking never allocates and an
+	//object can be removed in O(1) without searching for it. The list does not own the objects: they have to be
+	//removed before they are destroyed.
+	template <typename T, typename Tag = void>
+	class IntrusiveList
+	{
+	public:
+		typedef IntrusiveListNode<Tag> Node;
+
+		class Iterator
+		{
+			friend class IntrusiveList;
+
+		private:
+			Node* m_node;
+
+			explicit Iterator(Node* node)
+				: m_node(node)
+			{
+			}
+
+		public:
+			T& operator*() const
+			{
+				return toObject(m_node);
+			}
+
+			T* operator->() const
+			{
+				return &toObject(m_node);
+			}
+
+			Iterator& operator++()
+			{
+				m_node = m_node->m_next;
+				return *this;
+			}
+
+			Iterator& operator--()
+			{
+				m_node = m_node->m_prev;
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const
+			{
+				return m_node == other.m_node;
+			}
+
+			bool operator!=(const Iterator& other) const
+			{
+				return m_node != other.m_node;
+			}
+		};
+
+	private:
+		//Circular: the sentinel is before the first and after the last object
+		Node m_sentinel;
+		size_t m_length = 0;
+
+		static T& toObject(Node* node)
+		{
+			return static_cast<T&>(*node);
+		}
+
+		static void link(Node* node, Node* prev, Node* next)
+		{
+			node->m_prev = prev;
+			node->m_next = next;
+			prev->m_next = node;
+			next->m_prev = node;
+		}
+
+		bool linkIfUnlinked(Node* node, Node* prev, Node* next)
+		{
+			if (node->isLinked())
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+				return false;
+			}
+			link(node, prev, next);
+			m_length++;
+			return true;
+		}
+
+	public:
+		IntrusiveList()
+		{
+			m_sentinel.m_prev = &m_sentinel;
+			m_sentinel.m_next = &m_sentinel;
+		}
+
+		IntrusiveList(const IntrusiveList& other) = delete;
+		IntrusiveList(IntrusiveList&& other) = delete;
+		IntrusiveList& operator=(const IntrusiveList& other) = delete;
+		IntrusiveList& operator=(IntrusiveList&& other) = delete;
+
+		~IntrusiveList()
+		{
+			clear();
+			m_sentinel.m_prev = nullptr;
+			m_sentinel.m_next = nullptr;
+		}
+
+		//Returns false if the object is already linked into a list with the same Tag
+		bool pushBack(T& object)
+		{
+			return linkIfUnlinked(static_cast<Node*>(&object), m_sentinel.m_prev, &m_sentinel);
+		}
+
+		bool pushFront(T& object)
+		{
+			return linkIfUnlinked(static_cast<Node*>(&object), &m_sentinel, m_sentinel.m_next);
+		}
+
+		//position has to be linked into this list
+		bool insertBefore(T& position, T& object)
+		{
+			Node* next = static_cast<Node*>(&position);
+			return linkIfUnlinked(static_cast<Node*>(&object), next->m_prev, next);
+		}
+
+		bool insertAfter(T& position, T& object)
+		{
+			Node* prev = static_cast<Node*>(&position);
+			return linkIfUnlinked(static_cast<Node*>(&object), prev, prev->m_next);
+		}
+
+		//object has to be linked into this list
+		void remove(T& object)
+		{
+			Node* node = static_cast<Node*>(&object);
+			if (!node->isLinked())
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+				return;
+			}
+
+			node->m_prev->m_next = node->m_next;
+			node->m_next->m_prev = node->m_prev;
+			node->m_prev = nullptr;
+			node->m_next = nullptr;
+			m_length--;
+		}
+
+		T* popFront()
+		{
+			T* object = first();
+			if (object != nullptr)
+			{
+				remove(*object);
+			}
+			return object;
+		}
+
+		T* popBack()
+		{
+			T* object = last();
+			if (object != nullptr)
+			{
+				remove(*object);
+			}
+			return object;
+		}
+
+		void clear()
+		{
+			while (m_sentinel.m_next != &m_sentinel)
+			{
+				remove(toObject(m_sentinel.m_next));
+			}
+		}
+
+		//nullptr if the list is empty
+		T* first()
+		{
+			return isEmpty() ? nullptr : &toObject(m_sentinel.m_next);
+		}
+
+		T* last()
+		{
+			return isEmpty() ? nullptr : &toObject(m_sentinel.m_prev);
+		}
+
+		//nullptr at the end of the list
+		T* next(T& object)
+		{
+			Node* next = static_cast<Node*>(&object)->m_next;
+			return next == &m_sentinel ? nullptr : &toObject(next);
+		}
+
+		T* prev(T& object)
+		{
+			Node* prev = static_cast<Node*>(&object)->m_prev;
+			return prev == &m_sentinel ? nullptr : &toObject(prev);
+		}
+
+		Iterator begin()
+		{
+			return Iterator(m_sentinel.m_next);
+		}
+
+		Iterator end()
+		{
+			return Iterator(&m_sentinel);
+		}
+
+		size_t getLength() const
+		{
+			return m_length;
+		}
+
+		bool isEmpty() const
+		{
+			return m_length == 0;
+		}
+	};
+}
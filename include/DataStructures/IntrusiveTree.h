@@ -0,0 +1,610 @@
+#pragma once
+
+#include "main.h"
+#include <cstddef>
+#include <functional>
+
+namespace bbe
+{
+	//Hook of an IntrusiveTree, see IntrusiveListNode for how several hooks live in one object
+	template <typename Tag = void>
+	class IntrusiveTreeNode
+	{
+		template <typename T, typename Compare, typename TreeTag>
+		friend class IntrusiveTree;
+
+	private:
+		IntrusiveTreeNode* m_parent = nullptr;
+		IntrusiveTreeNode* m_left = nullptr;
+		IntrusiveTreeNode* m_right = nullptr;
+		bool m_red = false;
+		bool m_linked = false;
+
+	public:
+		IntrusiveTreeNode() = default;
+
+		//A copy is a different object, which is not linked anywhere
+		IntrusiveTreeNode(const IntrusiveTreeNode&)
+		{
+		}
+
+		IntrusiveTreeNode& operator=(const IntrusiveTreeNode&)
+		{
+			return *this;
+		}
+
+		~IntrusiveTreeNode()
+		{
+			if (m_linked)
+			{
+				//Destroying a linked object leaves the tree with a dangling pointer
+				DEBUG_BREAK;
+			}
+		}
+
+		bool isLinked() const
+		{
+			return m_linked;
+		}
+	};
+
+	//Red-black tree of objects which embed their own links, ordered by Compare. Like std::set it holds no two
+	//equal objects, but inserting and removing never allocates. The tree does not own the objects: they have to
+	//be removed before they are destroyed, and must not change their key while they are linked.
+	template <typename T, typename Compare = std::less<T>, typename Tag = void>
+	class IntrusiveTree
+	{
+	public:
+		typedef IntrusiveTreeNode<Tag> Node;
+
+		class Iterator
+		{
+			friend class IntrusiveTree;
+
+		private:
+			Node* m_node;
+
+			explicit Iterator(Node* node)
+				: m_node(node)
+			{
+			}
+
+		public:
+			T& operator*() const
+			{
+				return toObject(m_node);
+			}
+
+			T* operator->() const
+			{
+				return &toObject(m_node);
+			}
+
+			Iterator& operator++()
+			{
+				m_node = successor(m_node);
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const
+			{
+				return m_node == other.m_node;
+			}
+
+			bool operator!=(const Iterator& other) const
+			{
+				return m_node != other.m_node;
+			}
+		};
+
+	private:
+		Node* m_root = nullptr;
+		size_t m_length = 0;
+		Compare m_compare;
+
+		static T& toObject(Node* node)
+		{
+			return static_cast<T&>(*node);
+		}
+
+		static bool isRed(const Node* node)
+		{
+			return node != nullptr && node->m_red;
+		}
+
+		static Node* minimum(Node* node)
+		{
+			while (node->m_left != nullptr)
+			{
+				node = node->m_left;
+			}
+			return node;
+		}
+
+		static Node* maximum(Node* node)
+		{
+			while (node->m_right != nullptr)
+			{
+				node = node->m_right;
+			}
+			return node;
+		}
+
+		static Node* successor(Node* node)
+		{
+			if (node->m_right != nullptr)
+			{
+				return minimum(node->m_right);
+			}
+			while (node->m_parent != nullptr && node == node->m_parent->m_right)
+			{
+				node = node->m_parent;
+			}
+			return node->m_parent;
+		}
+
+		static Node* predecessor(Node* node)
+		{
+			if (node->m_left != nullptr)
+			{
+				return maximum(node->m_left);
+			}
+			while (node->m_parent != nullptr && node == node->m_parent->m_left)
+			{
+				node = node->m_parent;
+			}
+			return node->m_parent;
+		}
+
+		//Puts replacement where node was in the parent of node
+		void replaceChild(Node* node, Node* replacement)
+		{
+			if (node->m_parent == nullptr)
+			{
+				m_root = replacement;
+			}
+			else if (node == node->m_parent->m_left)
+			{
+				node->m_parent->m_left = replacement;
+			}
+			else
+			{
+				node->m_parent->m_right = replacement;
+			}
+
+			if (replacement != nullptr)
+			{
+				replacement->m_parent = node->m_parent;
+			}
+		}
+
+		void rotateLeft(Node* node)
+		{
+			Node* right = node->m_right;
+			node->m_right = right->m_left;
+			if (right->m_left != nullptr)
+			{
+				right->m_left->m_parent = node;
+			}
+			replaceChild(node, right);
+			right->m_left = node;
+			node->m_parent = right;
+		}
+
+		void rotateRight(Node* node)
+		{
+			Node* left = node->m_left;
+			node->m_left = left->m_right;
+			if (left->m_right != nullptr)
+			{
+				left->m_right->m_parent = node;
+			}
+			replaceChild(node, left);
+			left->m_right = node;
+			node->m_parent = left;
+		}
+
+		void fixAfterInsert(Node* node)
+		{
+			while (isRed(node->m_parent))
+			{
+				//A red parent is never the root, so the grandparent exists
+				Node* parent = node->m_parent;
+				Node* grandparent = parent->m_parent;
+
+				if (parent == grandparent->m_left)
+				{
+					Node* uncle = grandparent->m_right;
+					if (isRed(uncle))
+					{
+						parent->m_red = false;
+						uncle->m_red = false;
+						grandparent->m_red = true;
+						node = grandparent;
+						continue;
+					}
+					if (node == parent->m_right)
+					{
+						rotateLeft(parent);
+						node = parent;
+						parent = node->m_parent;
+					}
+					parent->m_red = false;
+					grandparent->m_red = true;
+					rotateRight(grandparent);
+				}
+				else
+				{
+					Node* uncle = grandparent->m_left;
+					if (isRed(uncle))
+					{
+						parent->m_red = false;
+						uncle->m_red = false;
+						grandparent->m_red = true;
+						node = grandparent;
+						continue;
+					}
+					if (node == parent->m_left)
+					{
+						rotateRight(parent);
+						node = parent;
+						parent = node->m_parent;
+					}
+					parent->m_red = false;
+					grandparent->m_red = true;
+					rotateLeft(grandparent);
+				}
+			}
+			m_root->m_red = false;
+		}
+
+		//node took the place of a removed black node and is short of one black, node may be nullptr
+		void fixAfterRemove(Node* node, Node* parent)
+		{
+			while (node != m_root && !isRed(node))
+			{
+				if (node == parent->m_left)
+				{
+					Node* sibling = parent->m_right;
+					if (isRed(sibling))
+					{
+						sibling->m_red = false;
+						parent->m_red = true;
+						rotateLeft(parent);
+						sibling = parent->m_right;
+					}
+					if (!isRed(sibling->m_left) && !isRed(sibling->m_right))
+					{
+						sibling->m_red = true;
+						node = parent;
+						parent = node->m_parent;
+						continue;
+					}
+					if (!isRed(sibling->m_right))
+					{
+						sibling->m_left->m_red = false;
+						sibling->m_red = true;
+						rotateRight(sibling);
+						sibling = parent->m_right;
+					}
+					sibling->m_red = parent->m_red;
+					parent->m_red = false;
+					sibling->m_right->m_red = false;
+					rotateLeft(parent);
+					node = m_root;
+				}
+				else
+				{
+					Node* sibling = parent->m_left;
+					if (isRed(sibling))
+					{
+						sibling->m_red = false;
+						parent->m_red = true;
+						rotateRight(parent);
+						sibling = parent->m_left;
+					}
+					if (!isRed(sibling->m_left) && !isRed(sibling->m_right))
+					{
+						sibling->m_red = true;
+						node = parent;
+						parent = node->m_parent;
+						continue;
+					}
+					if (!isRed(sibling->m_left))
+					{
+						sibling->m_right->m_red = false;
+						sibling->m_red = true;
+						rotateLeft(sibling);
+						sibling = parent->m_left;
+					}
+					sibling->m_red = parent->m_red;
+					parent->m_red = false;
+					sibling->m_left->m_red = false;
+					rotateRight(parent);
+					node = m_root;
+				}
+			}
+
+			if (node != nullptr)
+			{
+				node->m_red = false;
+			}
+		}
+
+		//Black height of the subtree, or -1 if it breaks one of the red-black rules
+		int checkSubtree(const Node* node, const Node* parent) const
+		{
+			if (node == nullptr)
+			{
+				return 1;
+			}
+			if (node->m_parent != parent || (node->m_red && isRed(node->m_left)) || (node->m_red && isRed(node->m_right)))
+			{
+				return -1;
+			}
+			if (node->m_left != nullptr && !m_compare(toObject(node->m_left), toObject(const_cast<Node*>(node))))
+			{
+				return -1;
+			}
+			if (node->m_right != nullptr && !m_compare(toObject(const_cast<Node*>(node)), toObject(node->m_right)))
+			{
+				return -1;
+			}
+
+			int left = checkSubtree(node->m_left, node);
+			int right = checkSubtree(node->m_right, node);
+			if (left < 0 || left != right)
+			{
+				return -1;
+			}
+			return left + (node->m_red ? 0 : 1);
+		}
+
+	public:
+		explicit IntrusiveTree(const Compare& compare = Compare())
+			: m_compare(compare)
+		{
+		}
+
+		IntrusiveTree(const IntrusiveTree& other) = delete;
+		IntrusiveTree(IntrusiveTree&& other) = delete;
+		IntrusiveTree& operator=(const IntrusiveTree& other) = delete;
+		IntrusiveTree& operator=(IntrusiveTree&& other) = delete;
+
+		~IntrusiveTree()
+		{
+			clear();
+		}
+
+		//Returns false if an equal object is already in the tree, or the object is linked into another tree
+		bool insert(T& object)
+		{
+			Node* node = static_cast<Node*>(&object);
+			if (node->m_linked)
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+				return false;
+			}
+
+			Node* parent = nullptr;
+			Node** link = &m_root;
+			while (*link != nullptr)
+			{
+				parent = *link;
+				if (m_compare(object, toObject(parent)))
+				{
+					link = &parent->m_left;
+				}
+				else if (m_compare(toObject(parent), object))
+				{
+					link = &parent->m_right;
+				}
+				else
+				{
+					return false;
+				}
+			}
+
+			node->m_parent = parent;
+			node->m_left = nullptr;
+			node->m_right = nullptr;
+			node->m_red = true;
+			node->m_linked = true;
+			*link = node;
+
+			fixAfterInsert(node);
+			m_length++;
+			return true;
+		}
+
+		//object has to be linked into this tree
+		void remove(T& object)
+		{
+			Node* node = static_cast<Node*>(&object);
+			if (!node->m_linked)
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+				return;
+			}
+
+			bool removedBlack = !node->m_red;
+			Node* child;
+			Node* childParent;
+
+			if (node->m_left == nullptr)
+			{
+				child = node->m_right;
+				childParent = node->m_parent;
+				replaceChild(node, child);
+			}
+			else if (node->m_right == nullptr)
+			{
+				child = node->m_left;
+				childParent = node->m_parent;
+				replaceChild(node, child);
+			}
+			else
+			{
+				//The successor has no left child, it is unlinked from its place and takes the place of node
+				Node* next = minimum(node->m_right);
+				removedBlack = !next->m_red;
+				child = next->m_right;
+
+				if (next->m_parent == node)
+				{
+					childParent = next;
+				}
+				else
+				{
+					childParent = next->m_parent;
+					replaceChild(next, next->m_right);
+					next->m_right = node->m_right;
+					next->m_right->m_parent = next;
+				}
+
+				replaceChild(node, next);
+				next->m_left = node->m_left;
+				next->m_left->m_parent = next;
+				next->m_red = node->m_red;
+			}
+
+			if (removedBlack)
+			{
+				fixAfterRemove(child, childParent);
+			}
+
+			node->m_parent = nullptr;
+			node->m_left = nullptr;
+			node->m_right = nullptr;
+			node->m_linked = false;
+			m_length--;
+		}
+
+		//Unlinks every object in O(n)
+		void clear()
+		{
+			Node* node = m_root;
+			while (node != nullptr)
+			{
+				//Descends to a leaf, unlinks it and continues with its parent
+				if (node->m_left != nullptr)
+				{
+					node = node->m_left;
+				}
+				else if (node->m_right != nullptr)
+				{
+					node = node->m_right;
+				}
+				else
+				{
+					Node* parent = node->m_parent;
+					if (parent != nullptr)
+					{
+						(parent->m_left == node ? parent->m_left : parent->m_right) = nullptr;
+					}
+					node->m_parent = nullptr;
+					node->m_linked = false;
+					node = parent;
+				}
+			}
+			m_root = nullptr;
+			m_length = 0;
+		}
+
+		//Key has to be comparable with T in both directions by Compare; nullptr if there is no equal object
+		template <typename Key>
+		T* find(const Key& key)
+		{
+			Node* node = m_root;
+			while (node != nullptr)
+			{
+				if (m_compare(key, toObject(node)))
+				{
+					node = node->m_left;
+				}
+				else if (m_compare(toObject(node), key))
+				{
+					node = node->m_right;
+				}
+				else
+				{
+					return &toObject(node);
+				}
+			}
+			return nullptr;
+		}
+
+		//The first object which is not less than key, nullptr if there is none
+		template <typename Key>
+		T* lowerBound(const Key& key)
+		{
+			Node* node = m_root;
+			Node* result = nullptr;
+			while (node != nullptr)
+			{
+				if (m_compare(toObject(node), key))
+				{
+					node = node->m_right;
+				}
+				else
+				{
+					result = node;
+					node = node->m_left;
+				}
+			}
+			return result == nullptr ? nullptr : &toObject(result);
+		}
+
+		//nullptr if the tree is empty
+		T* first()
+		{
+			return m_root == nullptr ? nullptr : &toObject(minimum(m_root));
+		}
+
+		T* last()
+		{
+			return m_root == nullptr ? nullptr : &toObject(maximum(m_root));
+		}
+
+		//In order neighbours, nullptr at either end
+		T* next(T& object)
+		{
+			Node* next = successor(static_cast<Node*>(&object));
+			return next == nullptr ? nullptr : &toObject(next);
+		}
+
+		T* prev(T& object)
+		{
+			Node* prev = predecessor(static_cast<Node*>(&object));
+			return prev == nullptr ? nullptr : &toObject(prev);
+		}
+
+		Iterator begin()
+		{
+			return Iterator(m_root == nullptr ? nullptr : minimum(m_root));
+		}
+
+		Iterator end()
+		{
+			return Iterator(nullptr);
+		}
+
+		size_t getLength() const
+		{
+			return m_length;
+		}
+
+		bool isEmpty() const
+		{
+			return m_length == 0;
+		}
+
+		//Checks the red-black rules, the parent links and the order. O(n), meant for tests.
+		bool isValid() const
+		{
+			return !isRed(m_root) && checkSubtree(m_root, nullptr) > 0;
+		}
+	};
+}
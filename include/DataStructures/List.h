@@ -1,10 +1,15 @@
 #pragma once
 
+#include "main.h"
 #include <functional>
 #include <initializer_list>
+#include <limits>
+#include <memory>
 
 namespace bbe
 {
+	class StackAllocator;
+
 	namespace INTERNAL
 	{
 		template <typename T>
@@ -93,8 +98,9 @@ namespace bbe
 			other.m_capacity = 0;
 		}
 
-		List(std::initializer_list<T> il) {
-			//UNTESTED
+		List(std::initializer_list<T> il)
+			: m_length(0), m_capacity(0), m_data(nullptr)
+		{
 			for (auto iter = il.begin(); iter != il.end(); iter++) {
 				pushBack(*iter);
 			}
@@ -187,7 +193,7 @@ namespace bbe
 		}
 
 		template <bool dummyKeepSorted = keepSorted>
-		typename std::enable_if<dummyKeepSorted, List<typename T, dummyKeepSorted>&>::type operator+=(List<T, dummyKeepSorted> other)
+		typename std::enable_if<dummyKeepSorted, List<T, dummyKeepSorted>&>::type operator+=(List<T, dummyKeepSorted> other)
 		{
 			static_assert(dummyKeepSorted == keepSorted, "Do not specify dummyKeepSorted!");
 			//UNTESTED
@@ -300,7 +306,7 @@ namespace bbe
 			//TODO rewrite this method using size_t instead of int
 			if (amount <= 0)
 			{
-				__debugbreak();
+				DEBUG_BREAK;
 			}
 			growIfNeeded(amount);
 			//UNTESTED
@@ -363,7 +369,7 @@ namespace bbe
 		template <bool dummyKeepSorted = keepSorted>
 		typename std::enable_if<!dummyKeepSorted, size_t>::type getIndexWhenPushedBack(const T& val)
 		{
-			static_assert(false, "Only sorted Lists can getIndexWhenPushedBack!");
+			static_assert(dummyKeepSorted, "Only sorted Lists can getIndexWhenPushedBack!");
 		}
 
 		template <bool dummyKeepSorted = keepSorted>
@@ -434,7 +440,7 @@ namespace bbe
 		template <bool dummyKeepSorted = keepSorted>
 		typename std::enable_if<!dummyKeepSorted, void>::type getNeighbors(const T& val, T*& leftNeighbor, T*& rightNeighbor)
 		{
-			static_assert(false, "Only sorted Lists can getIndexWhenPushedBack!");
+			static_assert(dummyKeepSorted, "Only sorted Lists can getIndexWhenPushedBack!");
 		}
 
 		template <bool dummyKeepSorted = keepSorted>
@@ -490,16 +496,16 @@ namespace bbe
 			return;
 		}
 
-		template <typename T>
-		void pushBackAll(T&& t)
+		template <typename U>
+		void pushBackAll(U&& t)
 		{
-			pushBack(std::forward<T>(t));
+			pushBack(std::forward<U>(t));
 		}
 
-		template<typename T, typename... arguments>
-		void pushBackAll(T&& t, arguments&&... args)
+		template<typename U, typename... arguments>
+		void pushBackAll(U&& t, arguments&&... args)
 		{
-			pushBack(std::forward<T>(t));
+			pushBack(std::forward<U>(t));
 			pushBackAll(std::forward<arguments>(args)...);
 		}
 
@@ -580,7 +586,7 @@ namespace bbe
 			if (newCapacity < m_length)
 			{
 				//TODO add further error handling
-				debugBreak();
+				DEBUG_BREAK;
 				return;
 			}
 
@@ -741,13 +747,21 @@ namespace bbe
 			sortSTL(reinterpret_cast<T*>(m_data), reinterpret_cast<T*>(m_data + m_length), predicate);
 		}
 
+		//Radix sort for integral and floating point T, the scratch buffer is taken from scratchArena.
+		//Defined in RadixSort.h, which has to be included to call it.
+		void sort(StackAllocator &scratchArena);
+
+		//Radix sort by an integral or floating point key, keyExtractor(const T&) returns the key
+		template <typename KeyExtractor>
+		void sort(StackAllocator &scratchArena, KeyExtractor keyExtractor);
+
 		T& first()
 		{
 			//UNTESTED
 			if (m_data == nullptr)
 			{
 				//TODO error handling
-				__debugbreak();
+				DEBUG_BREAK;
 			}
 
 			return (m_data[0].value);
@@ -759,7 +773,7 @@ namespace bbe
 			if (m_data == nullptr)
 			{
 				//TODO error handling
-				__debugbreak();
+				DEBUG_BREAK;
 			}
 
 			return (m_data[m_length - 1].value);
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "main.h"
+#include "List.h"
+#include "MemoryManagement/StackAllocator.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		template <size_t size>
+		struct RadixUnsigned;
+
+		template <> struct RadixUnsigned<1> { typedef uint8_t type; };
+		template <> struct RadixUnsigned<2> { typedef uint16_t type; };
+		template <> struct RadixUnsigned<4> { typedef uint32_t type; };
+		template <> struct RadixUnsigned<8> { typedef uint64_t type; };
+
+		//Maps a key to an unsigned integer with the same order, so it can be sorted digit by digit
+		template <typename Key>
+		struct RadixKey
+		{
+			static_assert(std::is_integral<Key>::value || std::is_floating_point<Key>::value, "Radix sort keys must be integral or floating point!");
+			static_assert(!std::is_same<Key, bool>::value, "Radix sort keys must not be bool!");
+
+			typedef typename RadixUnsigned<sizeof(Key)>::type Unsigned;
+			static const Unsigned SIGN_BIT = Unsigned(1) << (sizeof(Key) * 8 - 1);
+
+			static Unsigned toUnsigned(Key key)
+			{
+				Unsigned bits;
+				std::memcpy(&bits, &key, sizeof(Key));
+
+				if (std::is_floating_point<Key>::value)
+				{
+					//Negative floats are ordered backwards, so all their bits get flipped. Positive ones only need the sign bit.
+					//-0.0 ends up directly in front of +0.0.
+					return (bits & SIGN_BIT) ? Unsigned(~bits) : Unsigned(bits | SIGN_BIT);
+				}
+				else if (std::is_signed<Key>::value)
+				{
+					return bits ^ SIGN_BIT;
+				}
+				return bits;
+			}
+		};
+
+		struct RadixIdentity
+		{
+			template <typename T>
+			const T& operator()(const T &value) const
+			{
+				return value;
+			}
+		};
+	}
+
+	//Stable LSD radix sort with 8 bit digits. keyExtractor(const T&) has to return an integral or floating point key.
+	//T has to be trivially copyable, the elements are copied between data and a scratch buffer of the same size
+	//which is taken from scratch and given back before returning. If scratch is too small, std::stable_sort is used.
+	template <typename T, typename KeyExtractor>
+	void radixSort(T *data, size_t length, StackAllocator &scratch, KeyExtractor keyExtractor)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Radix sort only works on trivially copyable types!");
+
+		typedef typename std::decay<decltype(keyExtractor(*data))>::type Key;
+		typedef INTERNAL::RadixKey<Key> RadixKey;
+		const size_t DIGITS = sizeof(Key);
+		const size_t BUCKETS = 256;
+
+		if (length < 2)
+		{
+			return;
+		}
+
+		StackAllocatorMarker marker = scratch.getMarker();
+		T *buffer = static_cast<T*>(scratch.allocate(length * sizeof(T), alignof(T)));
+		if (buffer == nullptr)
+		{
+			std::stable_sort(data, data + length, [&](const T &a, const T &b) {
+				return RadixKey::toUnsigned(keyExtractor(a)) < RadixKey::toUnsigned(keyExtractor(b));
+			});
+			return;
+		}
+
+		//One read of the data fills the histograms of all digits
+		size_t histograms[DIGITS][BUCKETS] = {};
+		for (size_t i = 0; i < length; i++)
+		{
+			typename RadixKey::Unsigned key = RadixKey::toUnsigned(keyExtractor(data[i]));
+			for (size_t digit = 0; digit < DIGITS; digit++)
+			{
+				histograms[digit][(key >> (digit * 8)) & 0xFF]++;
+			}
+		}
+
+		T *source = data;
+		T *target = buffer;
+		for (size_t digit = 0; digit < DIGITS; digit++)
+		{
+			size_t *histogram = histograms[digit];
+
+			//All keys share this digit, the pass would not move anything
+			typename RadixKey::Unsigned firstKey = RadixKey::toUnsigned(keyExtractor(source[0]));
+			if (histogram[(firstKey >> (digit * 8)) & 0xFF] == length)
+			{
+				continue;
+			}
+
+			size_t offset = 0;
+			for (size_t bucket = 0; bucket < BUCKETS; bucket++)
+			{
+				size_t count = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += count;
+			}
+
+			for (size_t i = 0; i < length; i++)
+			{
+				typename RadixKey::Unsigned key = RadixKey::toUnsigned(keyExtractor(source[i]));
+				target[histogram[(key >> (digit * 8)) & 0xFF]++] = source[i];
+			}
+
+			std::swap(source, target);
+		}
+
+		if (source != data)
+		{
+			std::memcpy(data, source, length * sizeof(T));
+		}
+
+		scratch.deallocateToMarker(marker);
+	}
+
+	template <typename T>
+	void radixSort(T *data, size_t length, StackAllocator &scratch)
+	{
+		radixSort(data, length, scratch, INTERNAL::RadixIdentity());
+	}
+
+	//Sorts keys and moves values along, like radixSort on (key, value) pairs. Key and Value have to be trivially
+	//copyable. If scratch is too small for the pairs, std::stable_sort is used on a heap copy instead.
+	template <typename Key, typename Value>
+	void radixSort(Key *keys, Value *values, size_t length, StackAllocator &scratch)
+	{
+		struct Pair
+		{
+			Key key;
+			Value value;
+		};
+
+		StackAllocatorMarker marker = scratch.getMarker();
+		Pair *pairs = static_cast<Pair*>(scratch.allocate(length * sizeof(Pair), alignof(Pair)));
+		std::vector<Pair> heapPairs;
+		if (pairs == nullptr)
+		{
+			//The pairs don't fit into scratch, so they are zipped on the heap and sorted with std::stable_sort
+			heapPairs.resize(length);
+			pairs = heapPairs.data();
+		}
+
+		for (size_t i = 0; i < length; i++)
+		{
+			pairs[i].key = keys[i];
+			pairs[i].value = values[i];
+		}
+
+		radixSort(pairs, length, scratch, [](const Pair &pair) { return pair.key; });
+
+		for (size_t i = 0; i < length; i++)
+		{
+			keys[i] = pairs[i].key;
+			values[i] = pairs[i].value;
+		}
+
+		scratch.deallocateToMarker(marker);
+	}
+
+	template <typename T, bool keepSorted>
+	void List<T, keepSorted>::sort(StackAllocator &scratchArena)
+	{
+		radixSort(reinterpret_cast<T*>(m_data), m_length, scratchArena);
+	}
+
+	template <typename T, bool keepSorted>
+	template <typename KeyExtractor>
+	void List<T, keepSorted>::sort(StackAllocator &scratchArena, KeyExtractor keyExtractor)
+	{
+		radixSort(reinterpret_cast<T*>(m_data), m_length, scratchArena, keyExtractor);
+	}
+}
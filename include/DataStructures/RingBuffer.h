@@ -0,0 +1,313 @@
+#pragma once
+
+#include "main.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		static const size_t RING_BUFFER_CACHE_LINE_SIZE = 64;
+
+		inline size_t nextPowerOfTwo(size_t value)
+		{
+			size_t powerOfTwo = 1;
+			while (powerOfTwo < value)
+			{
+				powerOfTwo <<= 1;
+			}
+			return powerOfTwo;
+		}
+
+		template <typename T>
+		union RingBufferSlot
+		{
+			//Like ListChunk, keeps the constructor of T from being called
+			T value;
+
+			RingBufferSlot() {}
+			~RingBufferSlot() {}
+		};
+
+		template <typename T>
+		struct RingBufferCell
+		{
+			//Equal to the index of the next push for a free cell, one more than that for a filled cell
+			std::atomic<size_t> sequence;
+			RingBufferSlot<T> slot;
+		};
+	}
+
+	//Bounded lock-free queue for exactly one producer thread and one consumer thread.
+	//The capacity is rounded up to a power of two.
+	template <typename T, typename Allocator = std::allocator<INTERNAL::RingBufferSlot<T>>>
+	class SpscRingBuffer
+	{
+	private:
+		static const size_t SPSC_RING_BUFFER_DEFAULT_SIZE = 1024;
+
+		//The indices only ever grow, the slot is index & m_mask. Each side caches the index of the
+		//other side and only reloads it when the queue looks full (or empty).
+		struct alignas(INTERNAL::RING_BUFFER_CACHE_LINE_SIZE) ProducerSide
+		{
+			std::atomic<size_t> m_tail{0};
+			size_t m_cachedHead = 0;
+		};
+
+		struct alignas(INTERNAL::RING_BUFFER_CACHE_LINE_SIZE) ConsumerSide
+		{
+			std::atomic<size_t> m_head{0};
+			size_t m_cachedTail = 0;
+		};
+
+		ProducerSide m_producer;
+		ConsumerSide m_consumer;
+
+		size_t m_capacity = 0;
+		size_t m_mask = 0;
+		INTERNAL::RingBufferSlot<T>* m_data = nullptr;
+
+		Allocator* m_parentAllocator = nullptr;
+		bool m_needsToDeleteParentAllocator = false;
+
+	public:
+		explicit SpscRingBuffer(size_t capacity = SPSC_RING_BUFFER_DEFAULT_SIZE, Allocator* parentAllocator = nullptr)
+			: m_capacity(INTERNAL::nextPowerOfTwo(capacity)), m_parentAllocator(parentAllocator)
+		{
+			if (parentAllocator == nullptr)
+			{
+				m_parentAllocator = new Allocator();
+				m_needsToDeleteParentAllocator = true;
+			}
+
+			m_mask = m_capacity - 1;
+			m_data = m_parentAllocator->allocate(m_capacity);
+		}
+
+		SpscRingBuffer(const SpscRingBuffer& other) = delete;
+		SpscRingBuffer(SpscRingBuffer&& other) = delete;
+		SpscRingBuffer& operator=(const SpscRingBuffer& other) = delete;
+		SpscRingBuffer& operator=(SpscRingBuffer&& other) = delete;
+
+		~SpscRingBuffer()
+		{
+			const size_t tail = m_producer.m_tail.load(std::memory_order_relaxed);
+			for (size_t i = m_consumer.m_head.load(std::memory_order_relaxed); i != tail; i++)
+			{
+				m_data[i & m_mask].value.~T();
+			}
+
+			m_parentAllocator->deallocate(m_data, m_capacity);
+
+			if (m_needsToDeleteParentAllocator)
+			{
+				delete m_parentAllocator;
+			}
+
+			m_data = nullptr;
+		}
+
+		//Producer thread only. Returns false if the queue is full.
+		template <typename... arguments>
+		bool tryPush(arguments&&... args)
+		{
+			const size_t tail = m_producer.m_tail.load(std::memory_order_relaxed);
+			if (tail - m_producer.m_cachedHead == m_capacity)
+			{
+				m_producer.m_cachedHead = m_consumer.m_head.load(std::memory_order_acquire);
+				if (tail - m_producer.m_cachedHead == m_capacity)
+				{
+					return false;
+				}
+			}
+
+			new (std::addressof(m_data[tail & m_mask].value)) T(std::forward<arguments>(args)...);
+			m_producer.m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		//Consumer thread only. Returns false if the queue is empty.
+		bool tryPop(T& out)
+		{
+			const size_t head = m_consumer.m_head.load(std::memory_order_relaxed);
+			if (head == m_consumer.m_cachedTail)
+			{
+				m_consumer.m_cachedTail = m_producer.m_tail.load(std::memory_order_acquire);
+				if (head == m_consumer.m_cachedTail)
+				{
+					return false;
+				}
+			}
+
+			T& value = m_data[head & m_mask].value;
+			out = std::move(value);
+			value.~T();
+			m_consumer.m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		//Only exact if neither side is running
+		size_t getLength() const
+		{
+			return m_producer.m_tail.load(std::memory_order_acquire) - m_consumer.m_head.load(std::memory_order_acquire);
+		}
+
+		size_t getCapacity() const
+		{
+			return m_capacity;
+		}
+	};
+
+	//Bounded lock-free queue for any amount of producer and consumer threads (Vyukov's bounded MPMC queue).
+	//Every cell carries a sequence number, so producers and consumers only contend on their own index.
+	//The capacity is rounded up to a power of two.
+	template <typename T, typename Allocator = std::allocator<INTERNAL::RingBufferCell<T>>>
+	class MpmcRingBuffer
+	{
+	private:
+		static const size_t MPMC_RING_BUFFER_DEFAULT_SIZE = 1024;
+
+		struct alignas(INTERNAL::RING_BUFFER_CACHE_LINE_SIZE) PaddedIndex
+		{
+			std::atomic<size_t> m_value{0};
+		};
+
+		PaddedIndex m_tail;
+		PaddedIndex m_head;
+
+		size_t m_capacity = 0;
+		size_t m_mask = 0;
+		INTERNAL::RingBufferCell<T>* m_data = nullptr;
+
+		Allocator* m_parentAllocator = nullptr;
+		bool m_needsToDeleteParentAllocator = false;
+
+	public:
+		explicit MpmcRingBuffer(size_t capacity = MPMC_RING_BUFFER_DEFAULT_SIZE, Allocator* parentAllocator = nullptr)
+			: m_capacity(INTERNAL::nextPowerOfTwo(capacity < 2 ? 2 : capacity)), m_parentAllocator(parentAllocator)
+		{
+			if (parentAllocator == nullptr)
+			{
+				m_parentAllocator = new Allocator();
+				m_needsToDeleteParentAllocator = true;
+			}
+
+			m_mask = m_capacity - 1;
+			m_data = m_parentAllocator->allocate(m_capacity);
+			for (size_t i = 0; i < m_capacity; i++)
+			{
+				new (std::addressof(m_data[i].sequence)) std::atomic<size_t>(i);
+			}
+		}
+
+		MpmcRingBuffer(const MpmcRingBuffer& other) = delete;
+		MpmcRingBuffer(MpmcRingBuffer&& other) = delete;
+		MpmcRingBuffer& operator=(const MpmcRingBuffer& other) = delete;
+		MpmcRingBuffer& operator=(MpmcRingBuffer&& other) = delete;
+
+		~MpmcRingBuffer()
+		{
+			const size_t tail = m_tail.m_value.load(std::memory_order_relaxed);
+			for (size_t i = m_head.m_value.load(std::memory_order_relaxed); i != tail; i++)
+			{
+				m_data[i & m_mask].slot.value.~T();
+			}
+
+			m_parentAllocator->deallocate(m_data, m_capacity);
+
+			if (m_needsToDeleteParentAllocator)
+			{
+				delete m_parentAllocator;
+			}
+
+			m_data = nullptr;
+		}
+
+		//Returns false if the queue is full
+		template <typename... arguments>
+		bool tryPush(arguments&&... args)
+		{
+			size_t tail = m_tail.m_value.load(std::memory_order_relaxed);
+			INTERNAL::RingBufferCell<T>* cell;
+
+			while (true)
+			{
+				cell = &m_data[tail & m_mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const intptr_t difference = (intptr_t)sequence - (intptr_t)tail;
+
+				if (difference == 0)
+				{
+					if (m_tail.m_value.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if (difference < 0)
+				{
+					return false; //The cell still holds the value from one round ago
+				}
+				else
+				{
+					tail = m_tail.m_value.load(std::memory_order_relaxed);
+				}
+			}
+
+			new (std::addressof(cell->slot.value)) T(std::forward<arguments>(args)...);
+			cell->sequence.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		//Returns false if the queue is empty
+		bool tryPop(T& out)
+		{
+			size_t head = m_head.m_value.load(std::memory_order_relaxed);
+			INTERNAL::RingBufferCell<T>* cell;
+
+			while (true)
+			{
+				cell = &m_data[head & m_mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const intptr_t difference = (intptr_t)sequence - (intptr_t)(head + 1);
+
+				if (difference == 0)
+				{
+					if (m_head.m_value.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if (difference < 0)
+				{
+					return false; //Nothing was pushed into this cell yet
+				}
+				else
+				{
+					head = m_head.m_value.load(std::memory_order_relaxed);
+				}
+			}
+
+			T& value = cell->slot.value;
+			out = std::move(value);
+			value.~T();
+			cell->sequence.store(head + m_capacity, std::memory_order_release);
+			return true;
+		}
+
+		//Approximation while other threads push or pop
+		size_t getLength() const
+		{
+			const size_t head = m_head.m_value.load(std::memory_order_acquire);
+			const size_t tail = m_tail.m_value.load(std::memory_order_acquire);
+			return tail > head ? tail - head : 0;
+		}
+
+		size_t getCapacity() const
+		{
+			return m_capacity;
+		}
+	};
+}
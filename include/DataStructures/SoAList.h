@@ -0,0 +1,266 @@
+#pragma once
+
+#include "main.h"
+#include "Util/DataTypes.h"
+#include "Span.h"
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		//Every field array starts on its own cache line, which is also enough for any SIMD load
+		static const size_t SOA_LIST_ALIGNMENT = 64;
+
+		inline size_t alignSoAListOffset(size_t offset)
+		{
+			return (offset + SOA_LIST_ALIGNMENT - 1) / SOA_LIST_ALIGNMENT * SOA_LIST_ALIGNMENT;
+		}
+	}
+
+	//Structure of arrays counterpart of List: every field is stored in its own array, so loops which only touch a
+	//few fields only load those and can be vectorized. All arrays share one block from the byte allocator.
+	template <typename Allocator, typename... Fields>
+	class BasicSoAList
+	{
+	public:
+		template <size_t I>
+		using FieldType = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+		static const size_t FIELD_COUNT = sizeof...(Fields);
+
+	private:
+		static_assert(FIELD_COUNT > 0, "SoAList needs at least one field!");
+
+		typedef std::index_sequence_for<Fields...> FieldIndices;
+
+		std::tuple<Fields*...> m_fields;
+		size_t m_length = 0;
+		size_t m_capacity = 0;
+		size_t m_allocationSize = 0;
+		byte* m_allocation = nullptr;
+
+		Allocator* m_parentAllocator = nullptr;
+		bool m_needsToDeleteParentAllocator = false;
+
+		static size_t getAllocationSize(size_t capacity)
+		{
+			size_t size = INTERNAL::SOA_LIST_ALIGNMENT; //Slack for aligning the first array
+			for (size_t fieldSize : { sizeof(Fields)... })
+			{
+				size += INTERNAL::alignSoAListOffset(capacity * fieldSize);
+			}
+			return size;
+		}
+
+		template <size_t... I>
+		static void assignFields(std::tuple<Fields*...> &fields, byte* allocation, size_t capacity, std::index_sequence<I...>)
+		{
+			byte* current = allocation + (INTERNAL::SOA_LIST_ALIGNMENT - (size_t)allocation % INTERNAL::SOA_LIST_ALIGNMENT) % INTERNAL::SOA_LIST_ALIGNMENT;
+			((std::get<I>(fields) = reinterpret_cast<FieldType<I>*>(current), current += INTERNAL::alignSoAListOffset(capacity * sizeof(FieldType<I>))), ...);
+		}
+
+		template <size_t... I>
+		void moveFields(std::tuple<Fields*...> &target, std::index_sequence<I...>)
+		{
+			(moveField(std::get<I>(target), std::get<I>(m_fields)), ...);
+		}
+
+		template <typename T>
+		void moveField(T* target, T* source)
+		{
+			for (size_t i = 0; i < m_length; i++)
+			{
+				new (std::addressof(target[i])) T(std::move(source[i]));
+				source[i].~T();
+			}
+		}
+
+		template <size_t... I, typename... Arguments>
+		void constructRow(size_t index, std::index_sequence<I...>, Arguments&&... values)
+		{
+			(new (std::addressof(std::get<I>(m_fields)[index])) FieldType<I>(std::forward<Arguments>(values)), ...);
+		}
+
+		template <size_t... I>
+		void destroyRow(size_t index, std::index_sequence<I...>)
+		{
+			(std::get<I>(m_fields)[index].~FieldType<I>(), ...);
+		}
+
+		//Replaces the row at index with the last one
+		template <size_t... I>
+		void moveLastRow(size_t index, std::index_sequence<I...>)
+		{
+			(moveLastField(std::get<I>(m_fields), index), ...);
+		}
+
+		template <typename T>
+		void moveLastField(T* field, size_t index)
+		{
+			field[index] = std::move(field[m_length - 1]);
+		}
+
+		void growIfNeeded(size_t amountOfNewObjects)
+		{
+			if (m_capacity < m_length + amountOfNewObjects)
+			{
+				size_t newCapacity = m_length + amountOfNewObjects;
+				if (newCapacity < m_capacity * 2)
+				{
+					newCapacity = m_capacity * 2;
+				}
+				resizeCapacity(newCapacity);
+			}
+		}
+
+	public:
+		explicit BasicSoAList(Allocator* parentAllocator = nullptr)
+			: m_parentAllocator(parentAllocator)
+		{
+			if (parentAllocator == nullptr)
+			{
+				m_parentAllocator = new Allocator();
+				m_needsToDeleteParentAllocator = true;
+			}
+		}
+
+		BasicSoAList(const BasicSoAList& other) = delete;
+		BasicSoAList(BasicSoAList&& other) = delete;
+		BasicSoAList& operator=(const BasicSoAList& other) = delete;
+		BasicSoAList& operator=(BasicSoAList&& other) = delete;
+
+		~BasicSoAList()
+		{
+			clear();
+			if (m_allocation != nullptr)
+			{
+				m_parentAllocator->deallocate(m_allocation, m_allocationSize);
+			}
+
+			if (m_needsToDeleteParentAllocator)
+			{
+				delete m_parentAllocator;
+			}
+		}
+
+		//One value per field, in the order of Fields
+		template <typename... Arguments>
+		void pushBack(Arguments&&... values)
+		{
+			static_assert(sizeof...(Arguments) == FIELD_COUNT, "pushBack needs one value per field!");
+			growIfNeeded(1);
+			constructRow(m_length, FieldIndices(), std::forward<Arguments>(values)...);
+			m_length++;
+		}
+
+		void popBack(size_t amount = 1)
+		{
+			if (amount > m_length)
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+				amount = m_length;
+			}
+
+			for (size_t i = 0; i < amount; i++)
+			{
+				m_length--;
+				destroyRow(m_length, FieldIndices());
+			}
+		}
+
+		//O(1) removal which moves the last row into the gap, so the order is not kept
+		bool removeIndexSwap(size_t index)
+		{
+			if (index >= m_length)
+			{
+				return false;
+			}
+
+			if (index != m_length - 1)
+			{
+				moveLastRow(index, FieldIndices());
+			}
+			popBack();
+			return true;
+		}
+
+		void clear()
+		{
+			popBack(m_length);
+		}
+
+		void resizeCapacity(size_t newCapacity)
+		{
+			if (newCapacity <= m_capacity)
+			{
+				return;
+			}
+
+			std::tuple<Fields*...> newFields;
+			size_t newAllocationSize = getAllocationSize(newCapacity);
+			byte* newAllocation = m_parentAllocator->allocate(newAllocationSize);
+			assignFields(newFields, newAllocation, newCapacity, FieldIndices());
+
+			if (m_allocation != nullptr)
+			{
+				moveFields(newFields, FieldIndices());
+				m_parentAllocator->deallocate(m_allocation, m_allocationSize);
+			}
+
+			m_fields = newFields;
+			m_allocation = newAllocation;
+			m_allocationSize = newAllocationSize;
+			m_capacity = newCapacity;
+		}
+
+		//The whole array of field I. Pointers into it are invalidated when the list grows.
+		template <size_t I>
+		Span<FieldType<I>> getField()
+		{
+			return Span<FieldType<I>>(std::get<I>(m_fields), m_length);
+		}
+
+		template <size_t I>
+		Span<const FieldType<I>> getField() const
+		{
+			return Span<const FieldType<I>>(std::get<I>(m_fields), m_length);
+		}
+
+		template <size_t I>
+		FieldType<I>& get(size_t index)
+		{
+			return std::get<I>(m_fields)[index];
+		}
+
+		template <size_t I>
+		const FieldType<I>& get(size_t index) const
+		{
+			return std::get<I>(m_fields)[index];
+		}
+
+		size_t getLength() const
+		{
+			return m_length;
+		}
+
+		size_t getCapacity() const
+		{
+			return m_capacity;
+		}
+
+		bool isEmpty() const
+		{
+			return m_length == 0;
+		}
+	};
+
+	template <typename... Fields>
+	using SoAList = BasicSoAList<std::allocator<byte>, Fields...>;
+}
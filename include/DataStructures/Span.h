@@ -0,0 +1,54 @@
+#pragma once
+
+#include "main.h"
+#include <cstddef>
+
+namespace bbe
+{
+	//Non owning view of length contiguous objects. Only valid until the container it came from reallocates.
+	template <typename T>
+	class Span
+	{
+	private:
+		T* m_data = nullptr;
+		size_t m_length = 0;
+
+	public:
+		Span() = default;
+
+		Span(T* data, size_t length)
+			: m_data(data), m_length(length)
+		{
+		}
+
+		T& operator[](size_t index) const
+		{
+			return m_data[index];
+		}
+
+		T* getRaw() const
+		{
+			return m_data;
+		}
+
+		size_t getLength() const
+		{
+			return m_length;
+		}
+
+		bool isEmpty() const
+		{
+			return m_length == 0;
+		}
+
+		T* begin() const
+		{
+			return m_data;
+		}
+
+		T* end() const
+		{
+			return m_data + m_length;
+		}
+	};
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "main.h"
+#include "Util/DataTypes.h"
+#include "List.h"
+#include "Span.h"
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		//Sparse entries per page. Keys far apart only cost the pages they actually land in.
+		static const size_t SPARSE_SET_PAGE_SIZE = 4096;
+		static const uint32_t SPARSE_SET_EMPTY = 0xFFFFFFFF;
+	}
+
+	//Maps uint32_t keys (usually entity indices) to densely packed values. The sparse array holds the dense index
+	//of every key and is split into lazily allocated pages from the byte allocator, the keys and values themselves
+	//are kept in two Lists without gaps, so iterating them is a linear walk. Removing moves the last entry into
+	//the gap, which makes every operation O(1) but does not keep the order.
+	template <typename T, typename Allocator = std::allocator<byte>>
+	class SparseSet
+	{
+	private:
+		List<uint32_t*> m_pages;
+		List<uint32_t> m_keys;
+		List<T> m_values;
+
+		Allocator* m_parentAllocator = nullptr;
+		bool m_needsToDeleteParentAllocator = false;
+
+		uint32_t getDenseIndex(uint32_t key) const
+		{
+			const size_t page = key / INTERNAL::SPARSE_SET_PAGE_SIZE;
+			if (page >= m_pages.getLength() || m_pages[page] == nullptr)
+			{
+				return INTERNAL::SPARSE_SET_EMPTY;
+			}
+			return m_pages[page][key % INTERNAL::SPARSE_SET_PAGE_SIZE];
+		}
+
+		uint32_t& getSparseEntry(uint32_t key)
+		{
+			const size_t page = key / INTERNAL::SPARSE_SET_PAGE_SIZE;
+			while (page >= m_pages.getLength())
+			{
+				m_pages.pushBack(nullptr);
+			}
+
+			if (m_pages[page] == nullptr)
+			{
+				m_pages[page] = reinterpret_cast<uint32_t*>(m_parentAllocator->allocate(INTERNAL::SPARSE_SET_PAGE_SIZE * sizeof(uint32_t)));
+				for (size_t i = 0; i < INTERNAL::SPARSE_SET_PAGE_SIZE; i++)
+				{
+					m_pages[page][i] = INTERNAL::SPARSE_SET_EMPTY;
+				}
+			}
+			return m_pages[page][key % INTERNAL::SPARSE_SET_PAGE_SIZE];
+		}
+
+	public:
+		explicit SparseSet(Allocator* parentAllocator = nullptr)
+			: m_parentAllocator(parentAllocator)
+		{
+			if (parentAllocator == nullptr)
+			{
+				m_parentAllocator = new Allocator();
+				m_needsToDeleteParentAllocator = true;
+			}
+		}
+
+		SparseSet(const SparseSet& other) = delete;
+		SparseSet(SparseSet&& other) = delete;
+		SparseSet& operator=(const SparseSet& other) = delete;
+		SparseSet& operator=(SparseSet&& other) = delete;
+
+		~SparseSet()
+		{
+			for (size_t i = 0; i < m_pages.getLength(); i++)
+			{
+				if (m_pages[i] != nullptr)
+				{
+					m_parentAllocator->deallocate(reinterpret_cast<byte*>(m_pages[i]), INTERNAL::SPARSE_SET_PAGE_SIZE * sizeof(uint32_t));
+				}
+			}
+
+			if (m_needsToDeleteParentAllocator)
+			{
+				delete m_parentAllocator;
+			}
+		}
+
+		//Returns nullptr and leaves the set unchanged, if key is already in the set
+		template <typename... arguments>
+		T* add(uint32_t key, arguments&&... args)
+		{
+			if (key == INTERNAL::SPARSE_SET_EMPTY)
+			{
+				DEBUG_BREAK;
+				//TODO add further error handling
+				return nullptr;
+			}
+
+			uint32_t& entry = getSparseEntry(key);
+			if (entry != INTERNAL::SPARSE_SET_EMPTY)
+			{
+				return nullptr;
+			}
+
+			entry = (uint32_t)m_keys.getLength();
+			m_keys.pushBack(key);
+			m_values.pushBack(T(std::forward<arguments>(args)...));
+			return &m_values.last();
+		}
+
+		bool remove(uint32_t key)
+		{
+			const uint32_t index = getDenseIndex(key);
+			if (index == INTERNAL::SPARSE_SET_EMPTY)
+			{
+				return false;
+			}
+
+			const uint32_t lastKey = m_keys.last();
+			if (lastKey != key)
+			{
+				m_keys[index] = lastKey;
+				m_values[index] = std::move(m_values.last());
+				getSparseEntry(lastKey) = index;
+			}
+			getSparseEntry(key) = INTERNAL::SPARSE_SET_EMPTY;
+			m_keys.popBack();
+			m_values.popBack();
+			return true;
+		}
+
+		bool contains(uint32_t key) const
+		{
+			return getDenseIndex(key) != INTERNAL::SPARSE_SET_EMPTY;
+		}
+
+		T* get(uint32_t key)
+		{
+			const uint32_t index = getDenseIndex(key);
+			return index == INTERNAL::SPARSE_SET_EMPTY ? nullptr : &m_values[index];
+		}
+
+		const T* get(uint32_t key) const
+		{
+			const uint32_t index = getDenseIndex(key);
+			return index == INTERNAL::SPARSE_SET_EMPTY ? nullptr : &m_values[index];
+		}
+
+		//Keeps the pages, so refilling the set doesn't allocate them again
+		void clear()
+		{
+			for (size_t i = 0; i < m_keys.getLength(); i++)
+			{
+				getSparseEntry(m_keys[i]) = INTERNAL::SPARSE_SET_EMPTY;
+			}
+			m_keys.clear();
+			m_values.clear();
+		}
+
+		void reserve(size_t amount)
+		{
+			m_keys.resizeCapacity(amount);
+			m_values.resizeCapacity(amount);
+		}
+
+		//The keys and values in dense order, getKeys()[i] belongs to getValues()[i]
+		Span<const uint32_t> getKeys() const
+		{
+			return Span<const uint32_t>(m_keys.getRaw(), m_keys.getLength());
+		}
+
+		Span<T> getValues()
+		{
+			return Span<T>(m_values.getRaw(), m_values.getLength());
+		}
+
+		//function(uint32_t key, T& value) for every entry in dense order
+		template <typename Function>
+		void forEach(Function function)
+		{
+			const uint32_t* keys = m_keys.getRaw();
+			T* values = m_values.getRaw();
+			for (size_t i = 0; i < m_keys.getLength(); i++)
+			{
+				function(keys[i], values[i]);
+			}
+		}
+
+		size_t getLength() const
+		{
+			return m_keys.getLength();
+		}
+
+		bool isEmpty() const
+		{
+			return m_keys.getLength() == 0;
+		}
+
+		size_t getPageCount() const
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < m_pages.getLength(); i++)
+			{
+				if (m_pages[i] != nullptr)
+				{
+					count++;
+				}
+			}
+			return count;
+		}
+	};
+}
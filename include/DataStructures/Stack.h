@@ -22,7 +22,7 @@ namespace bbe
 			if (m_data.getLength() <= 0)
 			{
 				//TODO add further error handling
-				__debugbreak();
+				DEBUG_BREAK;
 			}
 
 			T data = std::move(m_data.last());
@@ -35,7 +35,7 @@ namespace bbe
 			if (m_data.getLength() <= 0)
 			{
 				//TODO add further error handling
-				__debugbreak();
+				DEBUG_BREAK;
 			}
 
 			return m_data.last();
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "main.h"
+#include "IntrusiveList.h"
+#include "List.h"
+#include "../MemoryManagement/PoolAllocator.h"
+#include <cstdint>
+#include <utility>
+
+namespace bbe
+{
+	namespace INTERNAL
+	{
+		static const size_t TIMER_WHEEL_LEVELS = 4;
+		static const size_t TIMER_WHEEL_SLOT_BITS = 8;
+		static const size_t TIMER_WHEEL_SLOTS = (size_t)1 << TIMER_WHEEL_SLOT_BITS;
+		static const uint64_t TIMER_WHEEL_SLOT_MASK = TIMER_WHEEL_SLOTS - 1;
+		//Timers further out wait in the last level and are placed again whenever their slot comes around
+		static const uint64_t TIMER_WHEEL_MAX_DELAY = ((uint64_t)1 << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1;
+
+		template <typename T>
+		struct TimerWheelTimer : IntrusiveListNode<>
+		{
+			uint64_t m_expiry;
+			uint64_t m_id;
+			uint8_t m_level = 0; //The slot the timer is linked into
+			uint8_t m_slot = 0;
+			T m_payload;
+
+			TimerWheelTimer(uint64_t expiry, uint64_t id, T&& payload)
+				: m_expiry(expiry), m_id(id), m_payload(std::move(payload))
+			{
+			}
+		};
+	}
+
+	template <typename T>
+	class TimerHandle
+	{
+		template <typename U>
+		friend class TimerWheel;
+
+	private:
+		INTERNAL::TimerWheelTimer<T>* m_timer = nullptr;
+		uint64_t m_id = 0;
+	};
+
+	//Hierarchical timing wheel: 4 levels of 256 slots, where a slot of level n covers 256^n ticks. A timer is
+	//linked into the slot of the coarsest level its delay needs, and moved down a level whenever the wheel below
+	//wrapped around, so scheduling and cancelling are O(1) and a tick only looks at the timers which are due.
+	//The timers are nodes from a PoolAllocator, the payloads of all timers expiring in a tick are handed out
+	//as one batch.
+	template <typename T>
+	class TimerWheel
+	{
+	private:
+		typedef INTERNAL::TimerWheelTimer<T> Timer;
+		typedef IntrusiveList<Timer> Slot;
+
+		PoolAllocator<Timer> m_timerPool;
+		Slot m_slots[INTERNAL::TIMER_WHEEL_LEVELS][INTERNAL::TIMER_WHEEL_SLOTS];
+		uint64_t m_now = 0;
+		uint64_t m_nextId = 1;
+		size_t m_length = 0;
+
+		void place(Timer& timer)
+		{
+			uint64_t delay = timer.m_expiry - m_now;
+			uint64_t expiry = timer.m_expiry;
+			if (delay > INTERNAL::TIMER_WHEEL_MAX_DELAY)
+			{
+				delay = INTERNAL::TIMER_WHEEL_MAX_DELAY;
+				expiry = m_now + INTERNAL::TIMER_WHEEL_MAX_DELAY;
+			}
+
+			size_t level = 0;
+			while (delay >> ((level + 1) * INTERNAL::TIMER_WHEEL_SLOT_BITS) != 0)
+			{
+				level++;
+			}
+			timer.m_level = (uint8_t)level;
+			timer.m_slot = (uint8_t)((expiry >> (level * INTERNAL::TIMER_WHEEL_SLOT_BITS)) & INTERNAL::TIMER_WHEEL_SLOT_MASK);
+			m_slots[timer.m_level][timer.m_slot].pushBack(timer);
+		}
+
+		//Spreads the current slot of level over the levels below it
+		void cascade(size_t level)
+		{
+			Slot& slot = m_slots[level][(m_now >> (level * INTERNAL::TIMER_WHEEL_SLOT_BITS)) & INTERNAL::TIMER_WHEEL_SLOT_MASK];
+			Slot due;
+			while (Timer* timer = slot.popFront())
+			{
+				due.pushBack(*timer);
+			}
+			while (Timer* timer = due.popFront())
+			{
+				place(*timer);
+			}
+		}
+
+	public:
+		static const size_t DEFAULT_MAX_TIMERS = 1024;
+
+		explicit TimerWheel(size_t maxTimers = DEFAULT_MAX_TIMERS)
+			: m_timerPool(maxTimers)
+		{
+		}
+
+		TimerWheel(const TimerWheel& other) = delete;
+		TimerWheel(TimerWheel&& other) = delete;
+		TimerWheel& operator=(const TimerWheel& other) = delete;
+		TimerWheel& operator=(TimerWheel&& other) = delete;
+
+		~TimerWheel()
+		{
+			clear();
+		}
+
+		//The payload is handed out by the tick delay ticks from now, a delay of 0 counts as 1
+		TimerHandle<T> schedule(uint64_t delay, T payload)
+		{
+			Timer* timer = m_timerPool.allocate(m_now + (delay == 0 ? 1 : delay), m_nextId++, std::move(payload));
+			TimerHandle<T> handle;
+			if (timer == nullptr)
+			{
+				return handle;
+			}
+
+			place(*timer);
+			m_length++;
+			handle.m_timer = timer;
+			handle.m_id = timer->m_id;
+			return handle;
+		}
+
+		//Pending timers only; expired or cancelled timers and default constructed handles are not pending
+		bool isPending(const TimerHandle<T>& handle) const
+		{
+			//A stale handle may point to a timer node which was freed or reused for another timer. The node stays
+			//in the pool either way, and the id tells the timers apart.
+			return handle.m_timer != nullptr && handle.m_timer->isLinked() && handle.m_timer->m_id == handle.m_id;
+		}
+
+		bool cancel(const TimerHandle<T>& handle)
+		{
+			if (!isPending(handle))
+			{
+				return false;
+			}
+
+			Timer* timer = handle.m_timer;
+			m_slots[timer->m_level][timer->m_slot].remove(*timer);
+			m_timerPool.deallocate(timer);
+			m_length--;
+			return true;
+		}
+
+		//Advances the wheel by one tick and appends the payloads of all timers which expire to expired
+		void tick(List<T>& expired)
+		{
+			m_now++;
+			for (size_t level = INTERNAL::TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+			{
+				if ((m_now & (((uint64_t)1 << (level * INTERNAL::TIMER_WHEEL_SLOT_BITS)) - 1)) == 0)
+				{
+					cascade(level);
+				}
+			}
+
+			Slot& slot = m_slots[0][m_now & INTERNAL::TIMER_WHEEL_SLOT_MASK];
+			while (Timer* timer = slot.popFront())
+			{
+				expired.pushBack(std::move(timer->m_payload));
+				m_timerPool.deallocate(timer);
+				m_length--;
+			}
+		}
+
+		void advance(uint64_t ticks, List<T>& expired)
+		{
+			for (uint64_t i = 0; i < ticks; i++)
+			{
+				tick(expired);
+			}
+		}
+
+		//Drops every pending timer without handing out its payload
+		void clear()
+		{
+			for (size_t level = 0; level < INTERNAL::TIMER_WHEEL_LEVELS; level++)
+			{
+				for (size_t slot = 0; slot < INTERNAL::TIMER_WHEEL_SLOTS; slot++)
+				{
+					while (Timer* timer = m_slots[level][slot].popFront())
+					{
+						m_timerPool.deallocate(timer);
+					}
+				}
+			}
+			m_length = 0;
+		}
+
+		uint64_t getNow() const
+		{
+			return m_now;
+		}
+
+		size_t getLength() const
+		{
+			return m_length;
+		}
+	};
+}
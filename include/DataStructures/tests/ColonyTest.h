@@ -0,0 +1,317 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../Colony.h"
+#include "../List.h"
+#include "../../MemoryManagement/PoolAllocator.h"
+
+namespace bbe
+{
+
+template <typename T>
+static std::vector<T> colonyToSortedVector(Colony<T> &colony)
+{
+    std::vector<T> values;
+    for (T &value : colony)
+    {
+        values.push_back(value);
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+TEST(ColonyTest, InsertEraseIterate)
+{
+    Colony<int> colony;
+    EXPECT_TRUE(colony.isEmpty());
+    EXPECT_TRUE(colony.begin() == colony.end());
+
+    std::vector<int *> pointers;
+    for (int i = 0; i < 1000; i++)
+    {
+        pointers.push_back(&*colony.insert(i));
+    }
+    EXPECT_EQ(colony.getLength(), 1000);
+
+    // Erase every odd element while iterating
+    for (Colony<int>::Iterator it = colony.begin(); it != colony.end();)
+    {
+        if (*it % 2 == 1)
+        {
+            it = colony.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    EXPECT_EQ(colony.getLength(), 500);
+
+    // The addresses of the remaining elements did not change
+    for (int i = 0; i < 1000; i += 2)
+    {
+        EXPECT_EQ(*pointers[i], i);
+    }
+
+    int sum = 0;
+    colony.forEach([&](int &value) { sum += value; });
+    EXPECT_EQ(sum, 249500);
+
+    // Inserts reuse the erased slots instead of growing
+    size_t blocks = colony.getBlockCount();
+    for (int i = 0; i < 500; i++)
+    {
+        colony.insert(-1);
+    }
+    EXPECT_EQ(colony.getBlockCount(), blocks);
+    EXPECT_EQ(colony.getLength(), 1000);
+
+    colony.erase(pointers[0]);
+    EXPECT_EQ(colony.getLength(), 999);
+}
+
+TEST(ColonyTest, RandomChurn)
+{
+    Colony<int> colony;
+    std::vector<int *> live;
+    std::vector<int> reference;
+    std::mt19937 random(5);
+
+    for (int i = 0; i < 30000; i++)
+    {
+        if (live.empty() || random() % 3 != 0)
+        {
+            live.push_back(&*colony.insert(i));
+            reference.push_back(i);
+        }
+        else
+        {
+            size_t index = random() % live.size();
+            reference.erase(std::find(reference.begin(), reference.end(), *live[index]));
+            colony.erase(live[index]);
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+
+    std::sort(reference.begin(), reference.end());
+    EXPECT_EQ(colonyToSortedVector(colony), reference);
+    EXPECT_EQ(colony.getLength(), reference.size());
+
+    // Erasing everything gives all blocks back
+    for (int *value : live)
+    {
+        colony.erase(value);
+    }
+    EXPECT_TRUE(colony.isEmpty());
+    EXPECT_EQ(colony.getBlockCount(), 0);
+    EXPECT_TRUE(colony.begin() == colony.end());
+}
+
+TEST(ColonyTest, DestroysElements)
+{
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    {
+        Colony<std::shared_ptr<int>> colony;
+        std::vector<std::shared_ptr<int> *> pointers;
+        for (int i = 0; i < 100; i++)
+        {
+            pointers.push_back(&*colony.insert(shared));
+        }
+        for (int i = 0; i < 100; i += 3)
+        {
+            colony.erase(pointers[i]);
+        }
+        EXPECT_EQ(shared.use_count(), 67);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+struct ColonyBenchmarkEntity
+{
+    float m_position[3];
+    float m_velocity[3];
+    uint64_t m_id;
+    byte m_payload[32];
+};
+
+// Each round erases a random tenth of the entities and inserts as many new ones, then updates all of them
+template <typename Container>
+static void benchmarkChurn(const char *name, size_t amount, size_t rounds)
+{
+    Container container(amount);
+    std::mt19937 random(42);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < amount; i++)
+    {
+        container.insert(i);
+    }
+    auto insertEnd = std::chrono::steady_clock::now();
+
+    double churnNanoseconds = 0;
+    double iterateNanoseconds = 0;
+    float checksum = 0;
+    for (size_t round = 0; round < rounds; round++)
+    {
+        auto churnStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < amount / 10; i++)
+        {
+            container.eraseRandom(random);
+            container.insert(amount + round * amount + i);
+        }
+        auto iterateStart = std::chrono::steady_clock::now();
+        checksum += container.update();
+        auto iterateEnd = std::chrono::steady_clock::now();
+
+        churnNanoseconds += std::chrono::duration<double, std::nano>(iterateStart - churnStart).count();
+        iterateNanoseconds += std::chrono::duration<double, std::nano>(iterateEnd - iterateStart).count();
+    }
+
+    (void)checksum;
+    GTEST_COUT << name << ", " << amount << " entities: insert " << std::chrono::duration<double, std::nano>(insertEnd - start).count() / amount
+               << "ns, erase + insert " << churnNanoseconds / (rounds * (amount / 10)) << "ns, iterate " << iterateNanoseconds / (rounds * amount) << "ns per entity" << std::endl;
+}
+
+static ColonyBenchmarkEntity makeEntity(size_t id)
+{
+    ColonyBenchmarkEntity entity = {};
+    entity.m_velocity[0] = 1.0f;
+    entity.m_id = id;
+    return entity;
+}
+
+static float updateEntity(ColonyBenchmarkEntity &entity)
+{
+    entity.m_position[0] += entity.m_velocity[0];
+    return entity.m_position[0];
+}
+
+// Erasing needs a handle to a random live entity, so the colony keeps its iterators on the side like a game would
+struct ColonyBenchmarkColony
+{
+    Colony<ColonyBenchmarkEntity> m_colony;
+    std::vector<Colony<ColonyBenchmarkEntity>::Iterator> m_handles;
+
+    explicit ColonyBenchmarkColony(size_t amount)
+    {
+        m_handles.reserve(amount);
+    }
+
+    void insert(size_t id)
+    {
+        m_handles.push_back(m_colony.insert(makeEntity(id)));
+    }
+
+    void eraseRandom(std::mt19937 &random)
+    {
+        size_t index = random() % m_handles.size();
+        m_colony.erase(m_handles[index]);
+        m_handles[index] = m_handles.back();
+        m_handles.pop_back();
+    }
+
+    float update()
+    {
+        float sum = 0;
+        m_colony.forEach([&](ColonyBenchmarkEntity &entity) { sum += updateEntity(entity); });
+        return sum;
+    }
+};
+
+// Erase swaps with the last element, so pointers are not stable
+struct ColonyBenchmarkList
+{
+    List<ColonyBenchmarkEntity> m_list;
+
+    explicit ColonyBenchmarkList(size_t amount)
+    {
+        m_list.resizeCapacity(amount);
+    }
+
+    void insert(size_t id)
+    {
+        m_list.pushBack(makeEntity(id));
+    }
+
+    void eraseRandom(std::mt19937 &random)
+    {
+        size_t index = random() % m_list.getLength();
+        m_list[index] = m_list.last();
+        m_list.popBack();
+    }
+
+    float update()
+    {
+        float sum = 0;
+        ColonyBenchmarkEntity *data = m_list.getRaw();
+        for (size_t i = 0; i < m_list.getLength(); i++)
+        {
+            sum += updateEntity(data[i]);
+        }
+        return sum;
+    }
+};
+
+// Stable pointers from a pool, iterated through an external index of pointers
+struct ColonyBenchmarkPool
+{
+    PoolAllocator<ColonyBenchmarkEntity> m_pool;
+    std::vector<ColonyBenchmarkEntity *> m_index;
+
+    explicit ColonyBenchmarkPool(size_t amount)
+        : m_pool(amount)
+    {
+        m_index.reserve(amount);
+    }
+
+    ~ColonyBenchmarkPool()
+    {
+        for (ColonyBenchmarkEntity *entity : m_index)
+        {
+            m_pool.deallocate(entity);
+        }
+    }
+
+    void insert(size_t id)
+    {
+        m_index.push_back(m_pool.allocate(makeEntity(id)));
+    }
+
+    void eraseRandom(std::mt19937 &random)
+    {
+        size_t index = random() % m_index.size();
+        m_pool.deallocate(m_index[index]);
+        m_index[index] = m_index.back();
+        m_index.pop_back();
+    }
+
+    float update()
+    {
+        float sum = 0;
+        for (ColonyBenchmarkEntity *entity : m_index)
+        {
+            sum += updateEntity(*entity);
+        }
+        return sum;
+    }
+};
+
+TEST(ColonyBenchmark, ChurnAndIteration)
+{
+    for (size_t amount = 10000; amount <= 1000000; amount *= 10)
+    {
+        benchmarkChurn<ColonyBenchmarkColony>("Colony", amount, 20);
+        benchmarkChurn<ColonyBenchmarkList>("List", amount, 20);
+        benchmarkChurn<ColonyBenchmarkPool>("PoolAllocator + index", amount, 20);
+    }
+}
+
+} // namespace bbe
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../DaryHeap.h"
+
+namespace bbe
+{
+
+TEST(DaryHeapTest, PushPop)
+{
+    DaryHeap<int> heap;
+    EXPECT_TRUE(heap.isEmpty());
+
+    for (int value : {5, 3, 9, 1, 7, 3})
+    {
+        heap.push(value);
+    }
+    EXPECT_EQ(heap.getLength(), 6);
+    EXPECT_EQ(heap.top(), 1);
+
+    std::vector<int> popped;
+    while (!heap.isEmpty())
+    {
+        popped.push_back(heap.pop());
+    }
+    EXPECT_EQ(popped, (std::vector<int>{1, 3, 3, 5, 7, 9}));
+
+    // Max heap with a different compare and arity
+    DaryHeap<std::string, std::greater<std::string>, 2> strings;
+    strings.push("b");
+    strings.push("c");
+    strings.push("a");
+    EXPECT_EQ(strings.pop(), "c");
+    EXPECT_EQ(strings.pop(), "b");
+}
+
+TEST(DaryHeapTest, Handles)
+{
+    DaryHeap<int> heap;
+    HeapHandle five = heap.push(5);
+    HeapHandle ten = heap.push(10);
+    HeapHandle twenty = heap.push(20);
+
+    heap.decreaseKey(twenty, 1);
+    EXPECT_EQ(heap.topHandle(), twenty);
+    EXPECT_EQ(heap.get(ten), 10);
+
+    heap.update(twenty, 30);
+    EXPECT_EQ(heap.top(), 5);
+
+    EXPECT_EQ(heap.remove(five), 5);
+    EXPECT_FALSE(heap.contains(five));
+    EXPECT_EQ(heap.top(), 10);
+
+    // Handles are handed out again after pop
+    EXPECT_EQ(heap.pop(), 10);
+    EXPECT_FALSE(heap.contains(ten));
+    HeapHandle reused = heap.push(2);
+    EXPECT_TRUE(reused == ten || reused == five);
+    EXPECT_EQ(heap.top(), 2);
+
+    heap.clear();
+    EXPECT_TRUE(heap.isEmpty());
+    EXPECT_FALSE(heap.contains(twenty));
+}
+
+TEST(DaryHeapTest, ChurnAgainstMultiset)
+{
+    DaryHeap<std::pair<int, int>, std::less<std::pair<int, int>>, 3> heap;
+    std::set<std::pair<int, int>> reference;
+    std::vector<HeapHandle> handles;
+    std::vector<std::pair<int, int>> values;
+    std::mt19937 random(2);
+
+    for (int i = 0; i < 50000; i++)
+    {
+        switch (random() % 4)
+        {
+        case 0:
+        case 1:
+        {
+            std::pair<int, int> value((int)(random() % 1000), i);
+            handles.push_back(heap.push(value));
+            values.push_back(value);
+            reference.insert(value);
+            break;
+        }
+        case 2:
+            if (!reference.empty())
+            {
+                std::pair<int, int> popped = heap.pop();
+                EXPECT_EQ(popped, *reference.begin());
+                reference.erase(reference.begin());
+                for (size_t k = 0; k < values.size(); k++)
+                {
+                    if (values[k] == popped)
+                    {
+                        std::swap(values[k], values.back());
+                        std::swap(handles[k], handles.back());
+                        values.pop_back();
+                        handles.pop_back();
+                        break;
+                    }
+                }
+            }
+            break;
+        case 3:
+            if (!values.empty())
+            {
+                size_t k = random() % values.size();
+                std::pair<int, int> value((int)(random() % 1000), values[k].second);
+                reference.erase(values[k]);
+                reference.insert(value);
+                if (value < values[k])
+                {
+                    heap.decreaseKey(handles[k], value);
+                }
+                else
+                {
+                    heap.update(handles[k], value);
+                }
+                values[k] = value;
+            }
+            break;
+        }
+        ASSERT_EQ(heap.getLength(), reference.size());
+    }
+
+    while (!reference.empty())
+    {
+        ASSERT_EQ(heap.pop(), *reference.begin());
+        reference.erase(reference.begin());
+    }
+}
+
+TEST(DaryHeapBenchmark, AgainstStdPriorityQueue)
+{
+    const size_t AMOUNT = 1000000;
+
+    std::vector<uint32_t> keys(AMOUNT);
+    std::vector<uint32_t> decreases(AMOUNT);
+    std::mt19937 random(6);
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        keys[i] = random() | 0x80000000u;
+        decreases[i] = random() % AMOUNT;
+    }
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    DaryHeap<uint32_t> heap;
+    std::vector<HeapHandle> handles(AMOUNT);
+    auto heapStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        handles[i] = heap.push(keys[i]);
+    }
+    auto heapPushed = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        uint32_t key = decreases[i];
+        if (heap.get(handles[key]) > i)
+        {
+            heap.decreaseKey(handles[key], (uint32_t)i);
+        }
+    }
+    auto heapDecreased = std::chrono::steady_clock::now();
+    uint64_t heapSum = 0;
+    while (!heap.isEmpty())
+    {
+        heapSum += heap.pop();
+    }
+    auto heapEnd = std::chrono::steady_clock::now();
+
+    // Without decrease key the priority queue gets a second entry, the outdated one is skipped when popped
+    typedef std::pair<uint32_t, uint32_t> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    std::vector<uint32_t> current(keys);
+    auto queueStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        queue.push(QueueEntry(keys[i], (uint32_t)i));
+    }
+    auto queuePushed = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        uint32_t key = decreases[i];
+        if (current[key] > i)
+        {
+            current[key] = (uint32_t)i;
+            queue.push(QueueEntry((uint32_t)i, key));
+        }
+    }
+    auto queueDecreased = std::chrono::steady_clock::now();
+    uint64_t queueSum = 0;
+    while (!queue.empty())
+    {
+        QueueEntry entry = queue.top();
+        queue.pop();
+        if (current[entry.second] == entry.first)
+        {
+            queueSum += entry.first;
+        }
+    }
+    auto queueEnd = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(heapSum, queueSum);
+
+    GTEST_COUT << AMOUNT << " elements, DaryHeap / std::priority_queue: push " << ms(heapStart, heapPushed) << "ms / " << ms(queueStart, queuePushed)
+               << "ms, decrease key " << ms(heapPushed, heapDecreased) << "ms / " << ms(queuePushed, queueDecreased) << "ms, pop all "
+               << ms(heapDecreased, heapEnd) << "ms / " << ms(queueDecreased, queueEnd) << "ms" << std::endl;
+}
+
+} // namespace bbe
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../HashMap.h"
+
+namespace bbe
+{
+
+TEST(HashMapTest, AddGetRemove)
+{
+    HashMap<std::string, int> map;
+    EXPECT_EQ(map.get("missing"), nullptr);
+    EXPECT_FALSE(map.remove("missing"));
+
+    EXPECT_TRUE(map.add("one", 1));
+    EXPECT_TRUE(map.add("two", 2));
+    EXPECT_FALSE(map.add("one", 100));
+    EXPECT_EQ(map.getLength(), 2);
+    EXPECT_EQ(*map.get("one"), 1);
+
+    map["three"] = 3;
+    map["one"] += 10;
+    EXPECT_EQ(*map.get("one"), 11);
+    EXPECT_EQ(*map.get("three"), 3);
+
+    EXPECT_TRUE(map.remove("two"));
+    EXPECT_FALSE(map.contains("two"));
+    EXPECT_TRUE(map.contains("three"));
+    EXPECT_EQ(map.getLength(), 2);
+
+    int sum = 0;
+    map.forEach([&](const std::string &, int &value) { sum += value; });
+    EXPECT_EQ(sum, 14);
+
+    map.clear();
+    EXPECT_EQ(map.getLength(), 0);
+    EXPECT_FALSE(map.contains("one"));
+}
+
+TEST(HashMapTest, ChurnAgainstUnorderedMap)
+{
+    HashMap<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> reference;
+    std::mt19937_64 random(7);
+
+    // Keys from a small range, so adds, overwrites and removes hit the same slots over and over
+    for (size_t i = 0; i < 200000; i++)
+    {
+        uint64_t key = random() % 5000;
+        switch (random() % 3)
+        {
+        case 0:
+            EXPECT_EQ(map.add(key, i), reference.emplace(key, i).second);
+            break;
+        case 1:
+            map[key] = i;
+            reference[key] = i;
+            break;
+        case 2:
+            EXPECT_EQ(map.remove(key), reference.erase(key) == 1);
+            break;
+        }
+    }
+
+    ASSERT_EQ(map.getLength(), reference.size());
+    for (const auto &entry : reference)
+    {
+        uint64_t *value = map.get(entry.first);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, entry.second);
+    }
+
+    // Tombstones must not make the table grow forever
+    EXPECT_LE(map.getCapacity(), 16384);
+}
+
+TEST(HashMapTest, DestroysValues)
+{
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    {
+        HashMap<int, std::shared_ptr<int>> map;
+        for (int i = 0; i < 1000; i++)
+        {
+            map.add(i, shared);
+        }
+        for (int i = 0; i < 500; i++)
+        {
+            map.remove(i);
+        }
+        EXPECT_EQ(shared.use_count(), 501);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+template <typename Map>
+static void benchmarkMap(const char *name, const std::vector<uint64_t> &keys, const std::vector<uint64_t> &misses)
+{
+    Map map;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        map[keys[i]] = i;
+    }
+    auto insertEnd = std::chrono::steady_clock::now();
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        sum += map[keys[i]];
+    }
+    auto hitEnd = std::chrono::steady_clock::now();
+
+    size_t found = 0;
+    for (size_t i = 0; i < misses.size(); i++)
+    {
+        found += map.count(misses[i]);
+    }
+    auto missEnd = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        map.erase(keys[i]);
+    }
+    auto eraseEnd = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(sum, (uint64_t)keys.size() * (keys.size() - 1) / 2);
+    EXPECT_EQ(found, 0);
+
+    auto ns = [&](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / keys.size();
+    };
+    GTEST_COUT << name << ", " << keys.size() << " entries: insert " << ns(start, insertEnd) << "ns, hit " << ns(insertEnd, hitEnd)
+               << "ns, miss " << ns(hitEnd, missEnd) << "ns, erase " << ns(missEnd, eraseEnd) << "ns" << std::endl;
+}
+
+// Gives HashMap the interface of std::unordered_map which the benchmark uses
+struct BenchmarkHashMap : public HashMap<uint64_t, uint64_t>
+{
+    size_t count(uint64_t key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    size_t erase(uint64_t key)
+    {
+        return remove(key) ? 1 : 0;
+    }
+};
+
+TEST(HashMapBenchmark, AgainstUnorderedMap)
+{
+    std::mt19937_64 random(42);
+
+    for (size_t amount = 1000; amount <= 10000000; amount *= 10)
+    {
+        std::vector<uint64_t> keys;
+        std::vector<uint64_t> misses;
+        for (size_t i = 0; i < amount; i++)
+        {
+            // Odd keys are inserted, even keys are guaranteed misses
+            keys.push_back(random() | 1);
+            misses.push_back(random() & ~(uint64_t)1);
+        }
+
+        benchmarkMap<BenchmarkHashMap>("bbe::HashMap", keys, misses);
+        benchmarkMap<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", keys, misses);
+    }
+}
+
+} // namespace bbe
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "../IntrusiveList.h"
+#include "../../MemoryManagement/PoolAllocator.h"
+
+namespace bbe
+{
+
+struct IntrusiveListTestAliveTag;
+struct IntrusiveListTestDirtyTag;
+
+struct IntrusiveListTestObject : IntrusiveListNode<IntrusiveListTestAliveTag>, IntrusiveListNode<IntrusiveListTestDirtyTag>
+{
+    int m_value;
+
+    explicit IntrusiveListTestObject(int value)
+        : m_value(value)
+    {
+    }
+};
+
+typedef IntrusiveList<IntrusiveListTestObject, IntrusiveListTestAliveTag> AliveList;
+typedef IntrusiveList<IntrusiveListTestObject, IntrusiveListTestDirtyTag> DirtyList;
+
+template <typename List>
+static std::vector<int> intrusiveListToVector(List &list)
+{
+    std::vector<int> values;
+    for (IntrusiveListTestObject &object : list)
+    {
+        values.push_back(object.m_value);
+    }
+    return values;
+}
+
+TEST(IntrusiveListTest, LinkAndUnlink)
+{
+    IntrusiveListTestObject a(1), b(2), c(3), d(4);
+    AliveList list;
+    EXPECT_TRUE(list.isEmpty());
+    EXPECT_EQ(list.first(), nullptr);
+
+    EXPECT_TRUE(list.pushBack(b));
+    EXPECT_TRUE(list.pushFront(a));
+    EXPECT_TRUE(list.pushBack(d));
+    EXPECT_TRUE(list.insertBefore(d, c));
+    EXPECT_EQ(list.getLength(), 4);
+    EXPECT_EQ(intrusiveListToVector(list), (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_EQ(list.next(c), &d);
+    EXPECT_EQ(list.next(d), nullptr);
+    EXPECT_EQ(list.prev(a), nullptr);
+
+    list.remove(b);
+    EXPECT_FALSE(b.IntrusiveListNode<IntrusiveListTestAliveTag>::isLinked());
+    EXPECT_EQ(intrusiveListToVector(list), (std::vector<int>{1, 3, 4}));
+
+    EXPECT_EQ(list.popFront(), &a);
+    EXPECT_EQ(list.popBack(), &d);
+    EXPECT_EQ(list.first(), &c);
+    EXPECT_EQ(list.last(), &c);
+
+    list.insertAfter(c, b);
+    EXPECT_EQ(intrusiveListToVector(list), (std::vector<int>{3, 2}));
+    list.clear();
+    EXPECT_TRUE(list.isEmpty());
+    EXPECT_FALSE(c.IntrusiveListNode<IntrusiveListTestAliveTag>::isLinked());
+}
+
+TEST(IntrusiveListTest, ObjectInTwoLists)
+{
+    IntrusiveListTestObject a(1), b(2), c(3);
+    AliveList alive;
+    DirtyList dirty;
+
+    alive.pushBack(a);
+    alive.pushBack(b);
+    alive.pushBack(c);
+    dirty.pushBack(c);
+    dirty.pushBack(a);
+
+    alive.remove(a);
+    EXPECT_EQ(intrusiveListToVector(alive), (std::vector<int>{2, 3}));
+    EXPECT_EQ(intrusiveListToVector(dirty), (std::vector<int>{3, 1}));
+
+    // A copy is not linked anywhere
+    IntrusiveListTestObject copy(c);
+    EXPECT_FALSE(copy.IntrusiveListNode<IntrusiveListTestDirtyTag>::isLinked());
+    EXPECT_TRUE(dirty.pushBack(copy));
+    EXPECT_EQ(dirty.getLength(), 3);
+
+    alive.clear();
+    dirty.clear();
+}
+
+TEST(IntrusiveListBenchmark, AgainstStdList)
+{
+    const int AMOUNT = 1000000;
+
+    std::vector<int> removeOrder(AMOUNT);
+    for (int i = 0; i < AMOUNT; i++)
+    {
+        removeOrder[i] = i;
+    }
+    std::shuffle(removeOrder.begin(), removeOrder.end(), std::mt19937(1));
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    PoolAllocator<IntrusiveListTestObject> pool(AMOUNT);
+    std::vector<IntrusiveListTestObject *> objects(AMOUNT);
+    AliveList intrusive;
+
+    auto intrusiveStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < AMOUNT; i++)
+    {
+        objects[i] = pool.allocate(i);
+        intrusive.pushBack(*objects[i]);
+    }
+    auto intrusivePushed = std::chrono::steady_clock::now();
+    long long intrusiveSum = 0;
+    for (IntrusiveListTestObject &object : intrusive)
+    {
+        intrusiveSum += object.m_value;
+    }
+    auto intrusiveIterated = std::chrono::steady_clock::now();
+    for (int index : removeOrder)
+    {
+        intrusive.remove(*objects[index]);
+        pool.deallocate(objects[index]);
+    }
+    auto intrusiveEnd = std::chrono::steady_clock::now();
+
+    std::list<IntrusiveListTestObject> list;
+    std::vector<std::list<IntrusiveListTestObject>::iterator> iterators(AMOUNT);
+
+    auto listStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < AMOUNT; i++)
+    {
+        iterators[i] = list.emplace(list.end(), i);
+    }
+    auto listPushed = std::chrono::steady_clock::now();
+    long long listSum = 0;
+    for (IntrusiveListTestObject &object : list)
+    {
+        listSum += object.m_value;
+    }
+    auto listIterated = std::chrono::steady_clock::now();
+    for (int index : removeOrder)
+    {
+        list.erase(iterators[index]);
+    }
+    auto listEnd = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(intrusiveSum, listSum);
+    EXPECT_TRUE(intrusive.isEmpty());
+
+    GTEST_COUT << AMOUNT << " objects, IntrusiveList+PoolAllocator / std::list: push " << ms(intrusiveStart, intrusivePushed) << "ms / "
+               << ms(listStart, listPushed) << "ms, iterate " << ms(intrusivePushed, intrusiveIterated) << "ms / " << ms(listPushed, listIterated)
+               << "ms, random remove " << ms(intrusiveIterated, intrusiveEnd) << "ms / " << ms(listIterated, listEnd) << "ms" << std::endl;
+}
+
+} // namespace bbe
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../IntrusiveTree.h"
+#include "../../MemoryManagement/PoolAllocator.h"
+
+namespace bbe
+{
+
+struct IntrusiveTreeTestObject : IntrusiveTreeNode<>
+{
+    uint32_t m_key;
+
+    explicit IntrusiveTreeTestObject(uint32_t key)
+        : m_key(key)
+    {
+    }
+};
+
+struct IntrusiveTreeTestCompare
+{
+    bool operator()(const IntrusiveTreeTestObject &a, const IntrusiveTreeTestObject &b) const
+    {
+        return a.m_key < b.m_key;
+    }
+
+    bool operator()(uint32_t key, const IntrusiveTreeTestObject &b) const
+    {
+        return key < b.m_key;
+    }
+
+    bool operator()(const IntrusiveTreeTestObject &a, uint32_t key) const
+    {
+        return a.m_key < key;
+    }
+};
+
+typedef IntrusiveTree<IntrusiveTreeTestObject, IntrusiveTreeTestCompare> TestTree;
+
+TEST(IntrusiveTreeTest, InsertFindRemove)
+{
+    IntrusiveTreeTestObject a(10), b(20), c(30), duplicate(20);
+    TestTree tree;
+    EXPECT_EQ(tree.first(), nullptr);
+
+    EXPECT_TRUE(tree.insert(b));
+    EXPECT_TRUE(tree.insert(c));
+    EXPECT_TRUE(tree.insert(a));
+    EXPECT_FALSE(tree.insert(duplicate));
+    EXPECT_FALSE(duplicate.isLinked());
+    EXPECT_EQ(tree.getLength(), 3);
+    EXPECT_TRUE(tree.isValid());
+
+    EXPECT_EQ(tree.find(20u), &b);
+    EXPECT_EQ(tree.find(25u), nullptr);
+    EXPECT_EQ(tree.lowerBound(11u), &b);
+    EXPECT_EQ(tree.lowerBound(31u), nullptr);
+    EXPECT_EQ(tree.first(), &a);
+    EXPECT_EQ(tree.last(), &c);
+    EXPECT_EQ(tree.next(a), &b);
+    EXPECT_EQ(tree.prev(a), nullptr);
+
+    tree.remove(b);
+    EXPECT_FALSE(b.isLinked());
+    EXPECT_EQ(tree.find(20u), nullptr);
+    EXPECT_TRUE(tree.insert(duplicate));
+    EXPECT_TRUE(tree.isValid());
+
+    tree.clear();
+    EXPECT_TRUE(tree.isEmpty());
+    EXPECT_FALSE(a.isLinked());
+    EXPECT_FALSE(duplicate.isLinked());
+}
+
+TEST(IntrusiveTreeTest, ChurnAgainstStdSet)
+{
+    const uint32_t KEYS = 2000;
+    std::vector<IntrusiveTreeTestObject> objects;
+    for (uint32_t i = 0; i < KEYS; i++)
+    {
+        objects.emplace_back(i);
+    }
+
+    TestTree tree;
+    std::set<uint32_t> reference;
+    std::mt19937 random(9);
+
+    for (int i = 0; i < 50000; i++)
+    {
+        uint32_t key = random() % KEYS;
+        if (objects[key].isLinked())
+        {
+            tree.remove(objects[key]);
+            reference.erase(key);
+        }
+        else
+        {
+            EXPECT_TRUE(tree.insert(objects[key]));
+            reference.insert(key);
+        }
+
+        if (i % 1000 == 0)
+        {
+            ASSERT_TRUE(tree.isValid());
+        }
+    }
+
+    ASSERT_TRUE(tree.isValid());
+    ASSERT_EQ(tree.getLength(), reference.size());
+    std::vector<uint32_t> inOrder;
+    for (IntrusiveTreeTestObject &object : tree)
+    {
+        inOrder.push_back(object.m_key);
+    }
+    EXPECT_EQ(inOrder, std::vector<uint32_t>(reference.begin(), reference.end()));
+
+    tree.clear();
+}
+
+TEST(IntrusiveTreeBenchmark, AgainstStdSet)
+{
+    const uint32_t AMOUNT = 1000000;
+
+    std::vector<uint32_t> keys(AMOUNT);
+    std::mt19937 random(4);
+    for (uint32_t &key : keys)
+    {
+        key = random();
+    }
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    PoolAllocator<IntrusiveTreeTestObject> pool(AMOUNT);
+    std::vector<IntrusiveTreeTestObject *> objects(AMOUNT);
+    TestTree tree;
+
+    auto treeStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < AMOUNT; i++)
+    {
+        objects[i] = pool.allocate(keys[i]);
+        if (!tree.insert(*objects[i]))
+        {
+            pool.deallocate(objects[i]);
+            objects[i] = nullptr;
+        }
+    }
+    auto treeInserted = std::chrono::steady_clock::now();
+    size_t treeFound = 0;
+    for (uint32_t key : keys)
+    {
+        treeFound += tree.find(key ^ 1) != nullptr;
+    }
+    auto treeFoundEnd = std::chrono::steady_clock::now();
+    for (IntrusiveTreeTestObject *object : objects)
+    {
+        if (object != nullptr)
+        {
+            tree.remove(*object);
+            pool.deallocate(object);
+        }
+    }
+    auto treeEnd = std::chrono::steady_clock::now();
+
+    std::set<uint32_t> set;
+    auto setStart = std::chrono::steady_clock::now();
+    for (uint32_t key : keys)
+    {
+        set.insert(key);
+    }
+    auto setInserted = std::chrono::steady_clock::now();
+    size_t setFound = 0;
+    for (uint32_t key : keys)
+    {
+        setFound += set.find(key ^ 1) != set.end();
+    }
+    auto setFoundEnd = std::chrono::steady_clock::now();
+    for (uint32_t key : keys)
+    {
+        set.erase(key);
+    }
+    auto setEnd = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(treeFound, setFound);
+    EXPECT_TRUE(tree.isEmpty());
+    EXPECT_TRUE(set.empty());
+
+    GTEST_COUT << AMOUNT << " random keys, IntrusiveTree+PoolAllocator / std::set: insert " << ms(treeStart, treeInserted) << "ms / "
+               << ms(setStart, setInserted) << "ms, find " << ms(treeInserted, treeFoundEnd) << "ms / " << ms(setInserted, setFoundEnd)
+               << "ms, remove " << ms(treeFoundEnd, treeEnd) << "ms / " << ms(setFoundEnd, setEnd) << "ms" << std::endl;
+}
+
+} // namespace bbe
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../List.h"
+#include "../RadixSort.h"
+
+namespace bbe
+{
+
+TEST(RadixSortTest, SortsIntegralKeys)
+{
+    StackAllocator scratch(1024 * 1024);
+    std::mt19937_64 random(1);
+
+    List<int32_t> signedList;
+    List<uint64_t> unsignedList;
+    for (size_t i = 0; i < 10000; i++)
+    {
+        signedList.pushBack((int32_t)random());
+        unsignedList.pushBack(random());
+    }
+    signedList.pushBack(std::numeric_limits<int32_t>::min());
+    signedList.pushBack(std::numeric_limits<int32_t>::max());
+    signedList.pushBack(0);
+    signedList.pushBack(-1);
+
+    signedList.sort(scratch);
+    unsignedList.sort(scratch);
+
+    EXPECT_TRUE(std::is_sorted(signedList.getRaw(), signedList.getRaw() + signedList.getLength()));
+    EXPECT_TRUE(std::is_sorted(unsignedList.getRaw(), unsignedList.getRaw() + unsignedList.getLength()));
+    EXPECT_EQ(signedList[0], std::numeric_limits<int32_t>::min());
+    EXPECT_EQ(signedList.last(), std::numeric_limits<int32_t>::max());
+}
+
+TEST(RadixSortTest, SortsFloatKeys)
+{
+    StackAllocator scratch(1024 * 1024);
+    std::mt19937 random(2);
+    std::uniform_real_distribution<float> floatDistribution(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<double> doubleDistribution(-1e100, 1e100);
+
+    List<float> floats = {0.0f, -0.0f, 1.0f, -1.0f, std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                          std::numeric_limits<float>::denorm_min(), -std::numeric_limits<float>::denorm_min()};
+    List<double> doubles;
+    for (size_t i = 0; i < 10000; i++)
+    {
+        floats.pushBack(floatDistribution(random));
+        doubles.pushBack(doubleDistribution(random));
+    }
+
+    floats.sort(scratch);
+    doubles.sort(scratch);
+
+    EXPECT_TRUE(std::is_sorted(floats.getRaw(), floats.getRaw() + floats.getLength()));
+    EXPECT_TRUE(std::is_sorted(doubles.getRaw(), doubles.getRaw() + doubles.getLength()));
+    EXPECT_EQ(floats[0], -std::numeric_limits<float>::infinity());
+    EXPECT_EQ(floats.last(), std::numeric_limits<float>::infinity());
+}
+
+TEST(RadixSortTest, KeyValuePairsAreStable)
+{
+    struct DrawCall
+    {
+        uint32_t m_sortKey;
+        uint32_t m_index;
+    };
+
+    StackAllocator scratch(1024 * 1024);
+    std::mt19937 random(3);
+
+    List<DrawCall> drawCalls;
+    std::vector<uint16_t> keys;
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        drawCalls.pushBack(DrawCall{(uint32_t)(random() % 100), i});
+        keys.push_back((uint16_t)(random() % 100));
+        values.push_back(i);
+    }
+
+    drawCalls.sort(scratch, [](const DrawCall &drawCall) { return drawCall.m_sortKey; });
+    radixSort(keys.data(), values.data(), keys.size(), scratch);
+
+    for (size_t i = 1; i < drawCalls.getLength(); i++)
+    {
+        ASSERT_LE(drawCalls[i - 1].m_sortKey, drawCalls[i].m_sortKey);
+        if (drawCalls[i - 1].m_sortKey == drawCalls[i].m_sortKey)
+        {
+            ASSERT_LT(drawCalls[i - 1].m_index, drawCalls[i].m_index);
+        }
+
+        ASSERT_LE(keys[i - 1], keys[i]);
+        if (keys[i - 1] == keys[i])
+        {
+            ASSERT_LT(values[i - 1], values[i]);
+        }
+    }
+}
+
+TEST(RadixSortTest, ReturnsScratchMemory)
+{
+    StackAllocator scratch(1024);
+    StackAllocatorMarker before = scratch.getMarker();
+
+    List<uint32_t> list = {5, 3, 9, 1};
+    list.sort(scratch);
+    EXPECT_EQ(scratch.getMarker().m_markerValue, before.m_markerValue);
+
+    // Too large for the scratch arena, falls back to a comparison sort
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        list.pushBack(1000 - i);
+    }
+    list.sort(scratch);
+    EXPECT_TRUE(std::is_sorted(list.getRaw(), list.getRaw() + list.getLength()));
+    EXPECT_EQ(scratch.getMarker().m_markerValue, before.m_markerValue);
+}
+
+TEST(RadixSortTest, KeyValuePairsWithoutEnoughScratch)
+{
+    StackAllocator scratch(64);
+    StackAllocatorMarker before = scratch.getMarker();
+    std::mt19937 random(5);
+
+    std::vector<uint16_t> keys;
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        keys.push_back((uint16_t)(random() % 100));
+        values.push_back(i);
+    }
+
+    radixSort(keys.data(), values.data(), keys.size(), scratch);
+
+    for (size_t i = 1; i < keys.size(); i++)
+    {
+        ASSERT_LE(keys[i - 1], keys[i]);
+        if (keys[i - 1] == keys[i])
+        {
+            ASSERT_LT(values[i - 1], values[i]);
+        }
+    }
+    EXPECT_EQ(scratch.getMarker().m_markerValue, before.m_markerValue);
+}
+
+template <typename T, typename Generate>
+static void benchmarkRadixSort(const char *name, Generate generate)
+{
+    std::mt19937_64 random(42);
+
+    for (size_t length = 1024 * 1024; length <= 16 * 1024 * 1024; length *= 4)
+    {
+        StackAllocator scratch(length * sizeof(T) + 64);
+        List<T> radixList;
+        radixList.resizeCapacity(length);
+        for (size_t i = 0; i < length; i++)
+        {
+            radixList.pushBack(generate(random));
+        }
+        List<T> comparisonList = radixList;
+
+        auto start = std::chrono::steady_clock::now();
+        radixList.sort(scratch);
+        auto radixEnd = std::chrono::steady_clock::now();
+        std::sort(comparisonList.getRaw(), comparisonList.getRaw() + comparisonList.getLength());
+        auto comparisonEnd = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < length; i++)
+        {
+            ASSERT_EQ(radixList[i], comparisonList[i]);
+        }
+
+        GTEST_COUT << name << ", " << length << " keys: radix " << std::chrono::duration<double, std::milli>(radixEnd - start).count()
+                   << "ms, comparison " << std::chrono::duration<double, std::milli>(comparisonEnd - radixEnd).count() << "ms" << std::endl;
+    }
+}
+
+TEST(RadixSortBenchmark, AgainstComparisonSort)
+{
+    benchmarkRadixSort<uint32_t>("uint32_t", [](std::mt19937_64 &random) { return (uint32_t)random(); });
+    benchmarkRadixSort<uint64_t>("uint64_t", [](std::mt19937_64 &random) { return (uint64_t)random(); });
+    benchmarkRadixSort<float>("float", [](std::mt19937_64 &random) { return (float)((int64_t)random() % 1000000) * 0.01f; });
+}
+
+} // namespace bbe
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../RingBuffer.h"
+
+namespace bbe
+{
+
+TEST(RingBufferTest, SpscFifoAndFull)
+{
+    SpscRingBuffer<int> queue(5);
+    EXPECT_EQ(queue.getCapacity(), 8);
+
+    int value;
+    EXPECT_FALSE(queue.tryPop(value));
+
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            EXPECT_TRUE(queue.tryPush(round * 8 + i));
+        }
+        EXPECT_FALSE(queue.tryPush(-1));
+        EXPECT_EQ(queue.getLength(), 8);
+
+        for (int i = 0; i < 8; i++)
+        {
+            ASSERT_TRUE(queue.tryPop(value));
+            EXPECT_EQ(value, round * 8 + i);
+        }
+        EXPECT_FALSE(queue.tryPop(value));
+    }
+}
+
+TEST(RingBufferTest, MpmcFifoAndFull)
+{
+    MpmcRingBuffer<int> queue(4);
+    EXPECT_EQ(queue.getCapacity(), 4);
+
+    int value;
+    EXPECT_FALSE(queue.tryPop(value));
+
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            EXPECT_TRUE(queue.tryPush(round * 4 + i));
+        }
+        EXPECT_FALSE(queue.tryPush(-1));
+
+        for (int i = 0; i < 4; i++)
+        {
+            ASSERT_TRUE(queue.tryPop(value));
+            EXPECT_EQ(value, round * 4 + i);
+        }
+        EXPECT_FALSE(queue.tryPop(value));
+    }
+}
+
+TEST(RingBufferTest, DestroysRemainingElements)
+{
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    {
+        SpscRingBuffer<std::shared_ptr<int>> spsc(8);
+        MpmcRingBuffer<std::shared_ptr<int>> mpmc(8);
+        for (int i = 0; i < 5; i++)
+        {
+            spsc.tryPush(shared);
+            mpmc.tryPush(shared);
+        }
+
+        std::shared_ptr<int> out;
+        spsc.tryPop(out);
+        mpmc.tryPop(out);
+        EXPECT_EQ(shared.use_count(), 10);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(RingBufferTest, SpscAcrossThreads)
+{
+    const size_t AMOUNT = 200000;
+    SpscRingBuffer<size_t> queue(256);
+
+    std::thread producer([&]() {
+        for (size_t i = 0; i < AMOUNT; i++)
+        {
+            while (!queue.tryPush(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        size_t value;
+        while (!queue.tryPop(value))
+        {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(value, i);
+    }
+    producer.join();
+}
+
+TEST(RingBufferTest, MpmcAcrossThreads)
+{
+    const size_t THREADS = 3;
+    const size_t AMOUNT_PER_PRODUCER = 50000;
+    MpmcRingBuffer<size_t> queue(64);
+    std::atomic<size_t> consumed(0);
+    std::vector<size_t> sums(THREADS, 0);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < THREADS; t++)
+    {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < AMOUNT_PER_PRODUCER; i++)
+            {
+                while (!queue.tryPush(i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&, t]() {
+            size_t value;
+            while (consumed.load() < THREADS * AMOUNT_PER_PRODUCER)
+            {
+                if (queue.tryPop(value))
+                {
+                    sums[t] += value;
+                    consumed++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    size_t sum = 0;
+    for (size_t t = 0; t < THREADS; t++)
+    {
+        sum += sums[t];
+    }
+    EXPECT_EQ(sum, THREADS * AMOUNT_PER_PRODUCER * (AMOUNT_PER_PRODUCER - 1) / 2);
+}
+
+// Reference for the benchmark
+template <typename T>
+class MutexQueue
+{
+private:
+    std::mutex m_mutex;
+    std::deque<T> m_queue;
+    size_t m_capacity;
+
+public:
+    explicit MutexQueue(size_t capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    bool tryPush(const T &value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.size() == m_capacity)
+        {
+            return false;
+        }
+        m_queue.push_back(value);
+        return true;
+    }
+
+    bool tryPop(T &out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty())
+        {
+            return false;
+        }
+        out = m_queue.front();
+        m_queue.pop_front();
+        return true;
+    }
+};
+
+template <typename Queue>
+static double benchmarkThroughput(size_t amount)
+{
+    Queue queue(1024);
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        for (size_t i = 0; i < amount; i++)
+        {
+            while (!queue.tryPush(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    size_t value;
+    for (size_t i = 0; i < amount; i++)
+    {
+        while (!queue.tryPop(value))
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return amount / seconds / 1000000.0;
+}
+
+// Round trip of one element through two queues, the other thread echoes it back
+template <typename Queue>
+static double benchmarkLatency(size_t amount)
+{
+    Queue request(16);
+    Queue response(16);
+
+    std::thread echo([&]() {
+        size_t value;
+        for (size_t i = 0; i < amount; i++)
+        {
+            while (!request.tryPop(value))
+            {
+                std::this_thread::yield();
+            }
+            while (!response.tryPush(value))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    size_t value;
+    for (size_t i = 0; i < amount; i++)
+    {
+        while (!request.tryPush(i))
+        {
+            std::this_thread::yield();
+        }
+        while (!response.tryPop(value))
+        {
+            std::this_thread::yield();
+        }
+    }
+    double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    echo.join();
+
+    return nanoseconds / amount;
+}
+
+TEST(RingBufferBenchmark, TwoThreads)
+{
+    const size_t AMOUNT = 10000000;
+    const size_t ROUND_TRIPS = 100000;
+
+    GTEST_COUT << "Throughput SPSC: " << benchmarkThroughput<SpscRingBuffer<size_t>>(AMOUNT) << "M/s" << std::endl;
+    GTEST_COUT << "Throughput MPMC: " << benchmarkThroughput<MpmcRingBuffer<size_t>>(AMOUNT) << "M/s" << std::endl;
+    GTEST_COUT << "Throughput mutex + deque: " << benchmarkThroughput<MutexQueue<size_t>>(AMOUNT) << "M/s" << std::endl;
+
+    GTEST_COUT << "Round trip SPSC: " << benchmarkLatency<SpscRingBuffer<size_t>>(ROUND_TRIPS) << "ns" << std::endl;
+    GTEST_COUT << "Round trip MPMC: " << benchmarkLatency<MpmcRingBuffer<size_t>>(ROUND_TRIPS) << "ns" << std::endl;
+    GTEST_COUT << "Round trip mutex + deque: " << benchmarkLatency<MutexQueue<size_t>>(ROUND_TRIPS) << "ns" << std::endl;
+}
+
+} // namespace bbe
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "../List.h"
+#include "../SoAList.h"
+
+namespace bbe
+{
+
+TEST(SoAListTest, PushAndRemoveSwap)
+{
+    SoAList<int, std::string, double> list;
+    EXPECT_TRUE(list.isEmpty());
+
+    for (int i = 0; i < 100; i++)
+    {
+        list.pushBack(i, std::to_string(i) + " is too long for the small string buffer", i * 0.5);
+    }
+    EXPECT_EQ(list.getLength(), 100);
+    EXPECT_GE(list.getCapacity(), 100);
+    EXPECT_EQ(list.get<1>(42), "42 is too long for the small string buffer");
+
+    // The last row fills the gap
+    EXPECT_TRUE(list.removeIndexSwap(10));
+    EXPECT_EQ(list.getLength(), 99);
+    EXPECT_EQ(list.get<0>(10), 99);
+    EXPECT_EQ(list.get<1>(10), "99 is too long for the small string buffer");
+    EXPECT_EQ(list.get<2>(10), 49.5);
+
+    EXPECT_TRUE(list.removeIndexSwap(98));
+    EXPECT_EQ(list.getLength(), 98);
+    EXPECT_FALSE(list.removeIndexSwap(98));
+
+    list.popBack(8);
+    EXPECT_EQ(list.getLength(), 90);
+
+    int sum = 0;
+    for (int value : list.getField<0>())
+    {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 89 * 90 / 2 - 10 + 99);
+
+    list.clear();
+    EXPECT_TRUE(list.isEmpty());
+}
+
+TEST(SoAListTest, FieldsAreAligned)
+{
+    SoAList<uint8_t, uint64_t, float> list;
+    for (int i = 0; i < 1000; i++)
+    {
+        list.pushBack((uint8_t)i, (uint64_t)i, (float)i);
+        EXPECT_EQ((size_t)list.getField<0>().getRaw() % 64, 0);
+        EXPECT_EQ((size_t)list.getField<1>().getRaw() % 64, 0);
+        EXPECT_EQ((size_t)list.getField<2>().getRaw() % 64, 0);
+    }
+
+    // Growing kept every value
+    Span<float> floats = list.getField<2>();
+    EXPECT_EQ(floats.getLength(), 1000);
+    for (size_t i = 0; i < floats.getLength(); i++)
+    {
+        ASSERT_EQ(floats[i], (float)i);
+        ASSERT_EQ(list.get<0>(i), (uint8_t)i);
+    }
+}
+
+TEST(SoAListTest, DestroysFields)
+{
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    {
+        SoAList<std::shared_ptr<int>, int> list;
+        for (int i = 0; i < 50; i++)
+        {
+            list.pushBack(shared, i);
+        }
+        list.removeIndexSwap(0);
+        list.popBack(4);
+        EXPECT_EQ(shared.use_count(), 46);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+struct BenchmarkParticle
+{
+    float m_positionX, m_positionY, m_positionZ;
+    float m_velocityX, m_velocityY, m_velocityZ;
+    float m_lifetime;
+    uint32_t m_color;
+    float m_size;
+    float m_rotation;
+    uint32_t m_textureIndex;
+    uint32_t m_flags;
+};
+
+TEST(SoAListBenchmark, ParticleUpdate)
+{
+    const size_t AMOUNT = 1000000;
+    const size_t FRAMES = 20;
+    const float DELTA = 1.0f / 60.0f;
+
+    List<BenchmarkParticle> aos;
+    SoAList<float, float, float, float, float, float, float, uint32_t, float, float, uint32_t, uint32_t> soa;
+    aos.resizeCapacity(AMOUNT);
+    soa.resizeCapacity(AMOUNT);
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        aos.pushBack(BenchmarkParticle{0, 0, 0, 1, 2, 3, 10, 0xFFFFFFFF, 1, 0, 0, 0});
+        soa.pushBack(0.f, 0.f, 0.f, 1.f, 2.f, 3.f, 10.f, 0xFFFFFFFFu, 1.f, 0.f, 0u, 0u);
+    }
+
+    auto aosStart = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < FRAMES; frame++)
+    {
+        BenchmarkParticle *particles = aos.getRaw();
+        for (size_t i = 0; i < AMOUNT; i++)
+        {
+            particles[i].m_velocityY -= 9.81f * DELTA;
+            particles[i].m_positionX += particles[i].m_velocityX * DELTA;
+            particles[i].m_positionY += particles[i].m_velocityY * DELTA;
+            particles[i].m_positionZ += particles[i].m_velocityZ * DELTA;
+            particles[i].m_lifetime -= DELTA;
+        }
+    }
+    auto aosEnd = std::chrono::steady_clock::now();
+
+    auto soaStart = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < FRAMES; frame++)
+    {
+        float *positionX = soa.getField<0>().getRaw();
+        float *positionY = soa.getField<1>().getRaw();
+        float *positionZ = soa.getField<2>().getRaw();
+        float *velocityX = soa.getField<3>().getRaw();
+        float *velocityY = soa.getField<4>().getRaw();
+        float *velocityZ = soa.getField<5>().getRaw();
+        float *lifetime = soa.getField<6>().getRaw();
+        for (size_t i = 0; i < AMOUNT; i++)
+        {
+            velocityY[i] -= 9.81f * DELTA;
+            positionX[i] += velocityX[i] * DELTA;
+            positionY[i] += velocityY[i] * DELTA;
+            positionZ[i] += velocityZ[i] * DELTA;
+            lifetime[i] -= DELTA;
+        }
+    }
+    auto soaEnd = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(aos[AMOUNT - 1].m_positionY, soa.get<1>(AMOUNT - 1));
+    EXPECT_EQ(aos[0].m_lifetime, soa.get<6>(0));
+
+    GTEST_COUT << AMOUNT << " particles, " << FRAMES << " frames: List " << std::chrono::duration<double, std::milli>(aosEnd - aosStart).count()
+               << "ms, SoAList " << std::chrono::duration<double, std::milli>(soaEnd - soaStart).count() << "ms" << std::endl;
+}
+
+} // namespace bbe
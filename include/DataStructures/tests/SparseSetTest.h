@@ -0,0 +1,168 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "../SparseSet.h"
+
+namespace bbe
+{
+
+TEST(SparseSetTest, AddGetRemove)
+{
+    SparseSet<int> set;
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_EQ(set.get(5), nullptr);
+    EXPECT_FALSE(set.remove(5));
+
+    EXPECT_NE(set.add(5, 50), nullptr);
+    EXPECT_NE(set.add(7, 70), nullptr);
+    EXPECT_NE(set.add(3, 30), nullptr);
+    EXPECT_EQ(set.add(7, 700), nullptr);
+    EXPECT_EQ(set.getLength(), 3);
+    EXPECT_EQ(*set.get(7), 70);
+
+    // 3 moves into the slot of 5
+    EXPECT_TRUE(set.remove(5));
+    EXPECT_FALSE(set.contains(5));
+    EXPECT_EQ(set.getKeys()[0], 3);
+    EXPECT_EQ(set.getValues()[0], 30);
+    EXPECT_EQ(*set.get(3), 30);
+
+    int sum = 0;
+    set.forEach([&](uint32_t, int &value) { sum += value; });
+    EXPECT_EQ(sum, 100);
+
+    set.clear();
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_FALSE(set.contains(3));
+    EXPECT_NE(set.add(3, 1), nullptr);
+}
+
+TEST(SparseSetTest, PagesOnlyWhereKeysAre)
+{
+    SparseSet<uint32_t> set;
+    set.add(0, 0);
+    set.add(4000000000u, 1);
+    set.add(4000000001u, 2);
+    EXPECT_EQ(set.getPageCount(), 2);
+    EXPECT_EQ(*set.get(4000000001u), 2);
+    EXPECT_FALSE(set.contains(2000000000u));
+    EXPECT_EQ(set.getPageCount(), 2);
+}
+
+TEST(SparseSetTest, ChurnAgainstUnorderedMap)
+{
+    SparseSet<std::shared_ptr<uint32_t>> set;
+    std::unordered_map<uint32_t, uint32_t> reference;
+    std::mt19937 random(11);
+
+    for (uint32_t i = 0; i < 200000; i++)
+    {
+        uint32_t key = random() % 20000;
+        if (random() % 2 == 0)
+        {
+            bool added = set.add(key, std::make_shared<uint32_t>(i)) != nullptr;
+            EXPECT_EQ(added, reference.emplace(key, i).second);
+        }
+        else
+        {
+            EXPECT_EQ(set.remove(key), reference.erase(key) == 1);
+        }
+    }
+
+    ASSERT_EQ(set.getLength(), reference.size());
+    for (const auto &entry : reference)
+    {
+        std::shared_ptr<uint32_t> *value = set.get(entry.first);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(**value, entry.second);
+    }
+}
+
+struct BenchmarkComponent
+{
+    float x, y, z;
+};
+
+TEST(SparseSetBenchmark, IterateAndChurn)
+{
+    const uint32_t AMOUNT = 1000000;
+    const uint32_t CHURN = 1000000;
+
+    std::vector<uint32_t> keys(AMOUNT);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(3));
+
+    SparseSet<BenchmarkComponent> set;
+    std::unordered_map<uint32_t, BenchmarkComponent> map;
+    set.reserve(AMOUNT);
+    map.reserve(AMOUNT);
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    auto setAddStart = std::chrono::steady_clock::now();
+    for (uint32_t key : keys)
+    {
+        set.add(key, BenchmarkComponent{1, 2, 3});
+    }
+    auto setAddEnd = std::chrono::steady_clock::now();
+    for (uint32_t key : keys)
+    {
+        map.emplace(key, BenchmarkComponent{1, 2, 3});
+    }
+    auto mapAddEnd = std::chrono::steady_clock::now();
+
+    float setSum = 0;
+    auto setIterateStart = std::chrono::steady_clock::now();
+    for (const BenchmarkComponent &component : set.getValues())
+    {
+        setSum += component.x + component.y + component.z;
+    }
+    auto setIterateEnd = std::chrono::steady_clock::now();
+    float mapSum = 0;
+    for (const auto &entry : map)
+    {
+        mapSum += entry.second.x + entry.second.y + entry.second.z;
+    }
+    auto mapIterateEnd = std::chrono::steady_clock::now();
+    EXPECT_EQ(setSum, mapSum);
+
+    // Random remove and re-add of keys which are alive
+    std::mt19937 random(5);
+    std::vector<uint32_t> churnKeys(CHURN);
+    for (uint32_t &key : churnKeys)
+    {
+        key = random() % AMOUNT;
+    }
+
+    auto setChurnStart = std::chrono::steady_clock::now();
+    for (uint32_t key : churnKeys)
+    {
+        set.remove(key);
+        set.add(key, BenchmarkComponent{1, 2, 3});
+    }
+    auto setChurnEnd = std::chrono::steady_clock::now();
+    for (uint32_t key : churnKeys)
+    {
+        map.erase(key);
+        map.emplace(key, BenchmarkComponent{1, 2, 3});
+    }
+    auto mapChurnEnd = std::chrono::steady_clock::now();
+    EXPECT_EQ(set.getLength(), map.size());
+
+    GTEST_COUT << AMOUNT << " entities, SparseSet / unordered_map: add " << ms(setAddStart, setAddEnd) << "ms / " << ms(setAddEnd, mapAddEnd)
+               << "ms, iterate " << ms(setIterateStart, setIterateEnd) << "ms / " << ms(setIterateEnd, mapIterateEnd) << "ms, " << CHURN
+               << " random remove+add " << ms(setChurnStart, setChurnEnd) << "ms / " << ms(setChurnEnd, mapChurnEnd) << "ms" << std::endl;
+}
+
+} // namespace bbe
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../TimerWheel.h"
+
+namespace bbe
+{
+
+TEST(TimerWheelTest, ExpiresInOrder)
+{
+    TimerWheel<int> wheel;
+    List<int> expired;
+
+    wheel.schedule(3, 3);
+    wheel.schedule(1, 1);
+    wheel.schedule(0, 0); // Counts as 1
+    wheel.schedule(300, 300);
+    wheel.schedule(70000, 70000);
+    EXPECT_EQ(wheel.getLength(), 5);
+
+    wheel.tick(expired);
+    EXPECT_EQ(expired.getLength(), 2);
+    expired.clear();
+
+    wheel.advance(2, expired);
+    ASSERT_EQ(expired.getLength(), 1);
+    EXPECT_EQ(expired[0], 3);
+    expired.clear();
+
+    wheel.advance(296, expired);
+    EXPECT_TRUE(expired.isEmpty());
+    wheel.tick(expired);
+    ASSERT_EQ(expired.getLength(), 1);
+    EXPECT_EQ(expired[0], 300);
+    EXPECT_EQ(wheel.getNow(), 300);
+    expired.clear();
+
+    wheel.advance(69699, expired);
+    EXPECT_TRUE(expired.isEmpty());
+    wheel.tick(expired);
+    ASSERT_EQ(expired.getLength(), 1);
+    EXPECT_EQ(wheel.getLength(), 0);
+}
+
+TEST(TimerWheelTest, Cancel)
+{
+    TimerWheel<std::shared_ptr<int>> wheel;
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    List<std::shared_ptr<int>> expired;
+
+    TimerHandle<std::shared_ptr<int>> nearTimer = wheel.schedule(10, shared);
+    TimerHandle<std::shared_ptr<int>> farTimer = wheel.schedule(100000, shared);
+    TimerHandle<std::shared_ptr<int>> expiring = wheel.schedule(5, shared);
+    EXPECT_TRUE(wheel.isPending(nearTimer));
+    EXPECT_FALSE(wheel.isPending(TimerHandle<std::shared_ptr<int>>()));
+
+    EXPECT_TRUE(wheel.cancel(nearTimer));
+    EXPECT_FALSE(wheel.cancel(nearTimer));
+    EXPECT_TRUE(wheel.cancel(farTimer));
+    EXPECT_EQ(shared.use_count(), 2);
+
+    wheel.advance(5, expired);
+    EXPECT_EQ(expired.getLength(), 1);
+    EXPECT_FALSE(wheel.isPending(expiring));
+    EXPECT_FALSE(wheel.cancel(expiring));
+
+    // The node of an old timer is reused, its handle must not cancel the new timer
+    TimerHandle<std::shared_ptr<int>> reused = wheel.schedule(1, shared);
+    EXPECT_FALSE(wheel.cancel(nearTimer));
+    EXPECT_TRUE(wheel.isPending(reused));
+
+    wheel.advance(20, expired);
+    EXPECT_EQ(expired.getLength(), 2);
+    expired.clear();
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(TimerWheelTest, RandomDelaysAgainstMultimap)
+{
+    TimerWheel<uint64_t> wheel(20000);
+    std::multimap<uint64_t, uint64_t> reference;
+    std::mt19937_64 random(8);
+    List<uint64_t> expired;
+
+    for (uint64_t i = 0; i < 10000; i++)
+    {
+        // Mostly short delays, some far beyond the second level, a few beyond the whole wheel
+        uint64_t delay = random() % 4 == 0 ? random() % 20000000 : random() % 1000 + 1;
+        if (i % 1000 == 0)
+        {
+            delay = ((uint64_t)1 << 32) + random() % 1000;
+        }
+        wheel.schedule(delay, i);
+        reference.emplace(delay, i);
+    }
+
+    std::vector<uint64_t> expectedTicks;
+    for (const auto &entry : reference)
+    {
+        expectedTicks.push_back(entry.first);
+    }
+    expectedTicks.erase(std::unique(expectedTicks.begin(), expectedTicks.end()), expectedTicks.end());
+
+    // Jumps from due tick to due tick, so the test doesn't step through 2^32 ticks
+    for (uint64_t due : expectedTicks)
+    {
+        if (due > 20000000)
+        {
+            break;
+        }
+        while (wheel.getNow() + 1 < due)
+        {
+            wheel.tick(expired);
+            ASSERT_TRUE(expired.isEmpty()) << "Expired early at " << wheel.getNow();
+        }
+        wheel.tick(expired);
+
+        std::vector<uint64_t> actual(expired.getRaw(), expired.getRaw() + expired.getLength());
+        std::vector<uint64_t> expected;
+        for (auto range = reference.equal_range(due); range.first != range.second; range.first++)
+        {
+            expected.push_back(range.first->second);
+        }
+        std::sort(actual.begin(), actual.end());
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(actual, expected) << "at tick " << due;
+        expired.clear();
+    }
+
+    EXPECT_EQ(wheel.getLength(), 10);
+}
+
+TEST(TimerWheelBenchmark, ChurnPerTick)
+{
+    const size_t AMOUNT = 1000000;
+    const size_t CHURN = AMOUNT / 10;
+    const size_t TICKS = 20;
+    const uint64_t MAX_DELAY = 60 * 60 * 10; // Ten minutes at 60 ticks per second
+
+    std::mt19937 random(12);
+    TimerWheel<uint32_t> wheel(AMOUNT + CHURN);
+    std::vector<TimerHandle<uint32_t>> handles(AMOUNT);
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        handles[i] = wheel.schedule(random() % MAX_DELAY + 1, (uint32_t)i);
+    }
+
+    // What gameplay code does today: one expiry time per timer, all scanned every tick
+    std::vector<uint64_t> expiryTimes(AMOUNT);
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        expiryTimes[i] = random() % MAX_DELAY + 1;
+    }
+
+    std::vector<uint32_t> churn(CHURN * TICKS);
+    for (uint32_t &index : churn)
+    {
+        index = random() % AMOUNT;
+    }
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count() / TICKS;
+    };
+
+    List<uint32_t> expired;
+    size_t wheelExpired = 0;
+    double wheelChurn = 0;
+    double wheelTick = 0;
+    for (size_t tick = 0; tick < TICKS; tick++)
+    {
+        auto churnStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < CHURN; i++)
+        {
+            uint32_t index = churn[tick * CHURN + i];
+            wheel.cancel(handles[index]);
+            handles[index] = wheel.schedule(random() % MAX_DELAY + 1, index);
+        }
+        auto tickStart = std::chrono::steady_clock::now();
+        wheel.tick(expired);
+        auto tickEnd = std::chrono::steady_clock::now();
+
+        wheelChurn += ms(churnStart, tickStart);
+        wheelTick += ms(tickStart, tickEnd);
+        wheelExpired += expired.getLength();
+        expired.clear();
+    }
+
+    size_t scanExpired = 0;
+    double scanChurn = 0;
+    double scanTick = 0;
+    for (size_t tick = 1; tick <= TICKS; tick++)
+    {
+        auto churnStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < CHURN; i++)
+        {
+            expiryTimes[churn[(tick - 1) * CHURN + i]] = tick + random() % MAX_DELAY;
+        }
+        auto tickStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < AMOUNT; i++)
+        {
+            if (expiryTimes[i] == tick)
+            {
+                scanExpired++;
+                expiryTimes[i] = UINT64_MAX;
+            }
+        }
+        auto tickEnd = std::chrono::steady_clock::now();
+
+        scanChurn += ms(churnStart, tickStart);
+        scanTick += ms(tickStart, tickEnd);
+    }
+
+    EXPECT_GT(wheelExpired, 0);
+    EXPECT_GT(scanExpired, 0);
+
+    // The wheel pays for the churn in cache misses on the timer nodes, the scan pays for every timer on every tick
+    GTEST_COUT << AMOUNT << " timers, " << CHURN << " cancelled and rescheduled per tick. TimerWheel: churn " << wheelChurn << "ms, expiry "
+               << wheelTick << "ms per tick. Linear scan: churn " << scanChurn << "ms, expiry " << scanTick << "ms per tick" << std::endl;
+}
+
+} // namespace bbe
@@ -0,0 +1,256 @@
+#pragma once
+
+#include "main.h"
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 1 tracks statistics in every allocator which uses DefaultAllocatorStatsPolicy, 0 compiles all of it out.
+// Defaults to tracking in debug builds only.
+#ifndef BBE_ALLOCATOR_STATS
+#ifdef NDEBUG
+#define BBE_ALLOCATOR_STATS 0
+#else
+#define BBE_ALLOCATOR_STATS 1
+#endif
+#endif
+
+// Lets an empty stats policy take no space in the allocator which stores it. MSVC ignores the standard
+// spelling of the attribute.
+#ifdef _MSC_VER
+#define BBE_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define BBE_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+namespace bbe
+{
+
+static const size_t ALLOCATOR_STATS_HISTOGRAM_BUCKETS = 32;
+
+// Snapshot of the statistics of one allocator. Sizes are what the caller asked for, usedMemory also counts
+// headers and padding, so it is what the allocator actually lost.
+struct AllocatorStats
+{
+    size_t m_usedMemory = 0;
+    size_t m_peakUsedMemory = 0;
+    size_t m_openAllocations = 0;
+    size_t m_peakOpenAllocations = 0;
+    uint64_t m_allocations = 0;
+    uint64_t m_deallocations = 0;
+    uint64_t m_failedAllocations = 0;
+    size_t m_alignmentWaste = 0; // Padding in front of the open allocations
+    size_t m_peakAlignmentWaste = 0;
+    uint64_t m_sizeHistogram[ALLOCATOR_STATS_HISTOGRAM_BUCKETS] = {}; // Bucket i counts sizes in [2^i, 2^(i+1))
+
+    static size_t getHistogramBucket(size_t size)
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, (uint64_t)size);
+#else
+        size_t index = 63 - __builtin_clzll((unsigned long long)size);
+#endif
+        return index < ALLOCATOR_STATS_HISTOGRAM_BUCKETS ? index : ALLOCATOR_STATS_HISTOGRAM_BUCKETS - 1;
+    }
+
+    // Adds the stats of another allocator, e.g. of a shard. The peaks become the sum of both peaks, which is an
+    // upper bound, as both allocators might not have peaked at the same time.
+    void add(const AllocatorStats &other)
+    {
+        m_usedMemory += other.m_usedMemory;
+        m_peakUsedMemory += other.m_peakUsedMemory;
+        m_openAllocations += other.m_openAllocations;
+        m_peakOpenAllocations += other.m_peakOpenAllocations;
+        m_allocations += other.m_allocations;
+        m_deallocations += other.m_deallocations;
+        m_failedAllocations += other.m_failedAllocations;
+        m_alignmentWaste += other.m_alignmentWaste;
+        m_peakAlignmentWaste += other.m_peakAlignmentWaste;
+        for (size_t i = 0; i < ALLOCATOR_STATS_HISTOGRAM_BUCKETS; i++)
+        {
+            m_sizeHistogram[i] += other.m_sizeHistogram[i];
+        }
+    }
+};
+
+// Stats policy which counts everything. Not thread safe, allocators call it where they already are single
+// threaded or locked.
+class TrackAllocatorStats
+{
+private:
+    AllocatorStats m_stats;
+
+public:
+    static const bool ENABLED = true;
+
+    // Allocators which free everything after a marker at once restore the counters of the marker
+    struct Checkpoint
+    {
+        size_t m_usedMemory = 0;
+        size_t m_openAllocations = 0;
+        size_t m_alignmentWaste = 0;
+    };
+
+    // usedSize: what the allocation costs the allocator, at least size + alignmentWaste
+    void onAllocate(size_t size, size_t alignmentWaste, size_t usedSize)
+    {
+        m_stats.m_usedMemory += usedSize;
+        m_stats.m_openAllocations++;
+        m_stats.m_alignmentWaste += alignmentWaste;
+        m_stats.m_allocations++;
+        m_stats.m_sizeHistogram[AllocatorStats::getHistogramBucket(size)]++;
+
+        if (m_stats.m_usedMemory > m_stats.m_peakUsedMemory)
+        {
+            m_stats.m_peakUsedMemory = m_stats.m_usedMemory;
+        }
+        if (m_stats.m_openAllocations > m_stats.m_peakOpenAllocations)
+        {
+            m_stats.m_peakOpenAllocations = m_stats.m_openAllocations;
+        }
+        if (m_stats.m_alignmentWaste > m_stats.m_peakAlignmentWaste)
+        {
+            m_stats.m_peakAlignmentWaste = m_stats.m_alignmentWaste;
+        }
+    }
+
+    void onAllocate(size_t size, size_t alignmentWaste)
+    {
+        onAllocate(size, alignmentWaste, size + alignmentWaste);
+    }
+
+    void onDeallocate(size_t alignmentWaste, size_t usedSize)
+    {
+        m_stats.m_usedMemory -= usedSize;
+        m_stats.m_openAllocations--;
+        m_stats.m_alignmentWaste -= alignmentWaste;
+        m_stats.m_deallocations++;
+    }
+
+    void onFailedAllocation()
+    {
+        m_stats.m_failedAllocations++;
+    }
+
+    // An open allocation was moved, e.g. by defragmentation, and needs a different padding now
+    void onRelocate(size_t oldAlignmentWaste, size_t newAlignmentWaste)
+    {
+        m_stats.m_usedMemory = m_stats.m_usedMemory - oldAlignmentWaste + newAlignmentWaste;
+        m_stats.m_alignmentWaste = m_stats.m_alignmentWaste - oldAlignmentWaste + newAlignmentWaste;
+        if (m_stats.m_usedMemory > m_stats.m_peakUsedMemory)
+        {
+            m_stats.m_peakUsedMemory = m_stats.m_usedMemory;
+        }
+        if (m_stats.m_alignmentWaste > m_stats.m_peakAlignmentWaste)
+        {
+            m_stats.m_peakAlignmentWaste = m_stats.m_alignmentWaste;
+        }
+    }
+
+    Checkpoint getCheckpoint() const
+    {
+        Checkpoint checkpoint;
+        checkpoint.m_usedMemory = m_stats.m_usedMemory;
+        checkpoint.m_openAllocations = m_stats.m_openAllocations;
+        checkpoint.m_alignmentWaste = m_stats.m_alignmentWaste;
+        return checkpoint;
+    }
+
+    // Rewinding to a plain address only tells how much memory is still used, the counts stay as they are
+    void onRewind(size_t usedMemory)
+    {
+        m_stats.m_usedMemory = usedMemory;
+        if (m_stats.m_alignmentWaste > usedMemory)
+        {
+            m_stats.m_alignmentWaste = usedMemory;
+        }
+    }
+
+    void onRewind(const Checkpoint &checkpoint)
+    {
+        m_stats.m_deallocations += m_stats.m_openAllocations - checkpoint.m_openAllocations;
+        m_stats.m_usedMemory = checkpoint.m_usedMemory;
+        m_stats.m_openAllocations = checkpoint.m_openAllocations;
+        m_stats.m_alignmentWaste = checkpoint.m_alignmentWaste;
+    }
+
+    // Everything was freed at once
+    void onReset()
+    {
+        onRewind(Checkpoint());
+    }
+
+    AllocatorStats get() const
+    {
+        return m_stats;
+    }
+};
+
+// Stats policy which compiles to nothing
+class NoAllocatorStats
+{
+public:
+    static const bool ENABLED = false;
+
+    struct Checkpoint
+    {
+    };
+
+    void onAllocate(size_t, size_t, size_t)
+    {
+    }
+
+    void onAllocate(size_t, size_t)
+    {
+    }
+
+    void onDeallocate(size_t, size_t)
+    {
+    }
+
+    void onFailedAllocation()
+    {
+    }
+
+    void onRelocate(size_t, size_t)
+    {
+    }
+
+    Checkpoint getCheckpoint() const
+    {
+        return Checkpoint();
+    }
+
+    void onRewind(size_t)
+    {
+    }
+
+    void onRewind(const Checkpoint &)
+    {
+    }
+
+    void onReset()
+    {
+    }
+
+    AllocatorStats get() const
+    {
+        return AllocatorStats();
+    }
+};
+
+#if BBE_ALLOCATOR_STATS
+typedef TrackAllocatorStats DefaultAllocatorStatsPolicy;
+#else
+typedef NoAllocatorStats DefaultAllocatorStatsPolicy;
+#endif
+
+} // namespace bbe
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "main.h"
+#include "AllocatorStats.h"
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace bbe
+{
+
+namespace INTERNAL
+{
+
+inline uint32_t countTrailingZeros64(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+} // namespace INTERNAL
+
+template <typename T>
+union BitmapPoolChunk {
+    T value;
+
+    BitmapPoolChunk(){};
+    ~BitmapPoolChunk(){};
+};
+
+// Pool which tracks its chunks with one bit each instead of a free list. allocate always takes the free chunk
+// with the lowest address, so live objects stay packed at the front after churn, and they can be walked in
+// address order. A second bitmap with one bit per word of the first one marks the words with free chunks, so
+// the free chunk is found with two ctz instead of a scan over the whole bitmap.
+template <typename T, typename Allocator = std::allocator<BitmapPoolChunk<T>>, typename StatsPolicy = DefaultAllocatorStatsPolicy>
+class BitmapPoolAllocator
+{
+private:
+    static const size_t BITMAP_POOL_ALLOCATOR_DEFAULT_SIZE = 1024;
+    static const size_t BITS_PER_WORD = 64;
+
+    size_t m_size = 0;
+    size_t m_openAllocations = 0;
+
+    BitmapPoolChunk<T> *m_data = nullptr;
+
+    uint64_t *m_occupied = nullptr;   // Bit per chunk, set if it is allocated
+    uint64_t *m_hasFree = nullptr;    // Bit per word of m_occupied, set if that word has a free chunk
+    size_t m_occupiedWords = 0;
+    size_t m_hasFreeWords = 0;
+    size_t m_firstHasFreeWord = 0;    // No word in front of this one of m_hasFree has a bit set
+
+    Allocator *m_parentAllocator = nullptr;
+    bool m_needsToDeleteParentAllocator = false;
+
+    BBE_NO_UNIQUE_ADDRESS StatsPolicy m_stats;
+
+    // Occupied bits of a word without the padding behind m_size
+    uint64_t getLiveBits(size_t word) const
+    {
+        if (word == m_occupiedWords - 1 && m_size % BITS_PER_WORD != 0)
+        {
+            return m_occupied[word] & ~(~(uint64_t)0 << (m_size % BITS_PER_WORD));
+        }
+        return m_occupied[word];
+    }
+
+public:
+    class Iterator
+    {
+    private:
+        friend class BitmapPoolAllocator;
+
+        const BitmapPoolAllocator *m_pool;
+        size_t m_word;
+        uint64_t m_bits; // Occupied chunks of m_word which were not visited yet
+
+        Iterator(const BitmapPoolAllocator *pool, size_t word)
+            : m_pool(pool), m_word(word), m_bits(word < pool->m_occupiedWords ? pool->getLiveBits(word) : 0)
+        {
+            skipEmptyWords();
+        }
+
+        void skipEmptyWords()
+        {
+            while (m_bits == 0 && m_word < m_pool->m_occupiedWords)
+            {
+                m_word++;
+                m_bits = m_word < m_pool->m_occupiedWords ? m_pool->getLiveBits(m_word) : 0;
+            }
+        }
+
+    public:
+        T &operator*() const
+        {
+            return m_pool->m_data[m_word * BITS_PER_WORD + INTERNAL::countTrailingZeros64(m_bits)].value;
+        }
+
+        T *operator->() const
+        {
+            return &**this;
+        }
+
+        Iterator &operator++()
+        {
+            m_bits &= m_bits - 1;
+            skipEmptyWords();
+            return *this;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return m_word == other.m_word && m_bits == other.m_bits;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    explicit BitmapPoolAllocator(size_t size = BITMAP_POOL_ALLOCATOR_DEFAULT_SIZE, Allocator *parentAllocator = nullptr)
+        : m_size(size), m_parentAllocator(parentAllocator)
+    {
+        if (parentAllocator == nullptr)
+        {
+            m_parentAllocator = new Allocator();
+            m_needsToDeleteParentAllocator = true;
+        }
+
+        m_data = m_parentAllocator->allocate(m_size);
+
+        m_occupiedWords = (m_size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+        m_hasFreeWords = (m_occupiedWords + BITS_PER_WORD - 1) / BITS_PER_WORD;
+        m_occupied = new uint64_t[m_occupiedWords];
+        m_hasFree = new uint64_t[m_hasFreeWords];
+
+        for (size_t i = 0; i < m_occupiedWords; i++)
+        {
+            m_occupied[i] = 0;
+        }
+        // The chunks behind m_size in the last word are marked as occupied, so they are never handed out
+        if (m_size % BITS_PER_WORD != 0)
+        {
+            m_occupied[m_occupiedWords - 1] = ~(uint64_t)0 << (m_size % BITS_PER_WORD);
+        }
+
+        for (size_t i = 0; i < m_hasFreeWords; i++)
+        {
+            m_hasFree[i] = ~(uint64_t)0;
+        }
+        if (m_occupiedWords % BITS_PER_WORD != 0)
+        {
+            m_hasFree[m_hasFreeWords - 1] = ~(~(uint64_t)0 << (m_occupiedWords % BITS_PER_WORD));
+        }
+    }
+
+    BitmapPoolAllocator(const BitmapPoolAllocator &other) = delete;            // Copy Constructor
+    BitmapPoolAllocator(BitmapPoolAllocator &&other) = delete;                 // Move Constructor
+    BitmapPoolAllocator &operator=(const BitmapPoolAllocator &other) = delete; // Copy Assignment
+    BitmapPoolAllocator &operator=(BitmapPoolAllocator &&other) = delete;      // Move Assignment
+
+    ~BitmapPoolAllocator()
+    {
+        if (m_openAllocations != 0)
+        {
+            // TODO: Error Handling
+            DEBUG_BREAK;
+        }
+
+        m_parentAllocator->deallocate(m_data, m_size);
+        delete[] m_occupied;
+        delete[] m_hasFree;
+
+        if (m_needsToDeleteParentAllocator)
+        {
+            delete m_parentAllocator;
+        }
+
+        m_data = nullptr;
+    }
+
+    template <typename... arguments>
+    T *allocate(arguments &&... args)
+    {
+        while (m_firstHasFreeWord < m_hasFreeWords && m_hasFree[m_firstHasFreeWord] == 0)
+        {
+            m_firstHasFreeWord++;
+        }
+        if (m_firstHasFreeWord == m_hasFreeWords)
+        {
+            m_stats.onFailedAllocation();
+            DEBUG_BREAK;
+            return nullptr;
+        }
+
+        const size_t word = m_firstHasFreeWord * BITS_PER_WORD + INTERNAL::countTrailingZeros64(m_hasFree[m_firstHasFreeWord]);
+        const uint32_t bit = INTERNAL::countTrailingZeros64(~m_occupied[word]);
+
+        m_occupied[word] |= (uint64_t)1 << bit;
+        if (m_occupied[word] == ~(uint64_t)0)
+        {
+            m_hasFree[word / BITS_PER_WORD] &= ~((uint64_t)1 << (word % BITS_PER_WORD));
+        }
+        m_openAllocations++;
+        m_stats.onAllocate(sizeof(T), sizeof(BitmapPoolChunk<T>) - sizeof(T), sizeof(BitmapPoolChunk<T>));
+
+        return new (std::addressof(m_data[word * BITS_PER_WORD + bit].value)) T(std::forward<arguments>(args)...);
+    }
+
+    void deallocate(T *data)
+    {
+        // TODO: What if data is not part of m_data
+        data->~T();
+
+        const size_t index = reinterpret_cast<BitmapPoolChunk<T> *>(data) - m_data;
+        const size_t word = index / BITS_PER_WORD;
+
+        m_occupied[word] &= ~((uint64_t)1 << (index % BITS_PER_WORD));
+        m_hasFree[word / BITS_PER_WORD] |= (uint64_t)1 << (word % BITS_PER_WORD);
+        if (word / BITS_PER_WORD < m_firstHasFreeWord)
+        {
+            m_firstHasFreeWord = word / BITS_PER_WORD;
+        }
+        m_openAllocations--;
+        m_stats.onDeallocate(sizeof(BitmapPoolChunk<T>) - sizeof(T), sizeof(BitmapPoolChunk<T>));
+    }
+
+    // Deallocates every live object
+    void clear()
+    {
+        for (size_t word = 0; word < m_occupiedWords; word++)
+        {
+            for (uint64_t bits = getLiveBits(word); bits != 0; bits &= bits - 1)
+            {
+                deallocate(&m_data[word * BITS_PER_WORD + INTERNAL::countTrailingZeros64(bits)].value);
+            }
+        }
+    }
+
+    bool isAllocated(const T *data) const
+    {
+        const size_t index = reinterpret_cast<const BitmapPoolChunk<T> *>(data) - m_data;
+        return index < m_size && (m_occupied[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1;
+    }
+
+    // function(T &) for every live object in address order, faster than iterating with Iterator
+    template <typename Function>
+    void forEach(Function function)
+    {
+        for (size_t word = 0; word < m_occupiedWords; word++)
+        {
+            for (uint64_t bits = getLiveBits(word); bits != 0; bits &= bits - 1)
+            {
+                function(m_data[word * BITS_PER_WORD + INTERNAL::countTrailingZeros64(bits)].value);
+            }
+        }
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(this, m_occupiedWords);
+    }
+
+    size_t getOpenAllocations() const
+    {
+        return m_openAllocations;
+    }
+
+    size_t getSize() const
+    {
+        return m_size;
+    }
+
+    bool hasFreeChunks() const
+    {
+        return m_openAllocations < m_size;
+    }
+
+    // Empty unless the StatsPolicy tracks
+    AllocatorStats getStats() const
+    {
+        return m_stats.get();
+    }
+};
+
+} // namespace bbe
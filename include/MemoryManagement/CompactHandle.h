@@ -0,0 +1,152 @@
+#pragma once
+
+#include "main.h"
+#include "HandleTable.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bbe
+{
+
+class HandleTableRegistry
+{
+public:
+    static const size_t MAX_REGISTERED_TABLES = 16;
+
+    static void registerTable(size_t slot, const HandleTable *table)
+    {
+        if (slot >= MAX_REGISTERED_TABLES || (s_tables[slot] != nullptr && s_tables[slot] != table))
+        {
+            // TODO: Error Handling
+            DEBUG_BREAK;
+            return;
+        }
+        s_tables[slot] = table;
+    }
+
+    static void unregisterTable(size_t slot)
+    {
+        s_tables[slot] = nullptr;
+    }
+
+    static const HandleTable *get(size_t slot)
+    {
+        return s_tables[slot];
+    }
+
+private:
+    static inline const HandleTable *s_tables[MAX_REGISTERED_TABLES] = {};
+};
+
+// 4 byte handle (24 bit index, lowest 8 bit of the generation) for arrays of handles.
+// The handle table is not stored, it is looked up in the registry slot given as template parameter.
+// Only 8 bit of the generation are kept, so a stale handle is caught until its slot was reused 256 times.
+// After that it resolves to whatever allocation owns the slot now. Don't keep compact handles of short lived
+// allocations around, use the full handles of the allocators for those.
+template <typename T, size_t registrySlot>
+class CompactHandle
+{
+    static_assert(registrySlot < HandleTableRegistry::MAX_REGISTERED_TABLES, "Registry slot out of range!");
+
+public:
+    static const uint32_t INDEX_BITS = 24;
+    static const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static const uint32_t GENERATION_MASK = 0xFF;
+
+private:
+    uint32_t m_value;
+
+    T *resolve() const
+    {
+        const HandleTable &table = *HandleTableRegistry::get(registrySlot);
+#ifndef NDEBUG
+        if ((table.getGeneration(getHandleIndex()) & GENERATION_MASK) != getGeneration())
+        {
+            // Stale handle, the allocation was freed and the slot may already be reused
+            DEBUG_BREAK;
+        }
+#endif
+        return static_cast<T *>(table[getHandleIndex()]);
+    }
+
+public:
+    CompactHandle()
+        : m_value(0)
+    {
+    }
+
+    CompactHandle(size_t handleIndex, uint32_t generation)
+        : m_value(0)
+    {
+        if (handleIndex > INDEX_MASK)
+        {
+            // Handle table is too long for compact handles
+            DEBUG_BREAK;
+            return;
+        }
+        m_value = (uint32_t)handleIndex | ((generation & GENERATION_MASK) << INDEX_BITS);
+    }
+
+    // Used by the toCompact of the allocators. table has to be registered in registrySlot, otherwise the
+    // handle would resolve through another table, and an invalid handle is returned.
+    static CompactHandle fromTable(const HandleTable &table, size_t handleIndex, uint32_t generation)
+    {
+        if (HandleTableRegistry::get(registrySlot) != &table)
+        {
+            // TODO: Error Handling
+            DEBUG_BREAK;
+            return CompactHandle();
+        }
+        return CompactHandle(handleIndex, generation);
+    }
+
+    size_t getHandleIndex() const
+    {
+        return m_value & INDEX_MASK;
+    }
+
+    uint32_t getGeneration() const
+    {
+        return m_value >> INDEX_BITS;
+    }
+
+    bool isValid() const
+    {
+        const HandleTable *table = HandleTableRegistry::get(registrySlot);
+        return table != nullptr && getHandleIndex() != 0 && getHandleIndex() < table->getLength()
+                && (table->getGeneration(getHandleIndex()) & GENERATION_MASK) == getGeneration();
+    }
+
+    T *getRaw() const
+    {
+        return resolve();
+    }
+
+    T *operator->() const
+    {
+        return resolve();
+    }
+
+    T &operator*() const
+    {
+        return *resolve();
+    }
+
+    T &operator[](size_t index) const
+    {
+        return *(resolve() + index);
+    }
+
+    bool operator==(CompactHandle other) const
+    {
+        return m_value == other.m_value;
+    }
+
+    bool operator!=(CompactHandle other) const
+    {
+        return m_value != other.m_value;
+    }
+};
+
+} // namespace bbe
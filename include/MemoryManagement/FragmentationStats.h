@@ -0,0 +1,68 @@
+#pragma once
+
+#include "main.h"
+#include "AllocatorStats.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace bbe
+{
+
+// Snapshot of the free memory of an allocator with a free list. The allocators keep it up to date whenever a
+// free block is added, removed or merged, so reading it is cheap enough to do every frame.
+struct FragmentationStats
+{
+    size_t m_freeMemory = 0;
+    size_t m_freeBlocks = 0;
+    size_t m_largestFreeBlock = 0;
+    uint64_t m_freeBlockHistogram[ALLOCATOR_STATS_HISTOGRAM_BUCKETS] = {}; // Bucket i counts free blocks in [2^i, 2^(i+1))
+
+    void addFreeBlock(size_t size)
+    {
+        m_freeMemory += size;
+        m_freeBlocks++;
+        m_freeBlockHistogram[AllocatorStats::getHistogramBucket(size)]++;
+    }
+
+    // Doesn't touch m_largestFreeBlock, only the allocator knows which block is the next largest one
+    void removeFreeBlock(size_t size)
+    {
+        m_freeMemory -= size;
+        m_freeBlocks--;
+        m_freeBlockHistogram[AllocatorStats::getHistogramBucket(size)]--;
+    }
+
+    // 0 if all free memory is one block, close to 1 if it is scattered over many small ones
+    double getExternalFragmentation() const
+    {
+        if (m_freeMemory == 0)
+        {
+            return 0.0;
+        }
+        return 1.0 - (double)m_largestFreeBlock / (double)m_freeMemory;
+    }
+
+    // How much the largest free block would grow if compaction moved all free memory into one block
+    size_t getRecoverableBytes() const
+    {
+        return m_freeMemory - m_largestFreeBlock;
+    }
+
+    // Adds the free memory of another allocator, e.g. of a shard. A single allocation can't span both, so the
+    // largest free block is the larger of the two.
+    void add(const FragmentationStats &other)
+    {
+        m_freeMemory += other.m_freeMemory;
+        m_freeBlocks += other.m_freeBlocks;
+        if (other.m_largestFreeBlock > m_largestFreeBlock)
+        {
+            m_largestFreeBlock = other.m_largestFreeBlock;
+        }
+        for (size_t i = 0; i < ALLOCATOR_STATS_HISTOGRAM_BUCKETS; i++)
+        {
+            m_freeBlockHistogram[i] += other.m_freeBlockHistogram[i];
+        }
+    }
+};
+
+} // namespace bbe
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "main.h"
+#include "AllocatorStats.h"
+#include "FragmentationStats.h"
 #include "Util/UtilMath.h"
-#include "DataStructures/List.h"
 #include "Util/DataTypes.h"
-#include "DataStructures/Stack.h"
+#include "CompactHandle.h"
 
 #include <cstring>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
 
 namespace bbe
 {
@@ -39,29 +44,10 @@ public:
         return false;
     }
 
-    bool operator>(const GeneralPurposeAllocatorFreeChunk &other) const
+    bool fits(size_t amountOfBytes, size_t alignment) const
     {
-        return m_addr > other.m_addr;
-    }
-    bool operator<(const GeneralPurposeAllocatorFreeChunk &other) const
-    {
-        return m_addr < other.m_addr;
-    }
-    bool operator>=(const GeneralPurposeAllocatorFreeChunk &other) const
-    {
-        return m_addr >= other.m_addr;
-    }
-    bool operator<=(const GeneralPurposeAllocatorFreeChunk &other) const
-    {
-        return m_addr <= other.m_addr;
-    }
-    bool operator==(const GeneralPurposeAllocatorFreeChunk &other) const
-    {
-        return m_addr == other.m_addr;
-    }
-    bool operator!=(const GeneralPurposeAllocatorFreeChunk &other) const
-    {
-        return m_addr != other.m_addr;
+        byte *allocationLocation = (byte *)nextMultiple(alignment, ((size_t)m_addr) + 1); // +1: save offset in front
+        return allocationLocation + amountOfBytes <= m_addr + m_size;
     }
 
     template <typename T, typename... arguments>
@@ -109,60 +95,96 @@ public:
         friend class GeneralPurposeAllocator;
 
     private:
-        size_t m_handleIndex;
-        size_t m_size;
         GeneralPurposeAllocator *m_pparent;
+        uint32_t m_handleIndex;
+        uint32_t m_generation;
+        size_t m_size;
+
+        T *resolve() const
+        {
+            return static_cast<T *>(m_pparent->m_handleTable.get(m_handleIndex, m_generation));
+        }
 
     public:
         GeneralPurposeAllocatorPointer(GeneralPurposeAllocator *parent, size_t handleIndex, size_t size)
-            : m_pparent(parent), m_handleIndex(handleIndex), m_size(size)
-
+            : m_pparent(parent), m_handleIndex((uint32_t)handleIndex), m_generation(parent->m_handleTable.getGeneration(handleIndex)), m_size(size)
         {
         }
 
         T *operator->()
         {
-            return static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]);
+            return resolve();
         }
 
         const T *operator->() const
         {
-            return static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]);
+            return resolve();
         }
 
         T &operator*()
         {
-            return *static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]);
+            return *resolve();
         }
 
         const T &operator*() const
         {
-            return *static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]);
+            return *resolve();
         }
 
         T &operator[](int index)
         {
-            return *(static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]) + index);
+            return *(resolve() + index);
         }
 
         const T &operator[](int index) const
         {
-            return *(static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]) + index);
+            return *(resolve() + index);
         }
 
         T *getRaw()
         {
-            return static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]);
+            return resolve();
+        }
+
+        size_t getHandleIndex() const
+        {
+            return m_handleIndex;
+        }
+
+        uint32_t getGeneration() const
+        {
+            return m_generation;
+        }
+
+        // False once the allocation was freed, even if its handle slot got reused
+        bool isValid() const
+        {
+            return m_handleIndex != 0 && m_pparent->m_handleTable.isValid(m_handleIndex, m_generation);
+        }
+
+        // Resolves the handle once, defragment() won't move the objects while the returned object is alive
+        Pinned<T> pin()
+        {
+            return Pinned<T>(m_pparent->m_handleTable, m_handleIndex, m_generation, m_size);
+        }
+
+        // Drops the size, so the compact handle can only access the objects, not deallocate them.
+        // The handle table of the parent has to be registered in registrySlot. The compact handle only keeps
+        // 8 bit of the generation, see CompactHandle.
+        template <size_t registrySlot>
+        CompactHandle<T, registrySlot> toCompact() const
+        {
+            return CompactHandle<T, registrySlot>::fromTable(m_pparent->m_handleTable, m_handleIndex, m_generation);
         }
 
         bool operator==(void *ptr) const
         {
-            return static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]) == ptr;
+            return resolve() == ptr;
         }
 
         bool operator!=(void *ptr) const
         {
-            return static_cast<T *>(m_pparent->m_handleTable[m_handleIndex]) != ptr;
+            return resolve() != ptr;
         }
     };
 
@@ -172,11 +194,7 @@ public:
 
     private:
         GeneralPurposeAllocator *m_pparent;
-        union {
-            size_t m_handleIndex;
-            void *m_paddr;
-        };
-        bool m_usedAddr = false;
+        size_t m_handleIndex;
         size_t m_amountOfObjects = 0;
 
         byte *(GeneralPurposeAllocatorRelocatable::*relocate)(void *);
@@ -233,21 +251,11 @@ public:
 
         template <typename T>
         GeneralPurposeAllocatorRelocatable(GeneralPurposeAllocator *parent, size_t handleIndex, size_t amountOfObjects, T *t) // t only for compiler, to know what type
-            : m_pparent(parent), m_handleIndex(handleIndex), m_amountOfObjects(amountOfObjects), m_usedAddr(false)
+            : m_pparent(parent), m_handleIndex(handleIndex), m_amountOfObjects(amountOfObjects)
         {
             relocate = &GeneralPurposeAllocatorRelocatable::relocateTemplate<T>;
         }
 
-        GeneralPurposeAllocatorRelocatable(GeneralPurposeAllocator *parent, void *addr)
-            : m_pparent(parent), m_paddr(addr), m_usedAddr(true)
-        {
-        }
-
-        GeneralPurposeAllocatorRelocatable(GeneralPurposeAllocator *parent, size_t handleIndex)
-            : m_pparent(parent), m_handleIndex(handleIndex), m_usedAddr(false)
-        {
-        }
-
         byte *operator()(void *newAddr)
         {
             return (this->*relocate)(newAddr);
@@ -255,70 +263,66 @@ public:
 
         void *getAddr() const
         {
-            if (m_usedAddr)
-            {
-                return m_paddr;
-            }
-            else
-            {
-                return m_pparent->m_handleTable[m_handleIndex];
-            }
-        }
-
-    public:
-        bool operator>(const GeneralPurposeAllocatorRelocatable &other) const
-        {
-            return getAddr() > other.getAddr();
-        }
-        bool operator<(const GeneralPurposeAllocatorRelocatable &other) const
-        {
-            return getAddr() < other.getAddr();
-        }
-        bool operator>=(const GeneralPurposeAllocatorRelocatable &other) const
-        {
-            return getAddr() >= other.getAddr();
-        }
-        bool operator<=(const GeneralPurposeAllocatorRelocatable &other) const
-        {
-            return getAddr() <= other.getAddr();
-        }
-        bool operator==(const GeneralPurposeAllocatorRelocatable &other) const
-        {
-            return getAddr() == other.getAddr();
-        }
-        bool operator!=(const GeneralPurposeAllocatorRelocatable &other) const
-        {
-            return getAddr() != other.getAddr();
+            return m_pparent->m_handleTable[m_handleIndex];
         }
     };
 
 private:
     static const size_t GENERAL_PURPOSE_ALLOCATOR_DEFAULT_SIZE = 1024;
 
+    typedef std::map<byte *, size_t> FreeChunksByAddress;
+    typedef std::set<std::pair<size_t, byte *>> FreeChunksBySize;
+    typedef std::map<void *, GeneralPurposeAllocatorRelocatable> AllocatedBlocks;
+
     byte *m_data;
     size_t m_size;
 
-    List<INTERNAL::GeneralPurposeAllocatorFreeChunk, true> m_freeChunks;
+    // Every free chunk is stored in both trees: by address to find neighbours, by size to find the best fit
+    FreeChunksByAddress m_freeChunksByAddress;
+    FreeChunksBySize m_freeChunksBySize;
 
-    size_t m_lengthOfHanfleTable;
-    void **m_handleTable;
-    Stack<size_t> m_unusedHandleStack;
-    List<GeneralPurposeAllocatorRelocatable, true> m_allocatedBlocks;
+    HandleTable m_handleTable;
+    AllocatedBlocks m_allocatedBlocks; // Key is the current address of the data, so it has to be updated on relocation
 
-public:
-    explicit GeneralPurposeAllocator(size_t size = GENERAL_PURPOSE_ALLOCATOR_DEFAULT_SIZE, size_t lengthOfHandleTable = GENERAL_PURPOSE_ALLOCATOR_DEFAULT_SIZE / 4)
-        : m_size(size), m_lengthOfHanfleTable(lengthOfHandleTable)
+    BBE_NO_UNIQUE_ADDRESS DefaultAllocatorStatsPolicy m_stats;
+    FragmentationStats m_fragmentation; // Without the largest free block, that one is the last chunk by size
+
+    void addFreeChunk(byte *addr, size_t size)
     {
-        m_data = new byte[m_size];
-        m_freeChunks.pushBack(INTERNAL::GeneralPurposeAllocatorFreeChunk(m_data, m_size));
+        m_freeChunksByAddress.emplace(addr, size);
+        m_freeChunksBySize.emplace(size, addr);
+        m_fragmentation.addFreeBlock(size);
+    }
 
-        m_handleTable = new void *[m_lengthOfHanfleTable];
-        memset(m_handleTable, 0, sizeof(void *) * m_lengthOfHanfleTable);
+    void removeFreeChunk(FreeChunksByAddress::iterator chunk)
+    {
+        m_fragmentation.removeFreeBlock(chunk->second);
+        m_freeChunksBySize.erase(std::make_pair(chunk->second, chunk->first));
+        m_freeChunksByAddress.erase(chunk);
+    }
 
-        for(size_t i = lengthOfHandleTable - 1; i > 0; i--)
+    FreeChunksBySize::iterator findBestFitFreeChunk(size_t amountOfBytes, size_t alignment)
+    {
+        // Smallest chunk which could fit, if its address happens to be aligned well
+        auto bestFit = m_freeChunksBySize.lower_bound(std::make_pair(amountOfBytes + 1, (byte *)nullptr));
+        if (bestFit != m_freeChunksBySize.end()
+                && INTERNAL::GeneralPurposeAllocatorFreeChunk(bestFit->second, bestFit->first).fits(amountOfBytes, alignment))
         {
-            m_unusedHandleStack.push(i);
+            return bestFit;
         }
+
+        // Chunks of this size fit regardless of their alignment
+        return m_freeChunksBySize.lower_bound(std::make_pair(amountOfBytes + alignment, (byte *)nullptr));
+    }
+
+public:
+    // The handle table starts with lengthOfHandleTable handles and grows when they are used up
+    explicit GeneralPurposeAllocator(size_t size = GENERAL_PURPOSE_ALLOCATOR_DEFAULT_SIZE, size_t lengthOfHandleTable = GENERAL_PURPOSE_ALLOCATOR_DEFAULT_SIZE / 4,
+                                     size_t maxLengthOfHandleTable = HandleTable::UNLIMITED_LENGTH)
+        : m_size(size), m_handleTable(lengthOfHandleTable, maxLengthOfHandleTable)
+    {
+        m_data = new byte[m_size];
+        addFreeChunk(m_data, m_size);
     }
 
     GeneralPurposeAllocator(const GeneralPurposeAllocator &other) = delete;
@@ -333,12 +337,6 @@ public:
             delete[] m_data;
             m_data = nullptr;
         }
-
-        if (m_handleTable != nullptr)
-        {
-            delete[] m_handleTable;
-            m_handleTable = nullptr;
-        }
     }
 
     template <typename T, typename... arguments>
@@ -346,31 +344,48 @@ public:
     {
         static_assert(alignof(T) <= 128, "Max alignment of 128 was exceeded!");
 
-        for (size_t i = 0; i < m_freeChunks.getLength(); i++)
+        if (m_handleTable.isFull())
         {
-            T *data = m_freeChunks[i].allocateObject<T>(amountOfObjects, std::forward<arguments>(args)...);
-            if (data != nullptr && m_unusedHandleStack.hasDataLeft())
-            {
-                // Remove empty free chunks
-                if (m_freeChunks[i].m_size == 0)
-                {
-                    m_freeChunks.removeIndex(i);
-                }
+            m_stats.onFailedAllocation();
+            return GeneralPurposeAllocatorPointer<T>(this, 0, 0);
+        }
 
-                size_t index = m_unusedHandleStack.pop();
-                m_handleTable[index] = data;
-                m_allocatedBlocks.pushBack(GeneralPurposeAllocatorRelocatable(this, index, amountOfObjects, data));
+        auto bestFit = findBestFitFreeChunk(amountOfObjects * sizeof(T), alignof(T));
+        if (bestFit == m_freeChunksBySize.end())
+        {
+            m_stats.onFailedAllocation();
+            return GeneralPurposeAllocatorPointer<T>(this, 0, 0); // Or defragment the space
+        }
 
-                return GeneralPurposeAllocatorPointer<T>(this, index, amountOfObjects);
-            }
+        INTERNAL::GeneralPurposeAllocatorFreeChunk chunk(bestFit->second, bestFit->first);
+        removeFreeChunk(m_freeChunksByAddress.find(chunk.m_addr));
+
+        byte *chunkAddr = chunk.m_addr;
+        T *data = chunk.allocateObject<T>(amountOfObjects, std::forward<arguments>(args)...);
+        m_stats.onAllocate(amountOfObjects * sizeof(T), reinterpret_cast<byte *>(data) - chunkAddr); // Padding includes the offset byte
+
+        // Put the remaining part of the chunk back, empty chunks are dropped
+        if (chunk.m_size != 0)
+        {
+            addFreeChunk(chunk.m_addr, chunk.m_size);
         }
 
-        return GeneralPurposeAllocatorPointer<T>(this, 0, 0); // Or defragment the space
+        size_t index = m_handleTable.acquire(data);
+        m_allocatedBlocks.emplace(data, GeneralPurposeAllocatorRelocatable(this, index, amountOfObjects, data));
+
+        return GeneralPurposeAllocatorPointer<T>(this, index, amountOfObjects);
     }
 
     template <typename T>
     void deallocateObjects(GeneralPurposeAllocatorPointer<T> pointer)
     {
+        if (!pointer.isValid() || m_allocatedBlocks.erase(m_handleTable[pointer.m_handleIndex]) == 0)
+        {
+            // Null pointer, double free or pointer of another allocator
+            DEBUG_BREAK;
+            return;
+        }
+
         for (size_t i = 0; i < pointer.m_size; i++)
         {
             std::addressof(pointer[i])->~T();
@@ -380,62 +395,62 @@ public:
         size_t amountOfBytes = sizeof(T) * pointer.m_size;
         byte offset = bytePointer[-1];
 
-        INTERNAL::GeneralPurposeAllocatorFreeChunk gpafc(bytePointer - offset, amountOfBytes + offset);
-
-        INTERNAL::GeneralPurposeAllocatorFreeChunk *p_gpafc = &gpafc;
+        byte *addr = bytePointer - offset;
+        size_t size = amountOfBytes + offset;
+        m_stats.onDeallocate(offset, size);
 
-        INTERNAL::GeneralPurposeAllocatorFreeChunk *left;
-        INTERNAL::GeneralPurposeAllocatorFreeChunk *right;
-
-        m_freeChunks.getNeighbors(*p_gpafc, left, right);
-
-        bool didMerge = false;
-
-        if (left != nullptr)
+        // Merge with the touching neighbours (Coalescence)
+        auto right = m_freeChunksByAddress.upper_bound(addr);
+        if (right != m_freeChunksByAddress.begin())
         {
-            if (left->touches(*p_gpafc))
+            auto left = std::prev(right);
+            if (left->first + left->second == addr)
             {
-                left->m_size += p_gpafc->m_size;
-                p_gpafc = left;
-                didMerge = true;
+                addr = left->first;
+                size += left->second;
+                removeFreeChunk(left);
             }
         }
-        if (right != nullptr)
+        if (right != m_freeChunksByAddress.end() && addr + size == right->first)
         {
-            if (right->touches(*p_gpafc))
-            {
-                if (didMerge)
-                {
-                    p_gpafc->m_size += right->m_size;
-                    m_freeChunks.removeSingle(*right);
-                }
-                else
-                {
-                    right->m_size += p_gpafc->m_size;
-                    right->m_addr = p_gpafc->m_addr;
-                }
-                didMerge = true;
-            }
+            size += right->second;
+            removeFreeChunk(right);
         }
 
-        if (!didMerge)
-        {
-            m_freeChunks.pushBack(gpafc);
-        }
+        addFreeChunk(addr, size);
+
+        m_handleTable.release(pointer.m_handleIndex, pointer.m_generation);
+        pointer.m_handleIndex = 0;
+        pointer.m_generation = 0;
+    }
+
+    const HandleTable &getHandleTable() const
+    {
+        return m_handleTable;
+    }
+
+    // Empty unless BBE_ALLOCATOR_STATS is enabled
+    AllocatorStats getStats() const
+    {
+        return m_stats.get();
+    }
 
-        m_unusedHandleStack.push(pointer.m_handleIndex);
-        if (!m_allocatedBlocks.removeSingle(GeneralPurposeAllocatorRelocatable(this, pointer.m_handleIndex)))
+    // O(1), the counters are updated whenever a free chunk is added, split or merged
+    FragmentationStats getFragmentation() const
+    {
+        FragmentationStats fragmentation = m_fragmentation;
+        if (!m_freeChunksBySize.empty())
         {
-            DEBUG_BREAK;
+            fragmentation.m_largestFreeBlock = m_freeChunksBySize.rbegin()->first;
         }
-        pointer.m_handleIndex = 0;
+        return fragmentation;
     }
 
     bool needsDefragmentation()
     {
         // Keine free chunks
-        if (m_freeChunks.getLength() == 0   // oder nur noch einer und dieser am Ende
-                || (m_freeChunks.getLength() == 1 && (m_freeChunks[0].m_addr + m_freeChunks[0].m_size) == (m_data + m_size)))
+        if (m_freeChunksByAddress.empty()   // oder nur noch einer und dieser am Ende
+                || (m_freeChunksByAddress.size() == 1 && (m_freeChunksByAddress.begin()->first + m_freeChunksByAddress.begin()->second) == (m_data + m_size)))
         {
             return false;
         }
@@ -449,30 +464,48 @@ public:
             return false;
         }
 
-        byte* addr = m_freeChunks[0].m_addr;
-        GeneralPurposeAllocatorRelocatable *left;
-        GeneralPurposeAllocatorRelocatable *right;
-        GeneralPurposeAllocatorRelocatable indexLocator(this, addr); // Tue so, als wäre FreeChung eine Allokierung, um Nachbarn zu finden
-        m_allocatedBlocks.getNeighbors(indexLocator, left, right);
+        // Move the first allocation behind a free chunk down, pinned allocations have to stay where they are
+        auto freeChunk = m_freeChunksByAddress.begin();
+        auto right = m_allocatedBlocks.end();
+        for (; freeChunk != m_freeChunksByAddress.end(); ++freeChunk)
+        {
+            right = m_allocatedBlocks.upper_bound(freeChunk->first);
+            if (right != m_allocatedBlocks.end() && !m_handleTable.isPinned(right->second.m_handleIndex))
+            {
+                break;
+            }
+        }
+        if (freeChunk == m_freeChunksByAddress.end())
+        {
+            return false;
+        }
+
+        byte *addr = freeChunk->first;
+        size_t size = freeChunk->second;
+        removeFreeChunk(freeChunk);
+
+        byte oldOffset = static_cast<byte *>(right->first)[-1];
+        byte *newAddr = right->second(addr);
+        byte newOffset = static_cast<byte *>(right->second.getAddr())[-1];
+        m_stats.onRelocate(oldOffset, newOffset);
 
-        byte oldOffset = static_cast<byte*>(right->getAddr())[-1];
-        byte *newAddr = (*right)(addr);
-        byte newOffset = static_cast<byte*>(right->getAddr())[-1];
+        auto node = m_allocatedBlocks.extract(right);
+        node.key() = node.mapped().getAddr();
+        m_allocatedBlocks.insert(std::move(node));
 
-        m_freeChunks[0].m_addr = newAddr;
-        if (newOffset != oldOffset)
+        addr = newAddr;
+        size = size + oldOffset - newOffset;
+
+        auto next = m_freeChunksByAddress.lower_bound(addr);
+        if (next != m_freeChunksByAddress.end() && addr + size == next->first)
         {
-            m_freeChunks[0].m_size += oldOffset;
-            m_freeChunks[0].m_size -= newOffset;
+            size += next->second;
+            removeFreeChunk(next);
         }
 
-        if (m_freeChunks.getLength() > 1)
+        if (size != 0)
         {
-            if(m_freeChunks[0].touches(m_freeChunks[1]))
-            {
-                m_freeChunks[0].m_size += m_freeChunks[1].m_size;
-                m_freeChunks.removeIndex(1);
-            }
+            addFreeChunk(addr, size);
         }
 
         return true;
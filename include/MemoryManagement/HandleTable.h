@@ -0,0 +1,357 @@
+#pragma once
+
+#include "main.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bbe
+{
+
+class HandleTable
+{
+private:
+    // Unused slots don't need the pointer, so they store the index of the next unused slot instead
+    struct Slot
+    {
+        union {
+            void *m_ptr;
+            size_t m_nextUnused;
+        };
+        std::atomic<uint32_t> m_generation; // Read by resolving threads without the lock of the allocator
+        uint32_t m_pinCount;                 // Fits into the padding after the generation
+    };
+
+    // Slots live in fixed size pages which are never moved, only the array of page pointers grows
+    static const size_t PAGE_BITS = 8;
+    static const size_t PAGE_LENGTH = size_t(1) << PAGE_BITS;
+    static const size_t PAGE_MASK = PAGE_LENGTH - 1;
+
+    // Slot 0 is reserved for the null handle, so index 0 can also terminate the list of unused slots
+    static const size_t NO_UNUSED_SLOT = 0;
+
+    // Other threads may resolve handles while the table grows under the lock of the allocator. m_pages and
+    // m_length are published with release after the new page is filled, so a resolving thread which sees an
+    // index below m_length also sees its page. Replaced page arrays are kept alive until the table is destroyed.
+    std::atomic<Slot **> m_pages{nullptr};
+    std::vector<Slot **> m_retiredPages;
+    size_t m_amountOfPages = 0;
+    size_t m_capacityOfPages = 0;
+    std::atomic<size_t> m_length{0};
+    size_t m_maxLength = 0;
+    size_t m_firstUnused = NO_UNUSED_SLOT;
+    size_t m_usedSlots = 0;
+    size_t m_highWaterMark = 0;
+    size_t m_pinnedSlots = 0;
+
+    Slot &slot(size_t index)
+    {
+        return m_pages.load(std::memory_order_acquire)[index >> PAGE_BITS][index & PAGE_MASK];
+    }
+
+    const Slot &slot(size_t index) const
+    {
+        return m_pages.load(std::memory_order_acquire)[index >> PAGE_BITS][index & PAGE_MASK];
+    }
+
+    bool grow()
+    {
+        const size_t length = m_length.load(std::memory_order_relaxed); // Only written under the lock
+        if (length + PAGE_LENGTH > m_maxLength)
+        {
+            return false;
+        }
+
+        if (m_amountOfPages == m_capacityOfPages)
+        {
+            size_t newCapacityOfPages = (m_capacityOfPages == 0) ? 4 : m_capacityOfPages * 2;
+            Slot **oldPages = m_pages.load(std::memory_order_relaxed);
+            Slot **newPages = new Slot *[newCapacityOfPages];
+            for (size_t i = 0; i < m_amountOfPages; i++)
+            {
+                newPages[i] = oldPages[i];
+            }
+            m_pages.store(newPages, std::memory_order_release);
+            if (oldPages != nullptr)
+            {
+                m_retiredPages.push_back(oldPages);
+            }
+            m_capacityOfPages = newCapacityOfPages;
+        }
+
+        Slot *page = new Slot[PAGE_LENGTH];
+        m_pages.load(std::memory_order_relaxed)[m_amountOfPages] = page;
+        m_amountOfPages++;
+
+        const size_t firstIndex = length;
+
+        // The new slots are put in front of the unused list in ascending order
+        for (size_t i = (firstIndex == 0) ? 1 : 0; i < PAGE_LENGTH; i++)
+        {
+            page[i].m_nextUnused = (i + 1 < PAGE_LENGTH) ? firstIndex + i + 1 : m_firstUnused;
+            page[i].m_generation.store(0, std::memory_order_relaxed);
+            page[i].m_pinCount = 0;
+        }
+        m_firstUnused = (firstIndex == 0) ? 1 : firstIndex;
+
+        if (firstIndex == 0)
+        {
+            page[0].m_ptr = nullptr;
+            page[0].m_generation.store(0, std::memory_order_relaxed);
+            page[0].m_pinCount = 0;
+        }
+
+        m_length.store(length + PAGE_LENGTH, std::memory_order_release);
+        return true;
+    }
+
+public:
+    static const size_t UNLIMITED_LENGTH = size_t(-1);
+
+    // Both lengths are rounded up to whole pages, the table grows page by page up to maxLength
+    explicit HandleTable(size_t initialLength, size_t maxLength = UNLIMITED_LENGTH)
+        : m_maxLength(maxLength)
+    {
+        if (m_maxLength < PAGE_LENGTH)
+        {
+            m_maxLength = PAGE_LENGTH; // The first page holds the null handle
+        }
+        else if (m_maxLength != UNLIMITED_LENGTH)
+        {
+            m_maxLength = (m_maxLength + PAGE_MASK) & ~PAGE_MASK;
+        }
+
+        do
+        {
+            grow();
+        } while (getLength() < initialLength && getLength() < m_maxLength);
+    }
+
+    HandleTable(const HandleTable &other) = delete;
+    HandleTable(HandleTable &&other) = delete;
+    HandleTable &operator=(const HandleTable &other) = delete;
+    HandleTable &operator=(HandleTable &&other) = delete;
+
+    ~HandleTable()
+    {
+        Slot **pages = m_pages.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < m_amountOfPages; i++)
+        {
+            delete[] pages[i];
+        }
+        delete[] pages;
+        m_pages.store(nullptr, std::memory_order_relaxed);
+
+        for (size_t i = 0; i < m_retiredPages.size(); i++)
+        {
+            delete[] m_retiredPages[i];
+        }
+    }
+
+    // True if acquire would fail, because all slots are used and the table can't grow anymore
+    bool isFull() const
+    {
+        return m_firstUnused == NO_UNUSED_SLOT && getLength() + PAGE_LENGTH > m_maxLength;
+    }
+
+    size_t getLength() const
+    {
+        return m_length.load(std::memory_order_acquire);
+    }
+
+    size_t getUsedSlots() const
+    {
+        return m_usedSlots;
+    }
+
+    // Most slots that were used at the same time, use it to size initialLength
+    size_t getHighWaterMark() const
+    {
+        return m_highWaterMark;
+    }
+
+    // Returns NO_UNUSED_SLOT (the null handle) if the table is full
+    size_t acquire(void *ptr)
+    {
+        if (m_firstUnused == NO_UNUSED_SLOT && !grow())
+        {
+            return NO_UNUSED_SLOT;
+        }
+
+        size_t index = m_firstUnused;
+        m_firstUnused = slot(index).m_nextUnused;
+        slot(index).m_ptr = ptr;
+        m_usedSlots++;
+        if (m_usedSlots > m_highWaterMark)
+        {
+            m_highWaterMark = m_usedSlots;
+        }
+
+        return index;
+    }
+
+    void release(size_t index, uint32_t generation)
+    {
+        if (index == 0 || !isValid(index, generation) || slot(index).m_pinCount != 0)
+        {
+            // Null handle, handle was already released or is still pinned
+            DEBUG_BREAK;
+            return;
+        }
+
+        // Invalidates every handle still pointing to this slot
+        slot(index).m_generation.fetch_add(1, std::memory_order_release);
+        slot(index).m_nextUnused = m_firstUnused;
+        m_firstUnused = index;
+        m_usedSlots--;
+    }
+
+    bool isValid(size_t index, uint32_t generation) const
+    {
+        return index < getLength() && slot(index).m_generation.load(std::memory_order_acquire) == generation;
+    }
+
+    uint32_t getGeneration(size_t index) const
+    {
+        return slot(index).m_generation.load(std::memory_order_acquire);
+    }
+
+    void *get(size_t index, uint32_t generation) const
+    {
+#ifndef NDEBUG
+        if (!isValid(index, generation))
+        {
+            // Stale handle, the allocation was freed and the slot may already be reused
+            DEBUG_BREAK;
+        }
+#endif
+        return slot(index).m_ptr;
+    }
+
+    void set(size_t index, uint32_t generation, void *ptr)
+    {
+#ifndef NDEBUG
+        if (!isValid(index, generation))
+        {
+            DEBUG_BREAK;
+        }
+#endif
+        slot(index).m_ptr = ptr;
+    }
+
+    // While pinned, the owning allocator must not relocate the data of the slot
+    void *pin(size_t index, uint32_t generation)
+    {
+        void *ptr = get(index, generation);
+        slot(index).m_pinCount++;
+        m_pinnedSlots += (slot(index).m_pinCount == 1) ? 1 : 0;
+        return ptr;
+    }
+
+    void unpin(size_t index)
+    {
+        if (slot(index).m_pinCount == 0)
+        {
+            DEBUG_BREAK;
+            return;
+        }
+        slot(index).m_pinCount--;
+        m_pinnedSlots -= (slot(index).m_pinCount == 0) ? 1 : 0;
+    }
+
+    bool isPinned(size_t index) const
+    {
+        return slot(index).m_pinCount != 0;
+    }
+
+    size_t getPinnedSlots() const
+    {
+        return m_pinnedSlots;
+    }
+
+    // Unchecked access for the owning allocator, which tracks its live slots itself
+    void *&operator[](size_t index)
+    {
+        return slot(index).m_ptr;
+    }
+
+    void *operator[](size_t index) const
+    {
+        return slot(index).m_ptr;
+    }
+};
+
+// Resolves a handle once and keeps the data at its address until it goes out of scope,
+// so hot loops can work on a raw pointer instead of going through the handle table for every access
+template <typename T>
+class Pinned
+{
+private:
+    HandleTable *m_table;
+    size_t m_index;
+    T *m_data;
+    size_t m_length;
+
+public:
+    Pinned(HandleTable &table, size_t index, uint32_t generation, size_t length)
+        : m_table(&table), m_index(index), m_data(static_cast<T *>(table.pin(index, generation))), m_length(length)
+    {
+    }
+
+    Pinned(const Pinned &other) = delete;
+    Pinned &operator=(const Pinned &other) = delete;
+    Pinned &operator=(Pinned &&other) = delete;
+
+    Pinned(Pinned &&other)
+        : m_table(other.m_table), m_index(other.m_index), m_data(other.m_data), m_length(other.m_length)
+    {
+        other.m_table = nullptr;
+    }
+
+    ~Pinned()
+    {
+        if (m_table != nullptr)
+        {
+            m_table->unpin(m_index);
+        }
+    }
+
+    T *getRaw() const
+    {
+        return m_data;
+    }
+
+    size_t getLength() const
+    {
+        return m_length;
+    }
+
+    T *begin() const
+    {
+        return m_data;
+    }
+
+    T *end() const
+    {
+        return m_data + m_length;
+    }
+
+    T *operator->() const
+    {
+        return m_data;
+    }
+
+    T &operator*() const
+    {
+        return *m_data;
+    }
+
+    T &operator[](size_t index) const
+    {
+        return m_data[index];
+    }
+};
+
+} // namespace bbe
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "main.h"
+#include "AllocatorStats.h"
+#include <atomic>
 #include <memory> // Sollte gekapselt sein (Fremd API)
+#include <thread>
 
 namespace bbe
 {
@@ -15,7 +18,7 @@ union PoolChunk {
     ~PoolChunk(){};
 };
 
-template <typename T, typename Allocator = std::allocator<PoolChunk<T>>>
+template <typename T, typename Allocator = std::allocator<PoolChunk<T>>, typename StatsPolicy = DefaultAllocatorStatsPolicy>
 class PoolAllocator
 {
 private:
@@ -30,9 +33,35 @@ private:
     Allocator *m_parentAllocator = nullptr;
     bool m_needsToDeleteParentAllocator = false;
 
+    // Chunks deallocated by other threads than the owner are pushed here (lock-free, multiple producers)
+    // and taken over by the owner as a whole, when its own list of free chunks runs empty
+    std::thread::id m_ownerThread;
+    std::atomic<PoolChunk<T> *> m_remoteHead{nullptr};
+
+    BBE_NO_UNIQUE_ADDRESS StatsPolicy m_stats; // Owner thread only, remote frees are counted when they are drained
+
+    size_t drainRemoteFrees()
+    {
+        PoolChunk<T> *remoteHead = m_remoteHead.exchange(nullptr, std::memory_order_acquire);
+        size_t amount = 0;
+
+        while (remoteHead != nullptr)
+        {
+            PoolChunk<T> *next = remoteHead->nextPoolChunk;
+            remoteHead->nextPoolChunk = m_head;
+            m_head = remoteHead;
+            remoteHead = next;
+            amount++;
+            m_stats.onDeallocate(sizeof(PoolChunk<T>) - sizeof(T), sizeof(PoolChunk<T>));
+        }
+
+        m_openAllocations -= amount;
+        return amount;
+    }
+
 public:
     explicit PoolAllocator(size_t size = POOL_ALLOCATOR_DEFAULT_SIZE, Allocator *parentAllocator = nullptr)
-        : m_size(size), m_parentAllocator(parentAllocator)
+        : m_size(size), m_parentAllocator(parentAllocator), m_ownerThread(std::this_thread::get_id())
     {
         if (parentAllocator == nullptr)
         {
@@ -57,6 +86,8 @@ public:
 
     ~PoolAllocator()
     {
+        drainRemoteFrees();
+
         if (m_openAllocations != 0)
         {
             // TODO: Error Handling
@@ -77,13 +108,16 @@ public:
     template <typename... arguments>
     T *allocate(arguments &&... args)
     {
-        if (m_head == nullptr)
+        if (m_head == nullptr && drainRemoteFrees() == 0)
         {
+            m_stats.onFailedAllocation();
             DEBUG_BREAK;
             return nullptr;
         }
 
         m_openAllocations++;
+        // Chunks of small objects are padded to the size of the free list pointer
+        m_stats.onAllocate(sizeof(T), sizeof(PoolChunk<T>) - sizeof(T), sizeof(PoolChunk<T>));
 
         PoolChunk<T> *poolChunk = m_head;
         m_head = m_head->nextPoolChunk;
@@ -92,16 +126,47 @@ public:
         return retVal;
     }
 
+    // Can be called from any thread, allocate only from the thread which created the pool
     void deallocate(T *data)
     {
         // TODO: What if data is not part of m_data
-        m_openAllocations--;
-
         data->~T();
         PoolChunk<T> *poolChunk = reinterpret_cast<PoolChunk<T> *>(data);
+
+        if (std::this_thread::get_id() != m_ownerThread)
+        {
+            poolChunk->nextPoolChunk = m_remoteHead.load(std::memory_order_relaxed);
+            while (!m_remoteHead.compare_exchange_weak(poolChunk->nextPoolChunk, poolChunk, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+            return;
+        }
+
+        m_openAllocations--;
+        m_stats.onDeallocate(sizeof(PoolChunk<T>) - sizeof(T), sizeof(PoolChunk<T>));
+
         poolChunk->nextPoolChunk = m_head;
         m_head = poolChunk;
     }
+
+    // False if allocate would fail, because all chunks are in use. Owner thread only.
+    bool hasFreeChunks() const
+    {
+        return m_head != nullptr || m_remoteHead.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    // Makes the current thread the owner, e.g. after the pool was handed over to a worker thread
+    void setOwnerThread()
+    {
+        drainRemoteFrees();
+        m_ownerThread = std::this_thread::get_id();
+    }
+
+    // Empty unless the StatsPolicy tracks. Owner thread only.
+    AllocatorStats getStats() const
+    {
+        return m_stats.get();
+    }
 };
 
 } // namespace bbe
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "main.h"
+#include "AllocatorStats.h"
 #include <memory>
 #include <vector>
 #include "Util/UtilMath.h"
@@ -37,9 +38,11 @@ class StackAllocatorMarker
 public:
     byte *m_markerValue;
     size_t m_destructorHandle;
+    BBE_NO_UNIQUE_ADDRESS DefaultAllocatorStatsPolicy::Checkpoint m_statsCheckpoint;
 
-    StackAllocatorMarker(byte *markerValue, size_t destructorHandle)
-        : m_markerValue(markerValue), m_destructorHandle(destructorHandle)
+    StackAllocatorMarker(byte *markerValue, size_t destructorHandle,
+                         DefaultAllocatorStatsPolicy::Checkpoint statsCheckpoint = DefaultAllocatorStatsPolicy::Checkpoint())
+        : m_markerValue(markerValue), m_destructorHandle(destructorHandle), m_statsCheckpoint(statsCheckpoint)
     {
     }
 };
@@ -54,6 +57,8 @@ private:
 
     std::vector<StackAllocatorDestructor> destructors;
 
+    BBE_NO_UNIQUE_ADDRESS DefaultAllocatorStatsPolicy m_stats;
+
     template <typename T>
     inline typename std::enable_if<std::is_trivially_destructible<T>::value>::type
     addDestructorToList(T *object)
@@ -100,12 +105,14 @@ public:
 
         if (newHeadPointer <= m_data + m_size)
         {
+            m_stats.onAllocate(amountOfBytes, allocationLocation - m_head);
             m_head = newHeadPointer;
             return allocationLocation;
         }
         else
         {
             // TODO: add further error handling
+            m_stats.onFailedAllocation();
             return nullptr;
         }
     }
@@ -119,6 +126,7 @@ public:
         if (newHeadPointer <= m_data + m_size)
         {
             T *returnPointer = reinterpret_cast<T *>(allocationLocation);
+            m_stats.onAllocate(amountOfObjects * sizeof(T), allocationLocation - m_head);
             m_head = newHeadPointer;
             for (size_t i = 0; i < amountOfObjects; i++)
             {
@@ -130,18 +138,20 @@ public:
         else
         {
             // TODO: add further error handling
+            m_stats.onFailedAllocation();
             return nullptr;
         }
     }
 
     StackAllocatorMarker getMarker()
     {
-        return StackAllocatorMarker(m_head, destructors.size());
+        return StackAllocatorMarker(m_head, destructors.size(), m_stats.getCheckpoint());
     }
 
     void deallocateToMarker(StackAllocatorMarker sam)
     {
         m_head = sam.m_markerValue;
+        m_stats.onRewind(sam.m_statsCheckpoint);
         while (destructors.size() > sam.m_destructorHandle)
         {
             destructors.back()();
@@ -152,12 +162,19 @@ public:
     void deallocateAll()
     {
         m_head = m_data;
+        m_stats.onReset();
         while (destructors.size() > 0)
         {
             destructors.back()();
             destructors.pop_back();
         }
     }
+
+    // Empty unless BBE_ALLOCATOR_STATS is enabled
+    AllocatorStats getStats() const
+    {
+        return m_stats.get();
+    }
 };
 
 } // namespace bbe
\ No newline at end of file
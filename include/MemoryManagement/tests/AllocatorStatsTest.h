@@ -0,0 +1,153 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <type_traits>
+
+#include "../AllocatorStats.h"
+#include "../BitmapPoolAllocator.h"
+#include "../GeneralPurposeAllocator.h"
+#include "../PoolAllocator.h"
+#include "../StackAllocator.h"
+
+namespace bbe
+{
+
+TEST(AllocatorStatsTest, HistogramBuckets)
+{
+    EXPECT_EQ(AllocatorStats::getHistogramBucket(0), 0);
+    EXPECT_EQ(AllocatorStats::getHistogramBucket(1), 0);
+    EXPECT_EQ(AllocatorStats::getHistogramBucket(2), 1);
+    EXPECT_EQ(AllocatorStats::getHistogramBucket(3), 1);
+    EXPECT_EQ(AllocatorStats::getHistogramBucket(1024), 10);
+    EXPECT_EQ(AllocatorStats::getHistogramBucket((size_t)-1), ALLOCATOR_STATS_HISTOGRAM_BUCKETS - 1);
+}
+
+TEST(AllocatorStatsTest, NoAllocatorStatsIsEmpty)
+{
+    EXPECT_TRUE(std::is_empty<NoAllocatorStats>::value);
+
+    // Stored like the allocators store their policy, it mustn't add padding
+    struct WithoutStats
+    {
+        void *m_pointer;
+        BBE_NO_UNIQUE_ADDRESS NoAllocatorStats m_stats;
+    };
+    EXPECT_EQ(sizeof(WithoutStats), sizeof(void *));
+
+    PoolAllocator<uint64_t, std::allocator<PoolChunk<uint64_t>>, NoAllocatorStats> pool(4);
+    pool.deallocate(pool.allocate(1));
+    EXPECT_EQ(pool.getStats().m_allocations, 0);
+}
+
+TEST(AllocatorStatsTest, PoolAllocator)
+{
+    PoolAllocator<uint32_t, std::allocator<PoolChunk<uint32_t>>, TrackAllocatorStats> pool(3);
+    uint32_t *a = pool.allocate(1);
+    uint32_t *b = pool.allocate(2);
+    pool.deallocate(a);
+    uint32_t *c = pool.allocate(3);
+    uint32_t *d = pool.allocate(4);
+
+    AllocatorStats stats = pool.getStats();
+    EXPECT_EQ(stats.m_allocations, 4);
+    EXPECT_EQ(stats.m_deallocations, 1);
+    EXPECT_EQ(stats.m_openAllocations, 3);
+    EXPECT_EQ(stats.m_peakOpenAllocations, 3);
+    EXPECT_EQ(stats.m_usedMemory, 3 * sizeof(PoolChunk<uint32_t>));
+    EXPECT_EQ(stats.m_alignmentWaste, 3 * (sizeof(PoolChunk<uint32_t>) - sizeof(uint32_t)));
+    EXPECT_EQ(stats.m_sizeHistogram[AllocatorStats::getHistogramBucket(sizeof(uint32_t))], 4);
+
+    pool.deallocate(b);
+    pool.deallocate(c);
+    pool.deallocate(d);
+    stats = pool.getStats();
+    EXPECT_EQ(stats.m_usedMemory, 0);
+    EXPECT_EQ(stats.m_alignmentWaste, 0);
+    EXPECT_EQ(stats.m_peakUsedMemory, 3 * sizeof(PoolChunk<uint32_t>));
+}
+
+TEST(AllocatorStatsTest, BitmapPoolAllocator)
+{
+    BitmapPoolAllocator<uint64_t, std::allocator<BitmapPoolChunk<uint64_t>>, TrackAllocatorStats> pool(100);
+    for (int i = 0; i < 10; i++)
+    {
+        pool.allocate(i);
+    }
+    pool.clear();
+
+    AllocatorStats stats = pool.getStats();
+    EXPECT_EQ(stats.m_allocations, 10);
+    EXPECT_EQ(stats.m_deallocations, 10);
+    EXPECT_EQ(stats.m_openAllocations, 0);
+    EXPECT_EQ(stats.m_peakOpenAllocations, 10);
+    EXPECT_EQ(stats.m_peakUsedMemory, 10 * sizeof(BitmapPoolChunk<uint64_t>));
+}
+
+#if BBE_ALLOCATOR_STATS
+TEST(AllocatorStatsTest, StackAllocator)
+{
+    StackAllocator stack(256);
+    stack.allocate(3);
+    StackAllocatorMarker marker = stack.getMarker();
+    stack.allocateObject<uint64_t>(4); // 5 bytes padding behind the 3 bytes
+    stack.allocate(100, 16);
+
+    AllocatorStats stats = stack.getStats();
+    EXPECT_EQ(stats.m_openAllocations, 3);
+    EXPECT_GE(stats.m_alignmentWaste, 5);
+    EXPECT_EQ(stats.m_sizeHistogram[AllocatorStats::getHistogramBucket(32)], 1);
+    EXPECT_EQ(stats.m_sizeHistogram[AllocatorStats::getHistogramBucket(100)], 1);
+
+    EXPECT_EQ(stack.allocate(1000), nullptr);
+    EXPECT_EQ(stack.getStats().m_failedAllocations, 1);
+
+    stack.deallocateToMarker(marker);
+    stats = stack.getStats();
+    EXPECT_EQ(stats.m_openAllocations, 1);
+    EXPECT_EQ(stats.m_deallocations, 2);
+    EXPECT_EQ(stats.m_usedMemory, 3);
+    EXPECT_EQ(stats.m_peakOpenAllocations, 3);
+
+    stack.deallocateAll();
+    stats = stack.getStats();
+    EXPECT_EQ(stats.m_openAllocations, 0);
+    EXPECT_EQ(stats.m_usedMemory, 0);
+    EXPECT_EQ(stats.m_alignmentWaste, 0);
+    EXPECT_EQ(stats.m_deallocations, 3);
+}
+
+TEST(AllocatorStatsTest, GeneralPurposeAllocator)
+{
+    GeneralPurposeAllocator gpa(256);
+    auto a = gpa.allocateObjects<uint8_t>(3);
+    auto b = gpa.allocateObjects<uint64_t>(2);
+    auto c = gpa.allocateObjects<uint8_t>(5);
+
+    AllocatorStats stats = gpa.getStats();
+    EXPECT_EQ(stats.m_allocations, 3);
+    EXPECT_GE(stats.m_alignmentWaste, 3); // At least the offset byte in front of every allocation
+    EXPECT_EQ(stats.m_usedMemory, 3 + 16 + 5 + stats.m_alignmentWaste);
+
+    EXPECT_FALSE(gpa.allocateObjects<uint8_t>(1000).isValid());
+    EXPECT_EQ(gpa.getStats().m_failedAllocations, 1);
+
+    // Moving c down into the hole of a changes its padding
+    gpa.deallocateObjects(a);
+    while (gpa.defragment())
+    {
+    }
+    gpa.deallocateObjects(b);
+    stats = gpa.getStats();
+    EXPECT_EQ(stats.m_openAllocations, 1);
+    EXPECT_EQ(stats.m_usedMemory, 5 + stats.m_alignmentWaste);
+
+    gpa.deallocateObjects(c);
+    stats = gpa.getStats();
+    EXPECT_EQ(stats.m_usedMemory, 0);
+    EXPECT_EQ(stats.m_alignmentWaste, 0);
+    EXPECT_EQ(stats.m_deallocations, 3);
+}
+#endif
+
+} // namespace bbe
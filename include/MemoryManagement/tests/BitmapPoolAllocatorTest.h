@@ -0,0 +1,202 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../BitmapPoolAllocator.h"
+#include "../PoolAllocator.h"
+
+namespace bbe
+{
+
+TEST(BitmapPoolAllocatorTest, LowestFreeChunkFirst)
+{
+    const size_t AMOUNT = 1000; // Not a multiple of 64
+    BitmapPoolAllocator<size_t> pool(AMOUNT);
+    std::vector<size_t *> data;
+
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        data.push_back(pool.allocate(i));
+        ASSERT_NE(data[i], nullptr);
+        if (i > 0)
+        {
+            EXPECT_EQ(data[i], data[i - 1] + 1);
+        }
+    }
+    EXPECT_FALSE(pool.hasFreeChunks());
+
+    pool.deallocate(data[700]);
+    pool.deallocate(data[3]);
+    pool.deallocate(data[999]);
+
+    // The free chunks are handed out again from the lowest address up
+    EXPECT_EQ(pool.allocate((size_t)0), data[3]);
+    EXPECT_EQ(pool.allocate((size_t)0), data[700]);
+    EXPECT_EQ(pool.allocate((size_t)0), data[999]);
+
+    pool.clear();
+    EXPECT_EQ(pool.getOpenAllocations(), 0);
+}
+
+TEST(BitmapPoolAllocatorTest, IteratesLiveObjectsInAddressOrder)
+{
+    const size_t AMOUNT = 5000;
+    BitmapPoolAllocator<size_t> pool(AMOUNT);
+    std::vector<size_t *> data;
+    std::mt19937 random(3);
+
+    EXPECT_TRUE(pool.begin() == pool.end());
+
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        data.push_back(pool.allocate(i));
+    }
+    std::shuffle(data.begin(), data.end(), random);
+    for (size_t i = 0; i < AMOUNT / 2; i++)
+    {
+        EXPECT_TRUE(pool.isAllocated(data[i]));
+        pool.deallocate(data[i]);
+        EXPECT_FALSE(pool.isAllocated(data[i]));
+    }
+
+    std::vector<size_t *> live(data.begin() + AMOUNT / 2, data.end());
+    std::sort(live.begin(), live.end());
+
+    std::vector<size_t *> iterated;
+    for (size_t &value : pool)
+    {
+        iterated.push_back(&value);
+    }
+    EXPECT_EQ(iterated, live);
+
+    iterated.clear();
+    pool.forEach([&](size_t &value) { iterated.push_back(&value); });
+    EXPECT_EQ(iterated, live);
+
+    pool.clear();
+    EXPECT_TRUE(pool.begin() == pool.end());
+}
+
+TEST(BitmapPoolAllocatorTest, ClearDestroysObjects)
+{
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    BitmapPoolAllocator<std::shared_ptr<int>> pool(100);
+    for (int i = 0; i < 70; i++)
+    {
+        pool.allocate(shared);
+    }
+    EXPECT_EQ(shared.use_count(), 71);
+
+    pool.clear();
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+struct BitmapPoolBenchmarkObject
+{
+    float m_position[3];
+    float m_velocity[3];
+    uint64_t m_id;
+};
+
+template <typename Pool>
+static double benchmarkAllocateDeallocate(size_t amount, std::vector<BitmapPoolBenchmarkObject *> &objects)
+{
+    Pool pool(amount);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < 10; round++)
+    {
+        for (size_t i = 0; i < amount; i++)
+        {
+            objects[i] = pool.allocate();
+        }
+        for (size_t i = 0; i < amount; i++)
+        {
+            pool.deallocate(objects[i]);
+        }
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (10 * amount);
+}
+
+// Frees a random half, allocates it again a few times and then updates everything that is alive.
+// The free-list pool has to be walked through an external list of its objects.
+template <typename Pool, typename Iterate>
+static void benchmarkChurn(const char *name, size_t amount, Iterate iterate)
+{
+    Pool pool(amount);
+    std::vector<BitmapPoolBenchmarkObject *> objects(amount);
+    std::mt19937 random(42);
+
+    for (size_t i = 0; i < amount; i++)
+    {
+        objects[i] = pool.allocate();
+    }
+    for (size_t round = 0; round < 4; round++)
+    {
+        std::shuffle(objects.begin(), objects.end(), random);
+        for (size_t i = 0; i < amount / 2; i++)
+        {
+            pool.deallocate(objects[i]);
+        }
+        for (size_t i = 0; i < amount / 2; i++)
+        {
+            objects[i] = pool.allocate();
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    float sum = 0;
+    for (size_t round = 0; round < 10; round++)
+    {
+        sum += iterate(pool, objects);
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    (void)sum;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+        pool.deallocate(objects[i]);
+    }
+
+    GTEST_COUT << name << ", " << amount << " objects: iterate after churn " << elapsed / (10 * amount) << "ns per object" << std::endl;
+}
+
+static float updateObject(BitmapPoolBenchmarkObject &object)
+{
+    object.m_position[0] += object.m_velocity[0];
+    return object.m_position[0];
+}
+
+TEST(BitmapPoolAllocatorBenchmark, AgainstFreeListPool)
+{
+    for (size_t amount = 10000; amount <= 1000000; amount *= 10)
+    {
+        std::vector<BitmapPoolBenchmarkObject *> objects(amount);
+        GTEST_COUT << amount << " objects: allocate + deallocate, bitmap " << benchmarkAllocateDeallocate<BitmapPoolAllocator<BitmapPoolBenchmarkObject>>(amount, objects)
+                   << "ns, free list " << benchmarkAllocateDeallocate<PoolAllocator<BitmapPoolBenchmarkObject>>(amount, objects) << "ns" << std::endl;
+
+        benchmarkChurn<BitmapPoolAllocator<BitmapPoolBenchmarkObject>>("Bitmap pool, forEach", amount,
+            [](BitmapPoolAllocator<BitmapPoolBenchmarkObject> &pool, std::vector<BitmapPoolBenchmarkObject *> &) {
+                float sum = 0;
+                pool.forEach([&](BitmapPoolBenchmarkObject &object) { sum += updateObject(object); });
+                return sum;
+            });
+        benchmarkChurn<PoolAllocator<BitmapPoolBenchmarkObject>>("Free list pool, pointer list", amount,
+            [](PoolAllocator<BitmapPoolBenchmarkObject> &, std::vector<BitmapPoolBenchmarkObject *> &objects) {
+                float sum = 0;
+                for (BitmapPoolBenchmarkObject *object : objects)
+                {
+                    sum += updateObject(*object);
+                }
+                return sum;
+            });
+    }
+}
+
+} // namespace bbe
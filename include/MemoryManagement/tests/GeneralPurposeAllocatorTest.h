@@ -0,0 +1,229 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "../GeneralPurposeAllocator.h"
+
+namespace bbe
+{
+
+struct GeneralPurposeAllocatorTest : testing::Test
+{
+    GeneralPurposeAllocator *m_allocator;
+    const size_t MEMORY_SIZE = 1024;
+    const size_t HANDLE_TABLE_LENGTH = 16;
+
+    GeneralPurposeAllocatorTest()
+    {
+        m_allocator = new GeneralPurposeAllocator(MEMORY_SIZE, HANDLE_TABLE_LENGTH);
+    }
+
+    virtual ~GeneralPurposeAllocatorTest()
+    {
+        EXPECT_FALSE(m_allocator->needsDefragmentation());
+        delete m_allocator;
+    }
+};
+
+TEST_F(GeneralPurposeAllocatorTest, AllocateObjects)
+{
+    auto p1 = m_allocator->allocateObjects<uint32_t>(1, 242);
+    auto p2 = m_allocator->allocateObjects<TestClass>(2, 23, "Test");
+    EXPECT_EQ(*p1, 242);
+    EXPECT_EQ(p2[0].m_count, 23);
+    EXPECT_EQ(p2[1].m_name, "Test");
+
+    m_allocator->deallocateObjects(p2);
+    m_allocator->deallocateObjects(p1);
+}
+
+TEST_F(GeneralPurposeAllocatorTest, DeallocateMergesNeighbours)
+{
+    auto p1 = m_allocator->allocateObjects<char>(100);
+    auto p2 = m_allocator->allocateObjects<char>(100);
+    auto p3 = m_allocator->allocateObjects<char>(100);
+
+    m_allocator->deallocateObjects(p2);
+    m_allocator->deallocateObjects(p1);
+    m_allocator->deallocateObjects(p3);
+
+    // Only possible if all free chunks were merged into one again (1 byte is used for the offset)
+    auto full = m_allocator->allocateObjects<char>(MEMORY_SIZE - 1);
+    EXPECT_NE(full, nullptr);
+    m_allocator->deallocateObjects(full);
+}
+
+TEST_F(GeneralPurposeAllocatorTest, AllocateWhenExhausted)
+{
+    auto p1 = m_allocator->allocateObjects<char>(MEMORY_SIZE - 1);
+    auto p2 = m_allocator->allocateObjects<char>(1);
+    EXPECT_EQ(p2, nullptr);
+
+    m_allocator->deallocateObjects(p1);
+}
+
+TEST_F(GeneralPurposeAllocatorTest, StaleHandle)
+{
+    auto p1 = m_allocator->allocateObjects<uint32_t>(1, 1);
+    auto stale = p1;
+    EXPECT_TRUE(stale.isValid());
+
+    m_allocator->deallocateObjects(p1);
+    EXPECT_FALSE(stale.isValid());
+
+    // Reuses the handle slot of p1, but must not make the old handle valid again
+    auto p2 = m_allocator->allocateObjects<uint32_t>(1, 2);
+    EXPECT_TRUE(p2.isValid());
+    EXPECT_FALSE(stale.isValid());
+
+    m_allocator->deallocateObjects(p2);
+}
+
+TEST_F(GeneralPurposeAllocatorTest, CompactHandle)
+{
+    HandleTableRegistry::registerTable(1, &m_allocator->getHandleTable());
+
+    auto p1 = m_allocator->allocateObjects<uint32_t>(2, 7);
+    auto compact = p1.toCompact<1>();
+    EXPECT_EQ(sizeof(compact), 4);
+    EXPECT_TRUE(compact.isValid());
+    EXPECT_EQ(compact[1], 7);
+
+    m_allocator->deallocateObjects(p1);
+    EXPECT_FALSE(compact.isValid());
+
+    HandleTableRegistry::unregisterTable(1);
+}
+
+TEST_F(GeneralPurposeAllocatorTest, Defragment)
+{
+    auto p1 = m_allocator->allocateObjects<TestClass>(2, 1, "Test 1");
+    auto p2 = m_allocator->allocateObjects<char>(3);
+    auto p3 = m_allocator->allocateObjects<TestClass>(1, 3, "Test 3");
+
+    m_allocator->deallocateObjects(p2);
+    EXPECT_TRUE(m_allocator->needsDefragmentation());
+
+    while (m_allocator->defragment())
+    {
+    }
+
+    EXPECT_EQ(p1[1].m_name, "Test 1");
+    EXPECT_EQ(p3->m_count, 3);
+    EXPECT_EQ(p3->m_name, "Test 3");
+
+    m_allocator->deallocateObjects(p3);
+    m_allocator->deallocateObjects(p1);
+}
+
+TEST_F(GeneralPurposeAllocatorTest, PinBlocksDefragment)
+{
+    auto p1 = m_allocator->allocateObjects<uint32_t>(4, 1);
+    auto p2 = m_allocator->allocateObjects<uint32_t>(4, 2);
+    auto p3 = m_allocator->allocateObjects<uint32_t>(4, 3);
+    m_allocator->deallocateObjects(p2);
+
+    {
+        auto pinned = p3.pin();
+        uint32_t *addr = pinned.getRaw();
+        EXPECT_EQ(pinned.getLength(), 4);
+
+        EXPECT_FALSE(m_allocator->defragment());
+        EXPECT_EQ(p3.getRaw(), addr);
+    }
+
+    EXPECT_TRUE(m_allocator->defragment());
+    EXPECT_EQ(p3[3], 3);
+
+    m_allocator->deallocateObjects(p3);
+    m_allocator->deallocateObjects(p1);
+}
+
+TEST_F(GeneralPurposeAllocatorTest, Fragmentation)
+{
+    FragmentationStats fragmentation = m_allocator->getFragmentation();
+    EXPECT_EQ(fragmentation.m_freeBlocks, 1);
+    EXPECT_EQ(fragmentation.m_largestFreeBlock, MEMORY_SIZE);
+    EXPECT_EQ(fragmentation.getExternalFragmentation(), 0.0);
+
+    // Every allocation takes 101 bytes with its offset byte
+    auto p1 = m_allocator->allocateObjects<char>(100);
+    auto p2 = m_allocator->allocateObjects<char>(100);
+    auto p3 = m_allocator->allocateObjects<char>(100);
+    m_allocator->deallocateObjects(p2);
+
+    fragmentation = m_allocator->getFragmentation();
+    EXPECT_EQ(fragmentation.m_freeBlocks, 2);
+    EXPECT_EQ(fragmentation.m_freeMemory, MEMORY_SIZE - 202);
+    EXPECT_EQ(fragmentation.m_largestFreeBlock, MEMORY_SIZE - 303);
+    EXPECT_EQ(fragmentation.getRecoverableBytes(), 101);
+    EXPECT_DOUBLE_EQ(fragmentation.getExternalFragmentation(), 101.0 / (MEMORY_SIZE - 202));
+    EXPECT_EQ(fragmentation.m_freeBlockHistogram[AllocatorStats::getHistogramBucket(101)], 1);
+
+    // Merged with the hole of p2
+    m_allocator->deallocateObjects(p1);
+    fragmentation = m_allocator->getFragmentation();
+    EXPECT_EQ(fragmentation.m_freeBlocks, 2);
+    EXPECT_EQ(fragmentation.getRecoverableBytes(), 202);
+
+    while (m_allocator->defragment())
+    {
+    }
+    fragmentation = m_allocator->getFragmentation();
+    EXPECT_EQ(fragmentation.m_freeBlocks, 1);
+    EXPECT_EQ(fragmentation.getRecoverableBytes(), 0);
+
+    m_allocator->deallocateObjects(p3);
+    EXPECT_EQ(m_allocator->getFragmentation().m_freeMemory, MEMORY_SIZE);
+}
+
+TEST(GeneralPurposeAllocatorBenchmark, LiveAllocations100k)
+{
+    const size_t LIVE_ALLOCATIONS = 100000;
+    GeneralPurposeAllocator *allocator = new GeneralPurposeAllocator(LIVE_ALLOCATIONS * 32, LIVE_ALLOCATIONS + 1);
+    std::vector<GeneralPurposeAllocator::GeneralPurposeAllocatorPointer<uint64_t>> pointers;
+    pointers.reserve(LIVE_ALLOCATIONS);
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> amount(1, 4);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < LIVE_ALLOCATIONS; i++)
+    {
+        pointers.push_back(allocator->allocateObjects<uint64_t>(amount(random), i));
+        ASSERT_NE(pointers.back(), nullptr);
+    }
+    auto allocated = std::chrono::steady_clock::now();
+
+    // Free and reallocate in random order, so the free chunks are scattered over the whole memory
+    std::shuffle(pointers.begin(), pointers.end(), random);
+    for (size_t i = 0; i < LIVE_ALLOCATIONS / 2; i++)
+    {
+        allocator->deallocateObjects(pointers[i]);
+        pointers[i] = allocator->allocateObjects<uint64_t>(amount(random), i);
+        ASSERT_NE(pointers[i], nullptr);
+    }
+    auto churned = std::chrono::steady_clock::now();
+
+    std::shuffle(pointers.begin(), pointers.end(), random);
+    for (size_t i = 0; i < LIVE_ALLOCATIONS; i++)
+    {
+        allocator->deallocateObjects(pointers[i]);
+    }
+    auto freed = std::chrono::steady_clock::now();
+
+    EXPECT_FALSE(allocator->needsDefragmentation());
+
+    GTEST_COUT << "Allocate:   " << LIVE_ALLOCATIONS << "x: " << std::chrono::duration<double, std::milli>(allocated - start).count() << "ms" << std::endl;
+    GTEST_COUT << "Free/Alloc: " << LIVE_ALLOCATIONS / 2 << "x: " << std::chrono::duration<double, std::milli>(churned - allocated).count() << "ms" << std::endl;
+    GTEST_COUT << "Free:       " << LIVE_ALLOCATIONS << "x: " << std::chrono::duration<double, std::milli>(freed - churned).count() << "ms" << std::endl;
+
+    delete allocator;
+}
+
+} // namespace bbe
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <chrono>
+#include <vector>
+
+#include "../HandleTable.h"
+
+namespace bbe
+{
+
+TEST(HandleTableTest, GrowsWithoutExhaustion)
+{
+    HandleTable table(1);
+    std::vector<size_t> handles;
+    std::vector<int> values(10000);
+
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        handles.push_back(table.acquire(&values[i]));
+        ASSERT_NE(handles.back(), 0);
+    }
+
+    EXPECT_GE(table.getLength(), values.size());
+    EXPECT_EQ(table.getUsedSlots(), values.size());
+
+    // Growing must not move or corrupt the slots of earlier pages
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        EXPECT_EQ(table.get(handles[i], 0), &values[i]);
+    }
+
+    for (size_t i = 0; i < handles.size(); i++)
+    {
+        table.release(handles[i], 0);
+    }
+    EXPECT_EQ(table.getUsedSlots(), 0);
+    EXPECT_EQ(table.getHighWaterMark(), values.size());
+}
+
+TEST(HandleTableTest, MaxLength)
+{
+    HandleTable table(1, 1);
+    int value = 0;
+    std::vector<size_t> handles;
+
+    while (!table.isFull())
+    {
+        handles.push_back(table.acquire(&value));
+    }
+    EXPECT_EQ(table.acquire(&value), 0);
+    EXPECT_EQ(handles.size() + 1, table.getLength()); // Slot 0 is the null handle
+
+    for (size_t i = 0; i < handles.size(); i++)
+    {
+        table.release(handles[i], 0);
+    }
+    EXPECT_FALSE(table.isFull());
+}
+
+TEST(HandleTableBenchmark, PagedLookupVsFlat)
+{
+    const size_t HANDLES = 1000000;
+    const size_t LOOKUPS = 10000000;
+
+    HandleTable table(HANDLES + 1);
+    std::vector<uint32_t> values(HANDLES);
+    std::vector<size_t> handles(HANDLES);
+    for (size_t i = 0; i < HANDLES; i++)
+    {
+        handles[i] = table.acquire(&values[i]);
+        values[i] = 1;
+    }
+
+    // The table is rounded up to whole pages, so handles can be larger than HANDLES
+    void **flatTable = new void *[table.getLength()];
+    for (size_t i = 0; i < HANDLES; i++)
+    {
+        flatTable[handles[i]] = &values[i];
+    }
+
+    uint64_t sumFlat = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < LOOKUPS; i++)
+    {
+        sumFlat += *static_cast<uint32_t *>(flatTable[handles[(i * 7919) % HANDLES]]);
+    }
+    auto flat = std::chrono::steady_clock::now();
+
+    uint64_t sumPaged = 0;
+    for (size_t i = 0; i < LOOKUPS; i++)
+    {
+        sumPaged += *static_cast<uint32_t *>(table[handles[(i * 7919) % HANDLES]]);
+    }
+    auto paged = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(sumFlat, LOOKUPS);
+    EXPECT_EQ(sumPaged, LOOKUPS);
+
+    GTEST_COUT << "Flat:  " << LOOKUPS << "x: " << std::chrono::duration<double, std::milli>(flat - start).count() << "ms" << std::endl;
+    GTEST_COUT << "Paged: " << LOOKUPS << "x: " << std::chrono::duration<double, std::milli>(paged - flat).count() << "ms" << std::endl;
+
+    for (size_t i = 0; i < HANDLES; i++)
+    {
+        table.release(handles[i], 0);
+    }
+    delete[] flatTable;
+}
+
+} // namespace bbe
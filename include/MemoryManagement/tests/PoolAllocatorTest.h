@@ -0,0 +1,165 @@
+#pragma once
+
+#include "../../../src/MainTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../PoolAllocator.h"
+
+namespace bbe
+{
+
+TEST(PoolAllocatorTest, RemoteDeallocation)
+{
+    const size_t AMOUNT = 1000;
+    PoolAllocator<size_t> pool(AMOUNT);
+    std::vector<size_t *> data;
+
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        data.push_back(pool.allocate(i));
+    }
+
+    std::thread other([&]() {
+        for (size_t i = 0; i < AMOUNT; i++)
+        {
+            EXPECT_EQ(*data[i], i);
+            pool.deallocate(data[i]);
+        }
+    });
+    other.join();
+
+    // The pool is exhausted locally, so the next allocate has to take over the remotely freed chunks
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        data[i] = pool.allocate(i);
+        ASSERT_NE(data[i], nullptr);
+    }
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        pool.deallocate(data[i]);
+    }
+}
+
+// Producer allocates, several consumer threads free concurrently. Run with -fsanitize=thread.
+TEST(PoolAllocatorTest, ProducerConsumer)
+{
+    const size_t CONSUMERS = 4;
+    const size_t POOL_SIZE = 256;
+    const size_t AMOUNT = 20000;
+
+    PoolAllocator<size_t> pool(POOL_SIZE);
+    std::atomic<size_t *> mailboxes[CONSUMERS];
+    for (size_t i = 0; i < CONSUMERS; i++)
+    {
+        mailboxes[i].store(nullptr);
+    }
+    std::atomic<bool> done{false};
+    std::atomic<size_t> consumed{0};
+
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < CONSUMERS; c++)
+    {
+        consumers.emplace_back([&, c]() {
+            while (true)
+            {
+                size_t *data = mailboxes[c].exchange(nullptr, std::memory_order_acquire);
+                if (data != nullptr)
+                {
+                    EXPECT_EQ(*data % CONSUMERS, c);
+                    pool.deallocate(data);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else if (done.load(std::memory_order_acquire))
+                {
+                    return;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        size_t *data = nullptr;
+        while (data == nullptr)
+        {
+            // Consumers may hold all chunks for a moment, wait for them to come back
+            data = pool.hasFreeChunks() ? pool.allocate(i) : nullptr;
+            if (data == nullptr)
+            {
+                std::this_thread::yield();
+            }
+        }
+        std::atomic<size_t *> &mailbox = mailboxes[i % CONSUMERS];
+        size_t *expected = nullptr;
+        while (!mailbox.compare_exchange_weak(expected, data, std::memory_order_release, std::memory_order_relaxed))
+        {
+            expected = nullptr;
+            std::this_thread::yield();
+        }
+    }
+
+    while (consumed.load(std::memory_order_relaxed) != AMOUNT)
+    {
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (size_t i = 0; i < consumers.size(); i++)
+    {
+        consumers[i].join();
+    }
+}
+
+TEST(PoolAllocatorBenchmark, RemoteFrees)
+{
+    const size_t POOL_SIZE = 1024;
+    const size_t ROUNDS = 2000;
+
+    for (size_t consumers = 1; consumers <= 8; consumers *= 2)
+    {
+        PoolAllocator<size_t> pool(POOL_SIZE * consumers);
+        std::vector<std::vector<size_t *>> batches(consumers);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < ROUNDS; round++)
+        {
+            for (size_t c = 0; c < consumers; c++)
+            {
+                batches[c].clear();
+                for (size_t i = 0; i < POOL_SIZE; i++)
+                {
+                    batches[c].push_back(pool.allocate(i));
+                }
+            }
+
+            std::vector<std::thread> threads;
+            for (size_t c = 0; c < consumers; c++)
+            {
+                threads.emplace_back([&, c]() {
+                    for (size_t i = 0; i < batches[c].size(); i++)
+                    {
+                        pool.deallocate(batches[c][i]);
+                    }
+                });
+            }
+            for (size_t c = 0; c < consumers; c++)
+            {
+                threads[c].join();
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        GTEST_COUT << consumers << " consumers: " << ROUNDS * POOL_SIZE * consumers << " remote frees: " << ms << "ms ("
+                   << ms * 1000000.0 / (ROUNDS * POOL_SIZE * consumers) << "ns per alloc/free)" << std::endl;
+    }
+}
+
+} // namespace bbe
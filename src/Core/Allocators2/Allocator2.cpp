@@ -28,4 +28,9 @@ size_t Allocator2::getUsedMemory() const
 size_t Allocator2::getNumAllocations() const
 {
     return m_num_allocations;
+}
+
+bbe::AllocatorStats Allocator2::getStats() const
+{
+    return m_stats.get();
 }
\ No newline at end of file
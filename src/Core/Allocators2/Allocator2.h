@@ -4,6 +4,8 @@
 #include "../../Utilities/DataTypes.h"
 #include "../../Utilities/Debug.h"
 
+#include "MemoryManagement/AllocatorStats.h"
+
 #include <memory>
 
 namespace arcane
@@ -26,6 +28,9 @@ public:
     size_t getUsedMemory() const;
     size_t getNumAllocations() const;
 
+    // Empty unless BBE_ALLOCATOR_STATS is enabled
+    bbe::AllocatorStats getStats() const;
+
 protected:
     Allocator2(const Allocator2 &);
     Allocator2 &operator=(Allocator2 &);
@@ -33,6 +38,8 @@ protected:
     size_t m_size;
     size_t m_used_memory;
     size_t m_num_allocations;
+
+    BBE_NO_UNIQUE_ADDRESS bbe::DefaultAllocatorStatsPolicy m_stats;
 };
 
 namespace allocator
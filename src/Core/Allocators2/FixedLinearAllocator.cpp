@@ -21,12 +21,15 @@ void *FixedLinearAllocator::allocate(size_t size, uint8_t alignment)
     if (newHeadPointer <= (byte *)m_start + m_size)
     {
         m_used_memory += size;
+        m_num_allocations++;
+        m_stats.onAllocate(size, allocationLocation - (byte *)m_current_pos);
 
         m_current_pos = newHeadPointer;
         return allocationLocation;
     }
     else
     {
+        m_stats.onFailedAllocation();
         return nullptr;
     }
 }
@@ -42,12 +45,24 @@ void FixedLinearAllocator::rewind(void *p)
 
     m_current_pos = p;
     m_used_memory = (uintptr_t)m_current_pos - (uintptr_t)m_start;
+
+    // Only a rewind to the start tells how many allocations were freed
+    if (m_current_pos == m_start)
+    {
+        m_num_allocations = 0;
+        m_stats.onReset();
+    }
+    else
+    {
+        m_stats.onRewind(m_used_memory);
+    }
 }
 
 void FixedLinearAllocator::clear()
 {
     m_num_allocations = 0;
     m_used_memory = 0;
+    m_stats.onReset();
 
     m_current_pos = m_start;
 }
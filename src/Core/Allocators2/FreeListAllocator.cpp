@@ -1,37 +1,30 @@
 #include "FreeListAllocator.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include <iostream>
 
 using namespace arcane;
 
-FreeListAllocator::FreeListAllocator(size_t size, void *start, size_t handle_table_length)
-	: m_start((byte *)start), m_size(size), m_used_memory(0), m_num_allocations(0), m_freeBlocks((FreeBlock *)start)
+FreeListAllocator::FreeListAllocator(size_t size, void *start, size_t handle_table_length, size_t max_handle_table_length)
+	: m_start((byte *)start), m_size(size), m_used_memory(0), m_num_allocations(0), m_freeBlocks((FreeBlock *)start),
+	  m_handle_table(handle_table_length, max_handle_table_length)
 {
 	ASSERT(size > sizeof(FreeBlock));
 
-	m_freeBlocks->size = size;
-	m_freeBlocks->next = nullptr;
-
-	m_handle_table_length = handle_table_length;
-	m_handle_table = new void *[m_handle_table_length];
-	memset(m_handle_table, 0, sizeof(void *) * m_handle_table_length);
-
-	for (size_t i = m_handle_table_length - 1; i > 0; i--)
+	for (size_t i = 0; i < bbe::ALLOCATOR_STATS_HISTOGRAM_BUCKETS; i++)
 	{
-		m_unusedHandleStack.push_back(i);
+		m_free_block_bins[i] = nullptr;
 	}
+
+	m_freeBlocks->size = size;
+	m_freeBlocks->next = nullptr;
+	onFreeBlockAdded(m_freeBlocks);
 }
 
 FreeListAllocator::~FreeListAllocator()
 {
-	if (m_handle_table != nullptr)
-	{
-		delete[] m_handle_table;
-		m_handle_table = nullptr;
-	}
-
 	ASSERT(m_num_allocations == 0 && m_used_memory == 0);
 
 	m_size = 0;
@@ -41,8 +34,9 @@ FreeListAllocator::AllocatorPointer<byte> FreeListAllocator::allocate(size_t siz
 {
 	ASSERT(size != 0 && alignment != 0);
 
-	if (m_unusedHandleStack.empty())
+	if (m_handle_table.isFull())
 	{
+		m_stats.onFailedAllocation();
 		return FreeListAllocator::AllocatorPointer<byte>(this, 0);
 	}
 
@@ -60,21 +54,24 @@ FreeListAllocator::AllocatorPointer<byte> FreeListAllocator::allocate(size_t siz
 		{
 			// TODO: Call defragmentator till a large enough block is generated
 			findBestFitFreeBlock(size, alignment, best_fit_adjustment, best_fit_prev, best_fit, total_free_space);
-			ASSERT(best_fit && "Defragmenting or findBestFitFreeBlock is not working correctly.");
 		}
-		else // Not enough memory available
+
+		// Not enough memory available, or no free block is large enough as long as defragment() doesn't move anything
+		if (best_fit == nullptr)
 		{
+			m_stats.onFailedAllocation();
 			return FreeListAllocator::AllocatorPointer<byte>(this, 0);
 		}
 	}
 
-	size_t best_fit_total_size = size + best_fit_adjustment;
+	size_t best_fit_total_size = std::max(size + best_fit_adjustment, sizeof(FreeBlock));
 
-	//If allocations in the remaining memory will be impossible
-	if (best_fit->size - best_fit_total_size <= sizeof(AllocationHeader))
+	//If the remaining memory can't hold a FreeBlock
+	if (best_fit->size - best_fit_total_size < sizeof(FreeBlock))
 	{
 		//Increase allocation size instead of creating a new FreeBlock
 		best_fit_total_size = best_fit->size;
+		onFreeBlockRemoved(best_fit);
 
 		// Remove empty FreeBlock from the list
 		if (best_fit_prev != nullptr)
@@ -89,12 +86,12 @@ FreeListAllocator::AllocatorPointer<byte> FreeListAllocator::allocate(size_t siz
 	else
 	{
 		//Prevent new block from overwriting best fit block info
-		ASSERT(best_fit_total_size > sizeof(FreeBlock));
+		ASSERT(best_fit_total_size >= sizeof(FreeBlock));
 
 		//Else create a new FreeBlock containing remaining memory
 		FreeBlock *new_block = (FreeBlock *)(pointer_math::add(best_fit, best_fit_total_size));
-		new_block->size = best_fit->size - best_fit_total_size;
 		new_block->next = best_fit->next;
+		onFreeBlockResized(best_fit, new_block, best_fit->size - best_fit_total_size);
 
 		if (best_fit_prev != nullptr)
 		{
@@ -124,25 +121,26 @@ FreeListAllocator::AllocatorPointer<byte> FreeListAllocator::allocate(size_t siz
 
 	m_used_memory += best_fit_total_size;
 	m_num_allocations++;
+	m_stats.onAllocate(size, best_fit_adjustment - sizeof(AllocationHeader), best_fit_total_size);
 
 	ASSERT(pointer_math::alignForwardAdjustment(reinterpret_cast<void *>(aligned_address), alignment) == 0);
 
-	size_t index = m_unusedHandleStack.back();
-	m_unusedHandleStack.pop_back();
-	m_handle_table[index] = aligned_address;
+	size_t index = m_handle_table.acquire(aligned_address);
 
 	return FreeListAllocator::AllocatorPointer<byte>(this, index);
 }
 
 void FreeListAllocator::deallocate(FreeListAllocator::AllocatorPointer<byte> *p)
 {
-	ASSERT(p != nullptr && (*p) != nullptr);
+	ASSERT(p != nullptr && (*p).isValid());
+	ASSERT(!m_handle_table.isPinned((*p).m_handle_index) && "Deallocating pinned memory!");
 
 	AllocationHeader *header = (AllocationHeader *)pointer_math::subtract((*p).getRaw(), sizeof(AllocationHeader));
 
 	byte *block_start = reinterpret_cast<byte *>((*p).getRaw()) - header->adjustment;
 	size_t block_size = header->size;
 	byte *block_end = block_start + block_size;
+	const size_t alignment_waste = header->adjustment - sizeof(AllocationHeader); // The header gets overwritten below
 
 	FreeBlock *prev_free_block = nullptr;
 	FreeBlock *free_block = m_freeBlocks;
@@ -165,10 +163,12 @@ void FreeListAllocator::deallocate(FreeListAllocator::AllocatorPointer<byte> *p)
 		prev_free_block->next = m_freeBlocks;
 
 		m_freeBlocks = prev_free_block;
+		onFreeBlockAdded(prev_free_block);
 	}
 	else if ((byte *)prev_free_block + prev_free_block->size == block_start)
 	{
-		prev_free_block->size += block_size; // Previous Free Block ends at our allocation, so just merge them
+		// Previous Free Block ends at our allocation, so just merge them
+		onFreeBlockResized(prev_free_block, prev_free_block, prev_free_block->size + block_size);
 	}
 	else
 	{
@@ -180,6 +180,7 @@ void FreeListAllocator::deallocate(FreeListAllocator::AllocatorPointer<byte> *p)
 		prev_free_block->next = temp;
 
 		prev_free_block = temp;
+		onFreeBlockAdded(temp);
 	}
 
 	//std::cout << "m_freeBlocks:             " << (void *)m_freeBlocks << std::endl;
@@ -193,15 +194,30 @@ void FreeListAllocator::deallocate(FreeListAllocator::AllocatorPointer<byte> *p)
 	// Check if newly created free blocks can be merged (Coalescence)
 	if ((byte *)prev_free_block + prev_free_block->size == (byte *)prev_free_block->next)
 	{
-		prev_free_block->size += prev_free_block->next->size;
-		prev_free_block->next = prev_free_block->next->next;
+		FreeBlock *next_free_block = prev_free_block->next;
+		const size_t merged_size = prev_free_block->size + next_free_block->size;
+
+		// The larger one of both is resized, so merging into the largest block doesn't search the bins
+		if (prev_free_block->size >= next_free_block->size)
+		{
+			onFreeBlockRemoved(next_free_block);
+			onFreeBlockResized(prev_free_block, prev_free_block, merged_size);
+		}
+		else
+		{
+			onFreeBlockRemoved(prev_free_block);
+			onFreeBlockResized(next_free_block, prev_free_block, merged_size);
+		}
+		prev_free_block->next = next_free_block->next;
 	}
 
 	m_num_allocations--;
 	m_used_memory -= block_size;
+	m_stats.onDeallocate(alignment_waste, block_size);
 
-	m_unusedHandleStack.push_back((*p).m_handle_index);
+	m_handle_table.release((*p).m_handle_index, (*p).m_generation);
 	(*p).m_handle_index = 0;
+	(*p).m_generation = 0;
 }
 
 bool FreeListAllocator::needsDefragmentation()
@@ -216,7 +232,8 @@ bool FreeListAllocator::needsDefragmentation()
 
 bool FreeListAllocator::defragment()
 {
-	if (!needsDefragmentation())
+	// Pinned allocations are accessed through raw pointers, nothing may be moved while they exist
+	if (!needsDefragmentation() || m_handle_table.getPinnedSlots() != 0)
 	{
 		return false;
 	}
@@ -240,6 +257,11 @@ bool FreeListAllocator::defragment()
 	return true;
 }
 
+const bbe::HandleTable &FreeListAllocator::getHandleTable() const
+{
+	return m_handle_table;
+}
+
 size_t FreeListAllocator::getSize() const
 {
 	return m_size;
@@ -255,6 +277,16 @@ size_t FreeListAllocator::getNumAllocations() const
 	return m_num_allocations;
 }
 
+bbe::AllocatorStats FreeListAllocator::getStats() const
+{
+	return m_stats.get();
+}
+
+bbe::FragmentationStats FreeListAllocator::getFragmentation() const
+{
+	return m_fragmentation;
+}
+
 void FreeListAllocator::findBestFitFreeBlock(const size_t size, const size_t alignment, uint8_t &adjustment,
 											 FreeBlock *&bestFitPrev, FreeBlock *&bestFit, size_t &totalFreeSpace)
 {
@@ -271,7 +303,7 @@ void FreeListAllocator::findBestFitFreeBlock(const size_t size, const size_t ali
 		//Calculate adjustment needed to keep object correctly aligned
 		uint8_t adjustment = pointer_math::alignForwardAdjustmentWithHeader<AllocationHeader>(free_block, alignment);
 
-		size_t total_size = size + adjustment;
+		size_t total_size = std::max(size + adjustment, sizeof(FreeBlock));
 
 		total_free_space += free_block->size;
 
@@ -301,4 +333,95 @@ void FreeListAllocator::findBestFitFreeBlock(const size_t size, const size_t ali
 	bestFitPrev = best_fit_prev;
 	adjustment = best_fit_adjustment;
 	totalFreeSpace = total_free_space;
+}
+
+void FreeListAllocator::onFreeBlockAdded(FreeBlock *block)
+{
+	linkFreeBlock(block);
+	m_fragmentation.addFreeBlock(block->size);
+	if (block->size > m_fragmentation.m_largestFreeBlock)
+	{
+		m_fragmentation.m_largestFreeBlock = block->size;
+	}
+}
+
+void FreeListAllocator::onFreeBlockRemoved(FreeBlock *block)
+{
+	unlinkFreeBlock(block);
+	m_fragmentation.removeFreeBlock(block->size);
+	if (block->size == m_fragmentation.m_largestFreeBlock)
+	{
+		m_fragmentation.m_largestFreeBlock = findLargestFreeBlock();
+	}
+}
+
+void FreeListAllocator::onFreeBlockResized(FreeBlock *block, FreeBlock *resized_block, size_t new_size)
+{
+	// resized_block is block itself when merging, or the remainder behind it when allocating from its front
+	const size_t old_size = block->size;
+	unlinkFreeBlock(block);
+	m_fragmentation.removeFreeBlock(old_size);
+
+	resized_block->size = new_size;
+	linkFreeBlock(resized_block);
+	m_fragmentation.addFreeBlock(new_size);
+
+	// Allocating from the largest block is the common case, the bins are only searched if it might not be the largest anymore
+	if (new_size >= m_fragmentation.m_largestFreeBlock)
+	{
+		m_fragmentation.m_largestFreeBlock = new_size;
+	}
+	else if (old_size == m_fragmentation.m_largestFreeBlock)
+	{
+		m_fragmentation.m_largestFreeBlock = findLargestFreeBlock();
+	}
+}
+
+void FreeListAllocator::linkFreeBlock(FreeBlock *block)
+{
+	FreeBlock *&bin = m_free_block_bins[bbe::AllocatorStats::getHistogramBucket(block->size)];
+	block->prev_in_bin = nullptr;
+	block->next_in_bin = bin;
+	if (bin != nullptr)
+	{
+		bin->prev_in_bin = block;
+	}
+	bin = block;
+}
+
+void FreeListAllocator::unlinkFreeBlock(FreeBlock *block)
+{
+	if (block->prev_in_bin != nullptr)
+	{
+		block->prev_in_bin->next_in_bin = block->next_in_bin;
+	}
+	else
+	{
+		m_free_block_bins[bbe::AllocatorStats::getHistogramBucket(block->size)] = block->next_in_bin;
+	}
+	if (block->next_in_bin != nullptr)
+	{
+		block->next_in_bin->prev_in_bin = block->prev_in_bin;
+	}
+}
+
+size_t FreeListAllocator::findLargestFreeBlock() const
+{
+	// Every block of a higher bin is larger than all blocks of the lower ones
+	for (size_t i = bbe::ALLOCATOR_STATS_HISTOGRAM_BUCKETS; i > 0; i--)
+	{
+		size_t largest_free_block = 0;
+		for (FreeBlock *free_block = m_free_block_bins[i - 1]; free_block != nullptr; free_block = free_block->next_in_bin)
+		{
+			if (free_block->size > largest_free_block)
+			{
+				largest_free_block = free_block->size;
+			}
+		}
+		if (largest_free_block != 0)
+		{
+			return largest_free_block;
+		}
+	}
+	return 0;
 }
\ No newline at end of file
@@ -4,7 +4,11 @@
 #include "../../Utilities/DataTypes.h"
 #include "../../Utilities/Debug.h"
 
-#include <vector>
+#include "MemoryManagement/AllocatorStats.h"
+#include "MemoryManagement/CompactHandle.h"
+#include "MemoryManagement/FragmentationStats.h"
+
+#include <memory>
 
 namespace arcane
 {
@@ -19,29 +23,35 @@ public:
 
     private:
         FreeListAllocator *m_parent;
-        size_t m_handle_index;
+        uint32_t m_handle_index;
+        uint32_t m_generation;
+
+        T *resolve() const
+        {
+            return static_cast<T *>(m_parent->m_handle_table.get(m_handle_index, m_generation));
+        }
 
     public:
         AllocatorPointer()
-            : m_parent(nullptr), m_handle_index(0)
+            : m_parent(nullptr), m_handle_index(0), m_generation(0)
         {
         }
 
         AllocatorPointer(FreeListAllocator *parent, size_t handleIndex)
-            : m_parent(parent), m_handle_index(handleIndex)
+            : m_parent(parent), m_handle_index((uint32_t)handleIndex), m_generation(parent->m_handle_table.getGeneration(handleIndex))
         {
         }
 
     public:                // Operators
         template <class U> // Operator for casting with template
         AllocatorPointer(AllocatorPointer<U> arg)
-            : m_parent(arg.getParent()), m_handle_index(arg.getHandleIndex())
+            : m_parent(arg.getParent()), m_handle_index((uint32_t)arg.getHandleIndex()), m_generation(arg.getGeneration())
         {
         }
 
         T *getRaw()
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]);
+            return resolve();
         }
 
         FreeListAllocator *getParent()
@@ -54,15 +64,44 @@ public:
             return m_handle_index;
         }
 
+        uint32_t getGeneration()
+        {
+            return m_generation;
+        }
+
+        // False once the allocation was freed, even if its handle got reused
+        bool isValid() const
+        {
+            return m_parent != nullptr && m_handle_index != 0 && m_parent->m_handle_table.isValid(m_handle_index, m_generation);
+        }
+
+        // Resolves the handle once, defragment() won't move the data while the returned object is alive
+        bbe::Pinned<T> pin(size_t length = 1)
+        {
+            return bbe::Pinned<T>(m_parent->m_handle_table, m_handle_index, m_generation, length);
+        }
+
+        // The handle table of the parent has to be registered in registrySlot. The compact handle only keeps
+        // 8 bit of the generation, see bbe::CompactHandle.
+        template <size_t registrySlot>
+        bbe::CompactHandle<T, registrySlot> toCompact() const
+        {
+            if (m_parent == nullptr)
+            {
+                return bbe::CompactHandle<T, registrySlot>();
+            }
+            return bbe::CompactHandle<T, registrySlot>::fromTable(m_parent->m_handle_table, m_handle_index, m_generation);
+        }
+
         AllocatorPointer<T> &operator+=(const size_t &rhs)
         {
-            m_parent->m_handle_table[m_handle_index] = static_cast<T *>(m_parent->m_handle_table[m_handle_index]) + rhs;
+            m_parent->m_handle_table.set(m_handle_index, m_generation, resolve() + rhs);
 
             return *this;
         }
         AllocatorPointer<T> &operator-=(const size_t &rhs)
         {
-            m_parent->m_handle_table[m_handle_index] = static_cast<T *>(m_parent->m_handle_table[m_handle_index]) - rhs;
+            m_parent->m_handle_table.set(m_handle_index, m_generation, resolve() - rhs);
 
             return *this;
         }
@@ -80,101 +119,102 @@ public:
 
         explicit operator size_t *() const
         {
-            return reinterpret_cast<size_t *>(static_cast<T *>(m_parent->m_handle_table[m_handle_index]));
+            return reinterpret_cast<size_t *>(resolve());
         }
 
         T *operator->()
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]);
+            return resolve();
         }
 
         const T *operator->() const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]);
+            return resolve();
         }
 
         T &operator*()
         {
-            return *static_cast<T *>(m_parent->m_handle_table[m_handle_index]);
+            return *resolve();
         }
 
         const T &operator*() const
         {
-            return *static_cast<T *>(m_parent->m_handle_table[m_handle_index]);
+            return *resolve();
         }
 
         T &operator[](int index)
         {
-            return *(static_cast<T *>(m_parent->m_handle_table[m_handle_index]) + index);
+            return *(resolve() + index);
         }
 
         const T &operator[](int index) const
         {
-            return *(static_cast<T *>(m_parent->m_handle_table[m_handle_index]) + index);
+            return *(resolve() + index);
         }
 
         bool operator==(void *ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) == ptr;
+            return resolve() == ptr;
         }
 
         bool operator!=(void *ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) != ptr;
+            return resolve() != ptr;
         }
 
         bool operator>(void *ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) > ptr;
+            return resolve() > ptr;
         }
 
         bool operator<(void *ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) < ptr;
+            return resolve() < ptr;
         }
 
         bool operator>=(void *ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) >= ptr;
+            return resolve() >= ptr;
         }
 
         bool operator<=(void *ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) <= ptr;
+            return resolve() <= ptr;
         }
 
         bool operator==(AllocatorPointer<T> ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) == ptr.getRaw();
+            return resolve() == ptr.getRaw();
         }
 
         bool operator!=(AllocatorPointer<T> ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) != ptr.getRaw();
+            return resolve() != ptr.getRaw();
         }
 
         bool operator>(AllocatorPointer<T> ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) > ptr.getRaw();
+            return resolve() > ptr.getRaw();
         }
 
         bool operator<(AllocatorPointer<T> ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) < ptr.getRaw();
+            return resolve() < ptr.getRaw();
         }
 
         bool operator>=(AllocatorPointer<T> ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) >= ptr.getRaw();
+            return resolve() >= ptr.getRaw();
         }
 
         bool operator<=(AllocatorPointer<T> ptr) const
         {
-            return static_cast<T *>(m_parent->m_handle_table[m_handle_index]) <= ptr.getRaw();
+            return resolve() <= ptr.getRaw();
         }
     };
 
-    FreeListAllocator(size_t size, void *start, size_t handle_table_length);
+    // The handle table starts with handle_table_length handles and grows when they are used up
+    FreeListAllocator(size_t size, void *start, size_t handle_table_length, size_t max_handle_table_length = bbe::HandleTable::UNLIMITED_LENGTH);
     ~FreeListAllocator();
 
     FreeListAllocator::AllocatorPointer<byte> allocate(size_t size, uint8_t alignment);
@@ -201,12 +241,21 @@ public:
 
     bool needsDefragmentation();
 
+    // Still a stub: doesn't move any allocation, only returns needsDefragmentation() while nothing is pinned
     bool defragment();
 
+    const bbe::HandleTable &getHandleTable() const;
+
     size_t getSize() const;
     size_t getUsedMemory() const;
     size_t getNumAllocations() const;
 
+    // Empty unless BBE_ALLOCATOR_STATS is enabled
+    bbe::AllocatorStats getStats() const;
+
+    // Kept up to date on every allocation and deallocation, reading it doesn't touch the free list
+    bbe::FragmentationStats getFragmentation() const;
+
 private:
     struct AllocationHeader
     {
@@ -214,19 +263,28 @@ private:
         uint8_t adjustment;
     };
 
+    // next links all free blocks by address, prev_in_bin/next_in_bin the ones in the same size bin. Every
+    // allocation takes at least sizeof(FreeBlock), so it can become a free block again.
     struct FreeBlock
     {
         size_t size;
         FreeBlock *next;
+        FreeBlock *prev_in_bin;
+        FreeBlock *next_in_bin;
     };
 
-    static_assert(sizeof(AllocationHeader) >= sizeof(FreeBlock), "sizeof(AllocationHeader) < sizeof(FreeBlock)");
-
     FreeListAllocator(const FreeListAllocator &);
     FreeListAllocator &operator=(const FreeListAllocator &);
 
     void findBestFitFreeBlock(const size_t size, const size_t alignment, uint8_t &adjustment, FreeBlock *&bestFitPrev, FreeBlock *&bestFit, size_t &totalFreeSpace);
 
+    void onFreeBlockAdded(FreeBlock *block);
+    void onFreeBlockRemoved(FreeBlock *block);
+    void onFreeBlockResized(FreeBlock *block, FreeBlock *resized_block, size_t new_size);
+    void linkFreeBlock(FreeBlock *block);
+    void unlinkFreeBlock(FreeBlock *block);
+    size_t findLargestFreeBlock() const;
+
     byte *m_start;
     size_t m_size;
     size_t m_used_memory;
@@ -234,10 +292,14 @@ private:
 
     FreeBlock *m_freeBlocks;
 
-    std::vector<size_t> m_unusedHandleStack;
+    bbe::HandleTable m_handle_table;
+
+    BBE_NO_UNIQUE_ADDRESS bbe::DefaultAllocatorStatsPolicy m_stats;
 
-    size_t m_handle_table_length;
-    void **m_handle_table;
+    // Free blocks binned like bbe::FragmentationStats::m_freeBlockHistogram. The largest block is in the highest
+    // non-empty bin, which is only searched when the largest block shrinks or is allocated.
+    FreeBlock *m_free_block_bins[bbe::ALLOCATOR_STATS_HISTOGRAM_BUCKETS];
+    bbe::FragmentationStats m_fragmentation;
 };
 
 }; // namespace arcane
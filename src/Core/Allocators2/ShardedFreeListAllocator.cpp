@@ -0,0 +1,169 @@
+#include "ShardedFreeListAllocator.h"
+
+#include <functional>
+#include <thread>
+
+using namespace arcane;
+
+ShardedFreeListAllocator::Shard::Shard(size_t size, void *start, size_t handle_table_length)
+	: m_allocator(size, start, handle_table_length)
+{
+}
+
+ShardedFreeListAllocator::ShardedFreeListAllocator(size_t size, void *start, size_t shard_count, size_t handle_table_length)
+	: m_shards(nullptr), m_shard_count(shard_count), m_size(size), m_steals(0)
+{
+	ASSERT(shard_count != 0);
+
+	// Keeps every shard start aligned, the remainder goes to the last shard
+	const size_t shard_size = (size / shard_count) & ~(size_t)(DEFAULT_ALIGNMENT - 1);
+	ASSERT(shard_size != 0);
+
+	m_shards = new Shard *[m_shard_count];
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		const size_t this_shard_size = (i + 1 == m_shard_count) ? size - shard_size * i : shard_size;
+		m_shards[i] = new Shard(this_shard_size, pointer_math::add(start, shard_size * i), handle_table_length);
+	}
+}
+
+ShardedFreeListAllocator::~ShardedFreeListAllocator()
+{
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		delete m_shards[i];
+	}
+	delete[] m_shards;
+
+	m_shard_count = 0;
+	m_size = 0;
+}
+
+FreeListAllocator::AllocatorPointer<byte> ShardedFreeListAllocator::allocate(size_t size, uint8_t alignment)
+{
+	const size_t home = getShardOfCurrentThread();
+
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		Shard &shard = *m_shards[(home + i) % m_shard_count];
+
+		std::lock_guard<std::mutex> lock(shard.m_mutex);
+		FreeListAllocator::AllocatorPointer<byte> p = shard.m_allocator.allocate(size, alignment);
+		if (p.isValid())
+		{
+			if (i != 0)
+			{
+				m_steals.fetch_add(1, std::memory_order_relaxed);
+			}
+			return p;
+		}
+	}
+
+	return FreeListAllocator::AllocatorPointer<byte>();
+}
+
+void ShardedFreeListAllocator::deallocate(FreeListAllocator::AllocatorPointer<byte> *p)
+{
+	ASSERT(p != nullptr);
+
+	Shard *shard = findShard(p->getParent());
+	ASSERT(shard != nullptr && "Pointer was not allocated by this allocator!");
+
+	std::lock_guard<std::mutex> lock(shard->m_mutex);
+	shard->m_allocator.deallocate(p);
+}
+
+bool ShardedFreeListAllocator::defragment()
+{
+	bool defragmented = false;
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		defragmented |= defragmentShard(i);
+	}
+	return defragmented;
+}
+
+bool ShardedFreeListAllocator::defragmentShard(size_t shard)
+{
+	ASSERT(shard < m_shard_count);
+
+	std::lock_guard<std::mutex> lock(m_shards[shard]->m_mutex);
+	return m_shards[shard]->m_allocator.defragment();
+}
+
+size_t ShardedFreeListAllocator::getShardCount() const
+{
+	return m_shard_count;
+}
+
+size_t ShardedFreeListAllocator::getShardOfCurrentThread() const
+{
+	static thread_local const size_t thread_hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+	return thread_hash % m_shard_count;
+}
+
+size_t ShardedFreeListAllocator::getSteals() const
+{
+	return m_steals.load(std::memory_order_relaxed);
+}
+
+size_t ShardedFreeListAllocator::getSize() const
+{
+	return m_size;
+}
+
+size_t ShardedFreeListAllocator::getUsedMemory() const
+{
+	size_t used_memory = 0;
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		std::lock_guard<std::mutex> lock(m_shards[i]->m_mutex);
+		used_memory += m_shards[i]->m_allocator.getUsedMemory();
+	}
+	return used_memory;
+}
+
+size_t ShardedFreeListAllocator::getNumAllocations() const
+{
+	size_t num_allocations = 0;
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		std::lock_guard<std::mutex> lock(m_shards[i]->m_mutex);
+		num_allocations += m_shards[i]->m_allocator.getNumAllocations();
+	}
+	return num_allocations;
+}
+
+bbe::AllocatorStats ShardedFreeListAllocator::getStats() const
+{
+	bbe::AllocatorStats stats;
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		std::lock_guard<std::mutex> lock(m_shards[i]->m_mutex);
+		stats.add(m_shards[i]->m_allocator.getStats());
+	}
+	return stats;
+}
+
+bbe::FragmentationStats ShardedFreeListAllocator::getFragmentation() const
+{
+	bbe::FragmentationStats fragmentation;
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		std::lock_guard<std::mutex> lock(m_shards[i]->m_mutex);
+		fragmentation.add(m_shards[i]->m_allocator.getFragmentation());
+	}
+	return fragmentation;
+}
+
+ShardedFreeListAllocator::Shard *ShardedFreeListAllocator::findShard(const FreeListAllocator *allocator) const
+{
+	for (size_t i = 0; i < m_shard_count; i++)
+	{
+		if (&m_shards[i]->m_allocator == allocator)
+		{
+			return m_shards[i];
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Allocator2.h"
+#include "FreeListAllocator.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace arcane
+{
+
+// Thread-safe allocator which splits its memory into independently locked FreeListAllocators (shards).
+// Every thread starts at the shard picked by its thread id and only steals from the other shards when
+// its own one can't serve the request, so threads mostly don't contend for the same lock.
+class ShardedFreeListAllocator
+{
+public:
+    // size is split evenly between shard_count shards, each with its own handle table
+    ShardedFreeListAllocator(size_t size, void *start, size_t shard_count, size_t handle_table_length);
+    ~ShardedFreeListAllocator();
+
+    FreeListAllocator::AllocatorPointer<byte> allocate(size_t size, uint8_t alignment);
+
+    // Can be called from any thread, the block goes back to the shard it was allocated from
+    void deallocate(FreeListAllocator::AllocatorPointer<byte> *p);
+
+    // Calls FreeListAllocator::defragment() on the shards one after another, only the shard being defragmented is
+    // locked. That is still a stub which doesn't move anything, so neither do these.
+    bool defragment();
+    bool defragmentShard(size_t shard);
+
+    size_t getShardCount() const;
+    size_t getShardOfCurrentThread() const;
+
+    // Allocations which had to be served by another shard than the one of the allocating thread
+    size_t getSteals() const;
+
+    size_t getSize() const;
+    size_t getUsedMemory() const;
+    size_t getNumAllocations() const;
+
+    // Sum of the stats of all shards, see bbe::AllocatorStats::add for the peaks
+    bbe::AllocatorStats getStats() const;
+
+    // Free memory of all shards, the largest free block is the largest one of any shard
+    bbe::FragmentationStats getFragmentation() const;
+
+private:
+    // Every shard gets its own cache line, so locking one doesn't slow down its neighbours
+    struct alignas(64) Shard
+    {
+        Shard(size_t size, void *start, size_t handle_table_length);
+
+        mutable std::mutex m_mutex;
+        FreeListAllocator m_allocator;
+    };
+
+    ShardedFreeListAllocator(const ShardedFreeListAllocator &);
+    ShardedFreeListAllocator &operator=(const ShardedFreeListAllocator &);
+
+    Shard *findShard(const FreeListAllocator *allocator) const;
+
+    Shard **m_shards;
+    size_t m_shard_count;
+    size_t m_size;
+
+    std::atomic<size_t> m_steals;
+};
+
+}; // namespace arcane
@@ -0,0 +1,188 @@
+#include "ThreadCachingAllocator.h"
+
+#include <chrono>
+
+using namespace arcane;
+
+const size_t ThreadCachingAllocator::MIN_SIZE_CLASS;
+const size_t ThreadCachingAllocator::NUM_SIZE_CLASSES;
+const size_t ThreadCachingAllocator::MAX_SIZE_CLASS;
+const size_t ThreadCachingAllocator::MAGAZINE_SIZE;
+const size_t ThreadCachingAllocator::BATCH_SIZE;
+
+class ThreadCachingAllocator::TimedLock
+{
+public:
+	explicit TimedLock(ThreadCachingAllocator &parent)
+		: m_parent(parent), m_lock(parent.m_mutex), m_start(std::chrono::steady_clock::now())
+	{
+	}
+
+	~TimedLock()
+	{
+		auto held = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+		m_parent.m_lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
+		m_parent.m_lock_hold_nanoseconds.fetch_add(held.count(), std::memory_order_relaxed);
+	}
+
+private:
+	ThreadCachingAllocator &m_parent;
+	std::lock_guard<std::mutex> m_lock;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+ThreadCachingAllocator::ThreadCache::ThreadCache(ThreadCachingAllocator &parent)
+	: m_parent(parent)
+{
+	for (size_t i = 0; i < NUM_SIZE_CLASSES; i++)
+	{
+		m_magazines[i].count = 0;
+	}
+}
+
+ThreadCachingAllocator::ThreadCache::~ThreadCache()
+{
+	flush();
+}
+
+FreeListAllocator::AllocatorPointer<byte> ThreadCachingAllocator::ThreadCache::allocate(size_t size, uint8_t alignment)
+{
+	size_t size_class = getSizeClass(size, alignment);
+	if (size_class == NUM_SIZE_CLASSES)
+	{
+		return m_parent.allocate(size, alignment);
+	}
+
+	Magazine &magazine = m_magazines[size_class];
+	if (magazine.count == 0)
+	{
+		magazine.count = m_parent.allocateBatch(size_class, magazine.blocks, BATCH_SIZE);
+
+		if (magazine.count == 0)
+		{
+			return FreeListAllocator::AllocatorPointer<byte>();
+		}
+	}
+
+	magazine.count--;
+	return magazine.blocks[magazine.count];
+}
+
+void ThreadCachingAllocator::ThreadCache::deallocate(FreeListAllocator::AllocatorPointer<byte> *p, size_t size, uint8_t alignment)
+{
+	ASSERT(p != nullptr && p->isValid());
+
+	size_t size_class = getSizeClass(size, alignment);
+	if (size_class == NUM_SIZE_CLASSES)
+	{
+		m_parent.deallocate(p);
+		return;
+	}
+
+	Magazine &magazine = m_magazines[size_class];
+	if (magazine.count == MAGAZINE_SIZE)
+	{
+		// Keep the most recently freed half, it is most likely still in the cache of this core
+		m_parent.deallocateBatch(magazine.blocks, BATCH_SIZE);
+		for (size_t i = 0; i < MAGAZINE_SIZE - BATCH_SIZE; i++)
+		{
+			magazine.blocks[i] = magazine.blocks[i + BATCH_SIZE];
+		}
+		magazine.count -= BATCH_SIZE;
+	}
+
+	magazine.blocks[magazine.count] = *p;
+	magazine.count++;
+
+	*p = FreeListAllocator::AllocatorPointer<byte>();
+}
+
+void ThreadCachingAllocator::ThreadCache::flush()
+{
+	for (size_t i = 0; i < NUM_SIZE_CLASSES; i++)
+	{
+		if (m_magazines[i].count != 0)
+		{
+			m_parent.deallocateBatch(m_magazines[i].blocks, m_magazines[i].count);
+			m_magazines[i].count = 0;
+		}
+	}
+}
+
+ThreadCachingAllocator::ThreadCachingAllocator(FreeListAllocator &backend)
+	: m_backend(backend), m_lock_acquisitions(0), m_lock_hold_nanoseconds(0)
+{
+}
+
+ThreadCachingAllocator::~ThreadCachingAllocator()
+{
+}
+
+FreeListAllocator::AllocatorPointer<byte> ThreadCachingAllocator::allocate(size_t size, uint8_t alignment)
+{
+	TimedLock lock(*this);
+	return m_backend.allocate(size, alignment);
+}
+
+void ThreadCachingAllocator::deallocate(FreeListAllocator::AllocatorPointer<byte> *p)
+{
+	TimedLock lock(*this);
+	m_backend.deallocate(p);
+}
+
+size_t ThreadCachingAllocator::getLockAcquisitions() const
+{
+	return m_lock_acquisitions.load(std::memory_order_relaxed);
+}
+
+uint64_t ThreadCachingAllocator::getLockHoldNanoseconds() const
+{
+	return m_lock_hold_nanoseconds.load(std::memory_order_relaxed);
+}
+
+size_t ThreadCachingAllocator::getSizeClass(size_t size, uint8_t alignment)
+{
+	if (size > MAX_SIZE_CLASS || alignment > DEFAULT_ALIGNMENT)
+	{
+		return NUM_SIZE_CLASSES;
+	}
+
+	size_t size_class = 0;
+	size_t class_size = MIN_SIZE_CLASS;
+	while (class_size < size)
+	{
+		class_size <<= 1;
+		size_class++;
+	}
+	return size_class;
+}
+
+size_t ThreadCachingAllocator::allocateBatch(size_t size_class, FreeListAllocator::AllocatorPointer<byte> *blocks, size_t count)
+{
+	const size_t class_size = MIN_SIZE_CLASS << size_class;
+
+	TimedLock lock(*this);
+
+	size_t allocated = 0;
+	while (allocated < count)
+	{
+		FreeListAllocator::AllocatorPointer<byte> block = m_backend.allocate(class_size, DEFAULT_ALIGNMENT);
+		if (!block.isValid())
+		{
+			break;
+		}
+		blocks[allocated] = block;
+		allocated++;
+	}
+	return allocated;
+}
+
+void ThreadCachingAllocator::deallocateBatch(FreeListAllocator::AllocatorPointer<byte> *blocks, size_t count)
+{
+	TimedLock lock(*this);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		m_backend.deallocate(&blocks[i]);
+	}
+}
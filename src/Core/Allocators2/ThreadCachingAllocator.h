@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Allocator2.h"
+#include "FreeListAllocator.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace arcane
+{
+
+// Thread-safe front end for a FreeListAllocator. Every thread allocates through its own ThreadCache,
+// which keeps recently freed blocks per size class and only locks the shared FreeListAllocator to
+// refill or flush a whole batch of blocks.
+class ThreadCachingAllocator
+{
+public:
+    static const size_t MIN_SIZE_CLASS = 16;
+    static const size_t NUM_SIZE_CLASSES = 9; // 16 byte - 4 KiB
+    static const size_t MAX_SIZE_CLASS = MIN_SIZE_CLASS << (NUM_SIZE_CLASSES - 1);
+    static const size_t MAGAZINE_SIZE = 64;
+    static const size_t BATCH_SIZE = MAGAZINE_SIZE / 2;
+
+    class ThreadCache
+    {
+    public:
+        explicit ThreadCache(ThreadCachingAllocator &parent);
+        ~ThreadCache();
+
+        // Blocks have to be deallocated with the size and alignment they were allocated with, over-aligned
+        // blocks are exactly as large as requested and go straight back to the shared allocator
+        FreeListAllocator::AllocatorPointer<byte> allocate(size_t size, uint8_t alignment = DEFAULT_ALIGNMENT);
+        void deallocate(FreeListAllocator::AllocatorPointer<byte> *p, size_t size, uint8_t alignment = DEFAULT_ALIGNMENT);
+
+        // Returns all cached blocks to the shared allocator
+        void flush();
+
+    private:
+        struct Magazine
+        {
+            FreeListAllocator::AllocatorPointer<byte> blocks[MAGAZINE_SIZE];
+            size_t count;
+        };
+
+        ThreadCache(const ThreadCache &);
+        ThreadCache &operator=(const ThreadCache &);
+
+        ThreadCachingAllocator &m_parent;
+        Magazine m_magazines[NUM_SIZE_CLASSES];
+    };
+
+    explicit ThreadCachingAllocator(FreeListAllocator &backend);
+    ~ThreadCachingAllocator();
+
+    // Locked access to the shared allocator, used directly for blocks which don't fit a size class
+    FreeListAllocator::AllocatorPointer<byte> allocate(size_t size, uint8_t alignment);
+    void deallocate(FreeListAllocator::AllocatorPointer<byte> *p);
+
+    size_t getLockAcquisitions() const;
+    uint64_t getLockHoldNanoseconds() const;
+
+private:
+    class TimedLock;
+
+    ThreadCachingAllocator(const ThreadCachingAllocator &);
+    ThreadCachingAllocator &operator=(const ThreadCachingAllocator &);
+
+    // Returns NUM_SIZE_CLASSES if the block can't be cached
+    static size_t getSizeClass(size_t size, uint8_t alignment);
+
+    size_t allocateBatch(size_t size_class, FreeListAllocator::AllocatorPointer<byte> *blocks, size_t count);
+    void deallocateBatch(FreeListAllocator::AllocatorPointer<byte> *blocks, size_t count);
+
+    FreeListAllocator &m_backend;
+
+    std::mutex m_mutex;
+    std::atomic<size_t> m_lock_acquisitions;
+    std::atomic<uint64_t> m_lock_hold_nanoseconds;
+};
+
+}; // namespace arcane
@@ -107,6 +107,65 @@ public:
 
         return results;
     }
+    BenchmarkResults2 HandleChurnFreeList(FreeListAllocator *allocator, const std::size_t size, const std::size_t alignment, const unsigned int nChurnOperations)
+    {
+        FreeListAllocator::AllocatorPointer<byte> addresses[m_nOperations];
+        for (unsigned int i = 0; i < m_nOperations; i++)
+        {
+            addresses[i] = allocator->allocate(size, alignment);
+        }
+
+        setTimer(m_start);
+        for (unsigned int i = 0; i < nChurnOperations; i++)
+        {
+            // Freed handle is reused by the next allocation right away, so it has to be invalidated every time
+            FreeListAllocator::AllocatorPointer<byte> &address = addresses[(i * 7919) % m_nOperations];
+            allocator->deallocate(&address);
+            address = allocator->allocate(size, alignment);
+        }
+        setTimer(m_end);
+
+        for (unsigned int i = 0; i < m_nOperations; i++)
+        {
+            allocator->deallocate(&addresses[i]);
+        }
+
+        BenchmarkResults2 results = buildResults(nChurnOperations, calculateElapsedTime());
+
+        return results;
+    }
+    template <typename Handle>
+    BenchmarkResults2 IterateHandles(const std::vector<Handle> &handles, uint64_t &sum)
+    {
+        sum = 0;
+
+        setTimer(m_start);
+        for (size_t i = 0; i < handles.size(); i++)
+        {
+            sum += *handles[i];
+        }
+        setTimer(m_end);
+
+        BenchmarkResults2 results = buildResults(handles.size(), calculateElapsedTime());
+
+        return results;
+    }
+    template <typename Array>
+    BenchmarkResults2 SumArray(Array &array, const size_t length, uint64_t &sum)
+    {
+        sum = 0;
+
+        setTimer(m_start);
+        for (size_t i = 0; i < length; i++)
+        {
+            sum += array[i];
+        }
+        setTimer(m_end);
+
+        BenchmarkResults2 results = buildResults(length, calculateElapsedTime());
+
+        return results;
+    }
     template <typename T>
     BenchmarkResults2 SingleAllocationObjectsFreeList(FreeListAllocator *allocator, const std::size_t count)
     {
@@ -407,6 +466,8 @@ struct BenchmarkTest2 : testing::Test
     const uint32_t ALLOCATION_OBJECT_COUNT = 51;
     const uint32_t ALIGNMENT = 8;
     const uint32_t ALLOCATION_AMOUNT = 1e4;
+    const uint32_t HANDLE_CHURN_AMOUNT = 1e6;
+    const uint32_t HANDLE_ITERATION_AMOUNT = 1e7;
 
     BenchmarkTest2()
     {
@@ -458,7 +519,7 @@ TEST_F(BenchmarkTest2, CAllocator2)
 
 TEST_F(BenchmarkTest2, FreeListAllocator)
 {
-    const size_t MEMORY_SIZE = ALLOCATION_SIZE * ALLOCATION_AMOUNT + 200 + 48 * ALLOCATION_AMOUNT;
+    const size_t MEMORY_SIZE = ALLOCATION_SIZE * ALLOCATION_AMOUNT + sizeof(FreeListAllocator) + 200 + 48 * ALLOCATION_AMOUNT;
     void *memory = new byte[MEMORY_SIZE];
     ASSERT(memory && "Could not allocate memory from system!");
 
@@ -494,6 +555,106 @@ TEST_F(BenchmarkTest2, FreeListAllocator)
     delete allocator;
 }
 
+TEST_F(BenchmarkTest2, FreeListAllocatorHandleChurn)
+{
+    const size_t MEMORY_SIZE = 64 * ALLOCATION_AMOUNT + sizeof(FreeListAllocator) + 200 + 48 * ALLOCATION_AMOUNT;
+    void *memory = new byte[MEMORY_SIZE];
+    ASSERT(memory && "Could not allocate memory from system!");
+
+    FreeListAllocator *allocator = new (memory) FreeListAllocator(MEMORY_SIZE - sizeof(FreeListAllocator),
+                                                                  pointer_math::add(memory, sizeof(FreeListAllocator)), ALLOCATION_AMOUNT + 1);
+
+    BenchmarkResults2 resultChurn = benchmark->HandleChurnFreeList(allocator, 64, ALIGNMENT, HANDLE_CHURN_AMOUNT);
+
+    GTEST_COUT << "Free/Alloc : " << 64 << " byte (" << resultChurn.nOperations << "x): " << resultChurn.elapsedTime << "ms" << std::endl;
+
+    delete allocator;
+}
+
+TEST_F(BenchmarkTest2, FreeListAllocatorCompactHandles)
+{
+    const uint32_t ALLOCATIONS = 1e6;
+    const size_t MEMORY_SIZE = 32 * ALLOCATIONS + sizeof(FreeListAllocator) + 200;
+    void *memory = new byte[MEMORY_SIZE];
+    ASSERT(memory && "Could not allocate memory from system!");
+
+    FreeListAllocator *allocator = new (memory) FreeListAllocator(MEMORY_SIZE - sizeof(FreeListAllocator),
+                                                                  pointer_math::add(memory, sizeof(FreeListAllocator)), ALLOCATIONS + 1);
+    bbe::HandleTableRegistry::registerTable(0, &allocator->getHandleTable());
+
+    std::vector<FreeListAllocator::AllocatorPointer<uint32_t>> allocations(ALLOCATIONS);
+    for (uint32_t i = 0; i < ALLOCATIONS; i++)
+    {
+        allocations[i] = allocator->allocateNew<uint32_t>(i);
+    }
+
+    // Every allocation is referenced by several handles, spread over the whole array
+    uint64_t sumPointer = 0;
+    std::vector<FreeListAllocator::AllocatorPointer<uint32_t>> pointers(HANDLE_ITERATION_AMOUNT);
+    for (uint32_t i = 0; i < HANDLE_ITERATION_AMOUNT; i++)
+    {
+        pointers[i] = allocations[(i * 7919) % ALLOCATIONS];
+    }
+    BenchmarkResults2 resultPointer = benchmark->IterateHandles(pointers, sumPointer);
+    const size_t pointerBytes = pointers.size() * sizeof(pointers[0]);
+    pointers.clear();
+    pointers.shrink_to_fit();
+
+    uint64_t sumCompact = 0;
+    std::vector<bbe::CompactHandle<uint32_t, 0>> compactHandles(HANDLE_ITERATION_AMOUNT);
+    for (uint32_t i = 0; i < HANDLE_ITERATION_AMOUNT; i++)
+    {
+        compactHandles[i] = allocations[(i * 7919) % ALLOCATIONS].toCompact<0>();
+    }
+    BenchmarkResults2 resultCompact = benchmark->IterateHandles(compactHandles, sumCompact);
+    const size_t compactBytes = compactHandles.size() * sizeof(compactHandles[0]);
+
+    EXPECT_EQ(sumPointer, sumCompact);
+
+    GTEST_COUT << "AllocatorPointer: " << pointerBytes / (1024 * 1024) << " MiB (" << resultPointer.nOperations << "x): " << resultPointer.elapsedTime << "ms" << std::endl;
+    GTEST_COUT << "CompactHandle:    " << compactBytes / (1024 * 1024) << " MiB (" << resultCompact.nOperations << "x): " << resultCompact.elapsedTime << "ms" << std::endl;
+
+    for (uint32_t i = 0; i < ALLOCATIONS; i++)
+    {
+        allocator->deallocateDelete(allocations[i]);
+    }
+
+    bbe::HandleTableRegistry::unregisterTable(0);
+    delete allocator;
+}
+
+TEST_F(BenchmarkTest2, FreeListAllocatorPinnedArray)
+{
+    const uint32_t LENGTH = 1e6;
+    const size_t MEMORY_SIZE = sizeof(uint32_t) * LENGTH + sizeof(FreeListAllocator) + 200;
+    void *memory = new byte[MEMORY_SIZE];
+    ASSERT(memory && "Could not allocate memory from system!");
+
+    FreeListAllocator *allocator = new (memory) FreeListAllocator(MEMORY_SIZE - sizeof(FreeListAllocator),
+                                                                  pointer_math::add(memory, sizeof(FreeListAllocator)), 2);
+
+    auto array = allocator->allocateArray<uint32_t>(LENGTH, 1);
+
+    uint64_t sumHandle = 0;
+    BenchmarkResults2 resultHandle = benchmark->SumArray(array, LENGTH, sumHandle);
+
+    uint64_t sumPinned = 0;
+    BenchmarkResults2 resultPinned;
+    {
+        auto pinned = array.pin(LENGTH);
+        resultPinned = benchmark->SumArray(pinned, LENGTH, sumPinned);
+    }
+
+    EXPECT_EQ(sumHandle, LENGTH);
+    EXPECT_EQ(sumPinned, LENGTH);
+
+    GTEST_COUT << "Sum Handle: " << sizeof(uint32_t) * LENGTH << " byte (" << resultHandle.nOperations << "x): " << resultHandle.elapsedTime << "ms" << std::endl;
+    GTEST_COUT << "Sum Pinned: " << sizeof(uint32_t) * LENGTH << " byte (" << resultPinned.nOperations << "x): " << resultPinned.elapsedTime << "ms" << std::endl;
+
+    allocator->deallocateArray(array);
+    delete allocator;
+}
+
 TEST_F(BenchmarkTest2, FixedLinearAllocator)
 {
     const size_t MEMORY_SIZE = ALLOCATION_SIZE * ALLOCATION_AMOUNT + sizeof(FixedLinearAllocator) + 32 * ALLOCATION_AMOUNT;
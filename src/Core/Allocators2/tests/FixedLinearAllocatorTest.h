@@ -90,4 +90,29 @@ TEST_F(FixedLinearAllocatorTest, AllocateTestObjects)
     m_allocator->clear();
 }
 
+TEST_F(FixedLinearAllocatorTest, CountsAllocations)
+{
+    void *mark = m_allocator->allocate(3, 1);
+    m_allocator->allocate(sizeof(uint64_t), alignof(uint64_t));
+    EXPECT_EQ(m_allocator->getNumAllocations(), 2);
+    EXPECT_EQ(m_allocator->allocate(MEMORY_SIZE, 1), nullptr);
+    EXPECT_EQ(m_allocator->getNumAllocations(), 2);
+
+#if BBE_ALLOCATOR_STATS
+    bbe::AllocatorStats stats = m_allocator->getStats();
+    EXPECT_EQ(stats.m_allocations, 2);
+    EXPECT_EQ(stats.m_failedAllocations, 1);
+    EXPECT_EQ(stats.m_alignmentWaste, 5);
+    EXPECT_EQ(stats.m_usedMemory, 16);
+    EXPECT_EQ(stats.m_sizeHistogram[bbe::AllocatorStats::getHistogramBucket(3)], 1);
+#endif
+
+    m_allocator->rewind(mark);
+    EXPECT_EQ(m_allocator->getNumAllocations(), 0);
+#if BBE_ALLOCATOR_STATS
+    EXPECT_EQ(m_allocator->getStats().m_openAllocations, 0);
+    EXPECT_EQ(m_allocator->getStats().m_peakUsedMemory, 16);
+#endif
+}
+
 } // namespace arcane
\ No newline at end of file
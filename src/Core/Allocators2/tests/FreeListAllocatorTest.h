@@ -1,5 +1,8 @@
 #include "../../../MainTest.h"
 
+#include <random>
+#include <vector>
+
 #include "../FreeListAllocator.h"
 
 namespace arcane
@@ -116,20 +119,86 @@ TEST_F(FreeListAllocatorTest, AllocateTestObjectsNoConstruct)
     m_allocator->deallocateArrayNoDestruct(o1);
 }
 
-TEST_F(FreeListAllocatorTest, HandleStackSizeTest)
+TEST_F(FreeListAllocatorTest, HandleTableGrows)
 {
+    // More allocations than HANDLE_STACK_SIZE, the handle table has to grow instead of failing
     auto o1 = m_allocator->allocateArray<TestClass>(2);
     auto o2 = m_allocator->allocateArray<TestClass>(2);
     auto o3 = m_allocator->allocateArray<TestClass>(2);
     auto o4 = m_allocator->allocateNew<TestClass>();
     auto o5 = m_allocator->allocateNew<TestClass>();
+    auto o6 = m_allocator->allocateNew<TestClass>();
 
-    EXPECT_EQ(o5.getRaw(), nullptr);
+    EXPECT_NE(o5.getRaw(), nullptr);
+    EXPECT_NE(o6.getRaw(), nullptr);
+    EXPECT_EQ(m_allocator->getHandleTable().getHighWaterMark(), 6);
 
     m_allocator->deallocateArray(o1);
     m_allocator->deallocateArray(o2);
     m_allocator->deallocateArray(o3);
     m_allocator->deallocateDelete(o4);
+    m_allocator->deallocateDelete(o5);
+    m_allocator->deallocateDelete(o6);
+}
+
+TEST_F(FreeListAllocatorTest, StaleHandle)
+{
+    auto o1 = m_allocator->allocateNew<uint32_t>(1);
+    auto stale = o1;
+    EXPECT_TRUE(stale.isValid());
+
+    m_allocator->deallocateDelete(o1);
+    EXPECT_FALSE(stale.isValid());
+
+    // Reuses the handle slot of o1, but must not make the old handle valid again
+    auto o2 = m_allocator->allocateNew<uint32_t>(2);
+    EXPECT_EQ(o2.getHandleIndex(), stale.getHandleIndex());
+    EXPECT_TRUE(o2.isValid());
+    EXPECT_FALSE(stale.isValid());
+
+    m_allocator->deallocateDelete(o2);
+}
+
+TEST_F(FreeListAllocatorTest, CompactHandle)
+{
+    bbe::HandleTableRegistry::registerTable(0, &m_allocator->getHandleTable());
+
+    auto o1 = m_allocator->allocateNew<TestClass>(1, "Test 1");
+    auto compact = o1.toCompact<0>();
+    EXPECT_EQ(sizeof(compact), 4);
+    EXPECT_TRUE(compact.isValid());
+    EXPECT_EQ(compact.getRaw(), o1.getRaw());
+    EXPECT_EQ(compact->m_name, "Test 1");
+
+    m_allocator->deallocateDelete(o1);
+    EXPECT_FALSE(compact.isValid());
+
+    bbe::HandleTableRegistry::unregisterTable(0);
+}
+
+TEST_F(FreeListAllocatorTest, Pin)
+{
+    auto o1 = m_allocator->allocateNew<uint32_t>(1);
+    auto o2 = m_allocator->allocateArray<uint32_t>(4, 3);
+    m_allocator->deallocateDelete(o1);
+
+    {
+        auto pinned = o2.pin(4);
+        EXPECT_EQ(pinned.getRaw(), o2.getRaw());
+        EXPECT_EQ(pinned.getLength(), 4);
+
+        uint32_t sum = 0;
+        for (uint32_t value : pinned)
+        {
+            sum += value;
+        }
+        EXPECT_EQ(sum, 12);
+
+        EXPECT_FALSE(m_allocator->defragment());
+    }
+    EXPECT_EQ(m_allocator->getHandleTable().getPinnedSlots(), 0);
+
+    m_allocator->deallocateArray(o2);
 }
 
 TEST_F(FreeListAllocatorTest, AllocateExactlyFull)
@@ -160,4 +229,110 @@ TEST_F(FreeListAllocatorTest, Defragmentation)
     m_allocator->deallocateDelete(o3);
 }
 
+#if BBE_ALLOCATOR_STATS
+TEST_F(FreeListAllocatorTest, Stats)
+{
+    auto o1 = m_allocator->allocateNew<uint32_t>(1);
+    auto o2 = m_allocator->allocateArray<char>(100);
+    auto o3 = m_allocator->allocateArray<char>(MEMORY_SIZE);
+    EXPECT_EQ(o3, nullptr);
+
+    bbe::AllocatorStats stats = m_allocator->getStats();
+    EXPECT_EQ(stats.m_allocations, 2);
+    EXPECT_EQ(stats.m_failedAllocations, 1);
+    EXPECT_EQ(stats.m_openAllocations, 2);
+    EXPECT_EQ(stats.m_usedMemory, m_allocator->getUsedMemory());
+    EXPECT_EQ(stats.m_sizeHistogram[bbe::AllocatorStats::getHistogramBucket(sizeof(uint32_t))], 1);
+
+    m_allocator->deallocateDelete(o1);
+    m_allocator->deallocateArray(o2);
+    stats = m_allocator->getStats();
+    EXPECT_EQ(stats.m_deallocations, 2);
+    EXPECT_EQ(stats.m_usedMemory, 0);
+    EXPECT_EQ(stats.m_alignmentWaste, 0);
+    EXPECT_GT(stats.m_peakUsedMemory, 100);
+}
+#endif
+
+TEST_F(FreeListAllocatorTest, Fragmentation)
+{
+    const size_t size = m_allocator->getSize();
+    bbe::FragmentationStats fragmentation = m_allocator->getFragmentation();
+    EXPECT_EQ(fragmentation.m_freeBlocks, 1);
+    EXPECT_EQ(fragmentation.m_largestFreeBlock, size);
+
+    auto o1 = m_allocator->allocateArray<char>(100);
+    auto o2 = m_allocator->allocateArray<char>(100);
+    auto o3 = m_allocator->allocateArray<char>(100);
+    m_allocator->deallocateArray(o2);
+
+    fragmentation = m_allocator->getFragmentation();
+    EXPECT_EQ(fragmentation.m_freeBlocks, 2);
+    EXPECT_EQ(fragmentation.m_freeMemory, size - m_allocator->getUsedMemory());
+    EXPECT_GT(fragmentation.getRecoverableBytes(), 100);
+    EXPECT_GT(fragmentation.getExternalFragmentation(), 0.0);
+
+    // The tail is the largest block, allocating from it has to find the next largest one
+    auto o4 = m_allocator->allocateArray<char>(fragmentation.m_largestFreeBlock - 32);
+    fragmentation = m_allocator->getFragmentation();
+    EXPECT_GT(fragmentation.m_largestFreeBlock, 100);
+    EXPECT_LT(fragmentation.m_largestFreeBlock, 200);
+
+    m_allocator->deallocateArray(o1);
+    m_allocator->deallocateArray(o4);
+    m_allocator->deallocateArray(o3);
+    fragmentation = m_allocator->getFragmentation();
+    EXPECT_EQ(fragmentation.m_freeBlocks, 1);
+    EXPECT_EQ(fragmentation.m_largestFreeBlock, size);
+    EXPECT_EQ(fragmentation.getExternalFragmentation(), 0.0);
+}
+
+TEST(FreeListAllocatorRandomTest, FragmentationMatchesFreeMemory)
+{
+    const size_t MEMORY_SIZE = 64 * 1024;
+    byte *memory = new byte[MEMORY_SIZE];
+    FreeListAllocator *allocator = new FreeListAllocator(MEMORY_SIZE, memory, 64);
+    std::vector<FreeListAllocator::AllocatorPointer<byte>> live;
+    std::mt19937 random(5);
+
+    for (size_t i = 0; i < 20000; i++)
+    {
+        // The allocator can't defragment yet, so the largest free block decides if an allocation fits
+        size_t size = random() % 512 + 1;
+        if (live.empty() || (random() % 3 != 0 && size + 32 <= allocator->getFragmentation().m_largestFreeBlock))
+        {
+            auto p = allocator->allocate(size, (uint8_t)(1 << (random() % 4)));
+            ASSERT_NE(p, nullptr);
+            live.push_back(p);
+        }
+        else
+        {
+            size_t index = random() % live.size();
+            allocator->deallocate(&live[index]);
+            live[index] = live.back();
+            live.pop_back();
+        }
+
+        bbe::FragmentationStats fragmentation = allocator->getFragmentation();
+        ASSERT_EQ(fragmentation.m_freeMemory, allocator->getSize() - allocator->getUsedMemory());
+        uint64_t histogramSum = 0;
+        for (uint64_t count : fragmentation.m_freeBlockHistogram)
+        {
+            histogramSum += count;
+        }
+        ASSERT_EQ(histogramSum, fragmentation.m_freeBlocks);
+        ASSERT_LE(fragmentation.m_largestFreeBlock, fragmentation.m_freeMemory);
+        ASSERT_EQ(fragmentation.m_largestFreeBlock == 0, fragmentation.m_freeBlocks == 0);
+    }
+
+    for (auto &p : live)
+    {
+        allocator->deallocate(&p);
+    }
+    EXPECT_EQ(allocator->getFragmentation().m_freeBlocks, 1);
+    EXPECT_EQ(allocator->getFragmentation().m_largestFreeBlock, MEMORY_SIZE);
+    delete allocator;
+    delete[] memory;
+}
+
 } // namespace arcane
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "../../../MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../ShardedFreeListAllocator.h"
+
+namespace arcane
+{
+
+struct ShardedFreeListAllocatorTest : testing::Test
+{
+    byte *m_memory;
+    ShardedFreeListAllocator *m_allocator;
+    const size_t MEMORY_SIZE = 64 * 1024 * 1024;
+    const size_t SHARD_COUNT = 4;
+    const size_t HANDLE_TABLE_LENGTH = 1024;
+
+    ShardedFreeListAllocatorTest()
+    {
+        m_memory = new byte[MEMORY_SIZE];
+
+        ASSERT(m_memory && "Could not allocate m_memory from system!");
+
+        m_allocator = new ShardedFreeListAllocator(MEMORY_SIZE, m_memory, SHARD_COUNT, HANDLE_TABLE_LENGTH);
+    }
+
+    virtual ~ShardedFreeListAllocatorTest()
+    {
+        EXPECT_EQ(m_allocator->getNumAllocations(), 0);
+        EXPECT_EQ(m_allocator->getUsedMemory(), 0);
+        delete m_allocator;
+        delete[] m_memory;
+    }
+};
+
+TEST_F(ShardedFreeListAllocatorTest, StealsFromOtherShards)
+{
+    const size_t blockSize = MEMORY_SIZE / SHARD_COUNT / 3;
+    std::vector<FreeListAllocator::AllocatorPointer<byte>> blocks;
+
+    // Every shard fits two blocks, once the home shard is full the others have to serve the requests
+    for (size_t i = 0; i < SHARD_COUNT * 2; i++)
+    {
+        blocks.push_back(m_allocator->allocate(blockSize, DEFAULT_ALIGNMENT));
+        ASSERT_TRUE(blocks.back().isValid());
+    }
+    EXPECT_EQ(m_allocator->getSteals(), (SHARD_COUNT - 1) * 2);
+    EXPECT_EQ(blocks[0].getParent(), blocks[1].getParent());
+    EXPECT_NE(blocks[1].getParent(), blocks[2].getParent());
+    EXPECT_FALSE(m_allocator->allocate(blockSize, DEFAULT_ALIGNMENT).isValid());
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        m_allocator->deallocate(&blocks[i]);
+    }
+    EXPECT_FALSE(m_allocator->defragment());
+}
+
+TEST_F(ShardedFreeListAllocatorTest, StealsWhenHomeShardIsFragmented)
+{
+    const size_t SMALL_MEMORY_SIZE = 128 * 1024;
+    byte *memory = new byte[SMALL_MEMORY_SIZE];
+    ShardedFreeListAllocator *allocator = new ShardedFreeListAllocator(SMALL_MEMORY_SIZE, memory, 2, 256);
+
+    // Fills the home shard, the first block which doesn't fit anymore is stolen from the other one
+    std::vector<FreeListAllocator::AllocatorPointer<byte>> blocks;
+    while (allocator->getSteals() == 0)
+    {
+        blocks.push_back(allocator->allocate(1000, DEFAULT_ALIGNMENT));
+        ASSERT_TRUE(blocks.back().isValid());
+    }
+    allocator->deallocate(&blocks.back());
+    blocks.pop_back();
+
+    // Plenty of free memory in the home shard, but no block which is large enough
+    for (size_t i = 0; i < blocks.size(); i += 2)
+    {
+        allocator->deallocate(&blocks[i]);
+    }
+    EXPECT_GT(allocator->getFragmentation().m_freeMemory, 4096 * 2);
+
+    FreeListAllocator::AllocatorPointer<byte> large = allocator->allocate(4096, DEFAULT_ALIGNMENT);
+    ASSERT_TRUE(large.isValid());
+    EXPECT_NE(large.getParent(), blocks[1].getParent());
+    EXPECT_EQ(allocator->getSteals(), 2);
+
+    allocator->deallocate(&large);
+    for (size_t i = 1; i < blocks.size(); i += 2)
+    {
+        allocator->deallocate(&blocks[i]);
+    }
+    EXPECT_EQ(allocator->getNumAllocations(), 0);
+    delete allocator;
+    delete[] memory;
+}
+
+TEST_F(ShardedFreeListAllocatorTest, CrossThreadDeallocation)
+{
+    std::vector<FreeListAllocator::AllocatorPointer<byte>> blocks;
+    for (size_t i = 0; i < 100; i++)
+    {
+        blocks.push_back(m_allocator->allocate(512, DEFAULT_ALIGNMENT));
+        *blocks.back().getRaw() = (byte)i;
+    }
+
+    std::thread worker([&]() {
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            EXPECT_EQ(*blocks[i].getRaw(), (byte)i);
+            m_allocator->deallocate(&blocks[i]);
+        }
+    });
+    worker.join();
+}
+
+struct ShardedFreeListAllocatorBenchmark : ShardedFreeListAllocatorTest
+{
+};
+
+TEST_F(ShardedFreeListAllocatorBenchmark, SingleVsSharded)
+{
+    const size_t OPERATIONS_PER_THREAD = 50000;
+    const size_t LIVE_BLOCKS_PER_THREAD = 64;
+    const size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+
+    // Same memory and handles as the sharded allocator, but behind a single lock
+    byte *memory = new byte[MEMORY_SIZE];
+    FreeListAllocator *single = new FreeListAllocator(MEMORY_SIZE, memory, HANDLE_TABLE_LENGTH * SHARD_COUNT);
+    std::mutex singleMutex;
+
+    // The last step is clamped to maxThreads, which doesn't have to be a power of two
+    for (size_t threadCount = 1; threadCount <= maxThreads;
+         threadCount = (threadCount < maxThreads && threadCount * 2 > maxThreads) ? maxThreads : threadCount * 2)
+    {
+        for (int sharded = 0; sharded < 2; sharded++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < threadCount; t++)
+            {
+                threads.emplace_back([&, t]() {
+                    std::mt19937 random(t);
+                    std::uniform_int_distribution<size_t> sizes(256, 8192);
+
+                    auto allocate = [&](size_t size) {
+                        if (sharded)
+                        {
+                            return m_allocator->allocate(size, DEFAULT_ALIGNMENT);
+                        }
+                        std::lock_guard<std::mutex> lock(singleMutex);
+                        return single->allocate(size, DEFAULT_ALIGNMENT);
+                    };
+                    auto deallocate = [&](FreeListAllocator::AllocatorPointer<byte> *p) {
+                        if (sharded)
+                        {
+                            m_allocator->deallocate(p);
+                            return;
+                        }
+                        std::lock_guard<std::mutex> lock(singleMutex);
+                        single->deallocate(p);
+                    };
+
+                    FreeListAllocator::AllocatorPointer<byte> blocks[LIVE_BLOCKS_PER_THREAD];
+                    for (size_t i = 0; i < OPERATIONS_PER_THREAD; i++)
+                    {
+                        size_t slot = i % LIVE_BLOCKS_PER_THREAD;
+                        if (i >= LIVE_BLOCKS_PER_THREAD)
+                        {
+                            deallocate(&blocks[slot]);
+                        }
+                        blocks[slot] = allocate(sizes(random));
+                        *blocks[slot].getRaw() = (byte)i;
+                    }
+
+                    for (size_t slot = 0; slot < LIVE_BLOCKS_PER_THREAD; slot++)
+                    {
+                        deallocate(&blocks[slot]);
+                    }
+                });
+            }
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            }
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            GTEST_COUT << (sharded ? "Sharded " : "Single  ") << threadCount << " threads: "
+                       << threadCount * OPERATIONS_PER_THREAD / elapsed << " ops/ms" << std::endl;
+        }
+    }
+    GTEST_COUT << "Steals: " << m_allocator->getSteals() << std::endl;
+
+    delete single;
+    delete[] memory;
+}
+
+} // namespace arcane
@@ -0,0 +1,207 @@
+#include "../../../MainTest.h"
+
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../ThreadCachingAllocator.h"
+
+namespace arcane
+{
+
+struct ThreadCachingAllocatorTest : testing::Test
+{
+    void *m_memory;
+    FreeListAllocator *m_backend;
+    ThreadCachingAllocator *m_allocator;
+    const size_t MEMORY_SIZE = 64 * 1024 * 1024 + sizeof(FreeListAllocator);
+    const size_t HANDLE_TABLE_LENGTH = 1024;
+
+    ThreadCachingAllocatorTest()
+    {
+        m_memory = new byte[MEMORY_SIZE];
+
+        ASSERT(m_memory && "Could not allocate m_memory from system!");
+
+        m_backend = new (m_memory) FreeListAllocator(MEMORY_SIZE - sizeof(FreeListAllocator),
+                                                     pointer_math::add(m_memory, sizeof(FreeListAllocator)), HANDLE_TABLE_LENGTH);
+        m_allocator = new ThreadCachingAllocator(*m_backend);
+    }
+
+    virtual ~ThreadCachingAllocatorTest()
+    {
+        delete m_allocator;
+        EXPECT_EQ(m_backend->getNumAllocations(), 0);
+        EXPECT_EQ(m_backend->getUsedMemory(), 0);
+        delete m_backend;
+    }
+};
+
+TEST_F(ThreadCachingAllocatorTest, ReusesCachedBlocks)
+{
+    ThreadCachingAllocator::ThreadCache cache(*m_allocator);
+
+    auto p1 = cache.allocate(24);
+    EXPECT_TRUE(p1.isValid());
+    const size_t acquisitions = m_allocator->getLockAcquisitions();
+    EXPECT_EQ(acquisitions, 1);
+
+    void *raw = p1.getRaw();
+    cache.deallocate(&p1, 24);
+    EXPECT_FALSE(p1.isValid());
+
+    // Same size class, comes straight from the magazine without locking
+    auto p2 = cache.allocate(32);
+    EXPECT_EQ(p2.getRaw(), raw);
+    EXPECT_EQ(m_allocator->getLockAcquisitions(), acquisitions);
+
+    auto big = cache.allocate(ThreadCachingAllocator::MAX_SIZE_CLASS + 1);
+    EXPECT_TRUE(big.isValid());
+    cache.deallocate(&big, ThreadCachingAllocator::MAX_SIZE_CLASS + 1);
+
+    cache.deallocate(&p2, 32);
+}
+
+TEST_F(ThreadCachingAllocatorTest, OverAlignedBlocksBypassTheCache)
+{
+    ThreadCachingAllocator::ThreadCache cache(*m_allocator);
+
+    // Exactly 20 bytes from the shared allocator, it must not end up in the 32 byte magazine
+    auto aligned = cache.allocate(20, 16);
+    EXPECT_TRUE(aligned.isValid());
+    EXPECT_EQ((uintptr_t)aligned.getRaw() % 16, 0);
+    void *raw = aligned.getRaw();
+    cache.deallocate(&aligned, 20, 16);
+    EXPECT_EQ(m_backend->getNumAllocations(), 0);
+
+    auto p1 = cache.allocate(32);
+    auto p2 = cache.allocate(32);
+    EXPECT_NE(p1.getRaw(), raw);
+    memset(p1.getRaw(), 0xFF, 32);
+    memset(p2.getRaw(), 0xFF, 32);
+    cache.deallocate(&p1, 32);
+    cache.deallocate(&p2, 32);
+
+    std::vector<FreeListAllocator::AllocatorPointer<byte>> blocks;
+    for (size_t i = 0; i < 100; i++)
+    {
+        blocks.push_back(cache.allocate(i % 60 + 1, (uint8_t)(16 << (i % 3))));
+        EXPECT_EQ((uintptr_t)blocks.back().getRaw() % (16 << (i % 3)), 0);
+        memset(blocks.back().getRaw(), (int)i, i % 60 + 1);
+    }
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        EXPECT_EQ(blocks[i].getRaw()[i % 60], (byte)i);
+        cache.deallocate(&blocks[i], i % 60 + 1, (uint8_t)(16 << (i % 3)));
+    }
+}
+
+TEST_F(ThreadCachingAllocatorTest, FlushesFullMagazines)
+{
+    ThreadCachingAllocator::ThreadCache cache(*m_allocator);
+    std::vector<FreeListAllocator::AllocatorPointer<byte>> blocks;
+
+    for (size_t i = 0; i < ThreadCachingAllocator::MAGAZINE_SIZE * 2; i++)
+    {
+        blocks.push_back(cache.allocate(64));
+    }
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        cache.deallocate(&blocks[i], 64);
+    }
+
+    // At most one full magazine stays cached
+    EXPECT_LE(m_backend->getNumAllocations(), ThreadCachingAllocator::MAGAZINE_SIZE);
+
+    cache.flush();
+    EXPECT_EQ(m_backend->getNumAllocations(), 0);
+}
+
+TEST_F(ThreadCachingAllocatorTest, CrossThreadDeallocation)
+{
+    std::vector<FreeListAllocator::AllocatorPointer<byte>> blocks;
+    {
+        ThreadCachingAllocator::ThreadCache cache(*m_allocator);
+        for (size_t i = 0; i < 100; i++)
+        {
+            blocks.push_back(cache.allocate(128));
+            *blocks.back().getRaw() = (byte)i;
+        }
+    }
+
+    std::thread worker([&]() {
+        ThreadCachingAllocator::ThreadCache cache(*m_allocator);
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            EXPECT_EQ(*blocks[i].getRaw(), (byte)i);
+            cache.deallocate(&blocks[i], 128);
+        }
+    });
+    worker.join();
+}
+
+struct ThreadCachingAllocatorBenchmark : ThreadCachingAllocatorTest
+{
+};
+
+TEST_F(ThreadCachingAllocatorBenchmark, LockedVsCached)
+{
+    const size_t OPERATIONS_PER_THREAD = 50000;
+    const size_t LIVE_BLOCKS_PER_THREAD = 64;
+    const size_t THREAD_COUNTS[] = {1, 2, 4, 8, 16, 32};
+
+    for (size_t threadCount : THREAD_COUNTS)
+    {
+        for (int cached = 0; cached < 2; cached++)
+        {
+            const size_t acquisitionsBefore = m_allocator->getLockAcquisitions();
+            const uint64_t holdBefore = m_allocator->getLockHoldNanoseconds();
+
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < threadCount; t++)
+            {
+                threads.emplace_back([&, t]() {
+                    ThreadCachingAllocator::ThreadCache cache(*m_allocator);
+                    std::mt19937 random(t);
+                    std::uniform_int_distribution<size_t> sizes(16, 1024);
+
+                    FreeListAllocator::AllocatorPointer<byte> blocks[LIVE_BLOCKS_PER_THREAD];
+                    size_t blockSizes[LIVE_BLOCKS_PER_THREAD] = {};
+
+                    for (size_t i = 0; i < OPERATIONS_PER_THREAD; i++)
+                    {
+                        size_t slot = i % LIVE_BLOCKS_PER_THREAD;
+                        if (blockSizes[slot] != 0)
+                        {
+                            cached ? cache.deallocate(&blocks[slot], blockSizes[slot]) : m_allocator->deallocate(&blocks[slot]);
+                        }
+                        blockSizes[slot] = sizes(random);
+                        blocks[slot] = cached ? cache.allocate(blockSizes[slot]) : m_allocator->allocate(blockSizes[slot], DEFAULT_ALIGNMENT);
+                        *blocks[slot].getRaw() = (byte)i;
+                    }
+
+                    for (size_t slot = 0; slot < LIVE_BLOCKS_PER_THREAD; slot++)
+                    {
+                        cached ? cache.deallocate(&blocks[slot], blockSizes[slot]) : m_allocator->deallocate(&blocks[slot]);
+                    }
+                });
+            }
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            }
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            const size_t acquisitions = m_allocator->getLockAcquisitions() - acquisitionsBefore;
+            const double holdTime = (m_allocator->getLockHoldNanoseconds() - holdBefore) / 1e6;
+
+            GTEST_COUT << (cached ? "Cached " : "Locked ") << threadCount << " threads: "
+                       << threadCount * OPERATIONS_PER_THREAD / elapsed << " ops/ms, "
+                       << acquisitions << " locks held " << holdTime << "ms" << std::endl;
+        }
+    }
+}
+
+} // namespace arcane
@@ -0,0 +1,163 @@
+#include "Archetype.h"
+
+using namespace arcane;
+
+static ComponentInfo s_components[MAX_COMPONENTS];
+static uint32_t s_component_count = 0;
+
+uint32_t component_detail::registerComponent(const ComponentInfo &info)
+{
+	ASSERT(s_component_count < MAX_COMPONENTS && "Too many component types!");
+
+	s_components[s_component_count] = info;
+	return s_component_count++;
+}
+
+const ComponentInfo &arcane::getComponentInfo(uint32_t id)
+{
+	ASSERT(id < s_component_count);
+	return s_components[id];
+}
+
+Archetype::Archetype(ComponentMask mask, bbe::PoolAllocator<EcsChunk> &chunk_pool)
+	: m_mask(mask), m_chunk_capacity(0), m_length(0), m_chunk_pool(chunk_pool)
+{
+	for (uint32_t i = 0; i < MAX_COMPONENTS; i++)
+	{
+		m_add_edges[i] = nullptr;
+		m_remove_edges[i] = nullptr;
+		m_component_offsets[i] = 0;
+	}
+
+	// As many rows as fit, if every array needs its worst case padding
+	size_t row_size = sizeof(Entity);
+	size_t padding = 0;
+	for (uint32_t i = 0; i < MAX_COMPONENTS; i++)
+	{
+		if (hasComponent(i))
+		{
+			row_size += getComponentInfo(i).m_size;
+			padding += getComponentInfo(i).m_alignment;
+		}
+	}
+	m_chunk_capacity = (ECS_CHUNK_SIZE - padding) / row_size;
+	ASSERT(m_chunk_capacity > 0 && "Components don't fit into a chunk!");
+
+	// The entity array comes first, then one array per component
+	size_t offset = m_chunk_capacity * sizeof(Entity);
+	for (uint32_t i = 0; i < MAX_COMPONENTS; i++)
+	{
+		if (hasComponent(i))
+		{
+			const ComponentInfo &info = getComponentInfo(i);
+			offset = (offset + info.m_alignment - 1) / info.m_alignment * info.m_alignment;
+			m_component_offsets[i] = offset;
+			offset += m_chunk_capacity * info.m_size;
+		}
+	}
+	ASSERT(offset <= ECS_CHUNK_SIZE);
+}
+
+Archetype::~Archetype()
+{
+	while (m_length > 0)
+	{
+		removeRow(m_length - 1);
+	}
+}
+
+size_t Archetype::addRow(Entity entity)
+{
+	if (m_length == m_chunks.size() * m_chunk_capacity)
+	{
+		m_chunks.push_back(m_chunk_pool.allocate());
+	}
+
+	const size_t row = m_length++;
+	getEntities(row / m_chunk_capacity)[row % m_chunk_capacity] = entity;
+	return row;
+}
+
+Entity Archetype::removeRow(size_t row)
+{
+	ASSERT(row < m_length);
+
+	const size_t last = m_length - 1;
+	Entity moved = INVALID_ENTITY;
+
+	for (uint32_t i = 0; i < MAX_COMPONENTS; i++)
+	{
+		if (hasComponent(i))
+		{
+			const ComponentInfo &info = getComponentInfo(i);
+			info.m_destroy(getComponent(row, i));
+			if (row != last)
+			{
+				info.m_move(getComponent(row, i), getComponent(last, i));
+				info.m_destroy(getComponent(last, i));
+			}
+		}
+	}
+
+	if (row != last)
+	{
+		moved = getEntities(last / m_chunk_capacity)[last % m_chunk_capacity];
+		getEntities(row / m_chunk_capacity)[row % m_chunk_capacity] = moved;
+	}
+
+	m_length--;
+	if (m_length == (m_chunks.size() - 1) * m_chunk_capacity)
+	{
+		m_chunk_pool.deallocate(m_chunks.back());
+		m_chunks.pop_back();
+	}
+
+	return moved;
+}
+
+ComponentMask Archetype::getMask() const
+{
+	return m_mask;
+}
+
+bool Archetype::hasComponent(uint32_t component) const
+{
+	return (m_mask >> component) & 1;
+}
+
+size_t Archetype::getLength() const
+{
+	return m_length;
+}
+
+size_t Archetype::getChunkCount() const
+{
+	return m_chunks.size();
+}
+
+size_t Archetype::getChunkCapacity() const
+{
+	return m_chunk_capacity;
+}
+
+size_t Archetype::getChunkLength(size_t chunk) const
+{
+	return chunk + 1 < m_chunks.size() ? m_chunk_capacity : m_length - chunk * m_chunk_capacity;
+}
+
+Entity *Archetype::getEntities(size_t chunk)
+{
+	return reinterpret_cast<Entity *>(m_chunks[chunk]->m_data);
+}
+
+void *Archetype::getComponents(size_t chunk, uint32_t component)
+{
+	ASSERT(hasComponent(component));
+	return m_chunks[chunk]->m_data + m_component_offsets[component];
+}
+
+void *Archetype::getComponent(size_t row, uint32_t component)
+{
+	const ComponentInfo &info = getComponentInfo(component);
+	return static_cast<byte *>(getComponents(row / m_chunk_capacity, component)) + (row % m_chunk_capacity) * info.m_size;
+}
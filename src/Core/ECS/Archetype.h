@@ -0,0 +1,135 @@
+#pragma once
+
+#include "../../Utilities/DataTypes.h"
+#include "../../Utilities/Debug.h"
+
+#include "MemoryManagement/PoolAllocator.h"
+
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace arcane
+{
+
+typedef uint64_t ComponentMask;
+static const uint32_t MAX_COMPONENTS = 64;
+static const size_t ECS_CHUNK_SIZE = 16 * 1024;
+
+struct Entity
+{
+    uint32_t m_index;
+    uint32_t m_generation;
+
+    bool operator==(const Entity &other) const
+    {
+        return m_index == other.m_index && m_generation == other.m_generation;
+    }
+
+    bool operator!=(const Entity &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+static const Entity INVALID_ENTITY = {UINT32_MAX, 0};
+
+struct alignas(64) EcsChunk
+{
+    byte m_data[ECS_CHUNK_SIZE];
+};
+
+// Type erased operations of a component type, registered once per type on first use
+struct ComponentInfo
+{
+    size_t m_size;
+    size_t m_alignment;
+    void (*m_move)(void *destination, void *source); // Move constructs into uninitialized memory
+    void (*m_destroy)(void *component);
+};
+
+namespace component_detail
+{
+
+uint32_t registerComponent(const ComponentInfo &info);
+
+template <typename T>
+void moveComponent(void *destination, void *source)
+{
+    new (destination) T(std::move(*static_cast<T *>(source)));
+}
+
+template <typename T>
+void destroyComponent(void *component)
+{
+    static_cast<T *>(component)->~T();
+}
+
+}; // namespace component_detail
+
+const ComponentInfo &getComponentInfo(uint32_t id);
+
+template <typename T>
+uint32_t getComponentId()
+{
+    static_assert(alignof(T) <= alignof(EcsChunk), "Components can't be aligned more than their chunk!");
+
+    static const uint32_t id = component_detail::registerComponent(
+        ComponentInfo{sizeof(T), alignof(T), &component_detail::moveComponent<T>, &component_detail::destroyComponent<T>});
+    return id;
+}
+
+template <typename... Components>
+ComponentMask getComponentMask()
+{
+    return (ComponentMask(0) | ... | (ComponentMask(1) << getComponentId<Components>()));
+}
+
+// All entities with exactly the same set of components. Every component has its own array in a chunk (SoA),
+// the rows are kept dense: removing a row moves the last row into the hole.
+class Archetype
+{
+public:
+    Archetype(ComponentMask mask, bbe::PoolAllocator<EcsChunk> &chunk_pool);
+    ~Archetype();
+
+    // Appends a row for entity, its components are left uninitialized
+    size_t addRow(Entity entity);
+
+    // Destroys the components of row and moves the last row into it. Returns the entity which was moved
+    // into row, or INVALID_ENTITY if row was the last one.
+    Entity removeRow(size_t row);
+
+    ComponentMask getMask() const;
+    bool hasComponent(uint32_t component) const;
+
+    size_t getLength() const;
+    size_t getChunkCount() const;
+    size_t getChunkCapacity() const;
+    size_t getChunkLength(size_t chunk) const;
+
+    Entity *getEntities(size_t chunk);
+
+    // Start of the array of component in chunk, component has to be part of the mask
+    void *getComponents(size_t chunk, uint32_t component);
+    void *getComponent(size_t row, uint32_t component);
+
+    // Archetypes which have one component more (or less), filled in lazily by the World
+    Archetype *m_add_edges[MAX_COMPONENTS];
+    Archetype *m_remove_edges[MAX_COMPONENTS];
+
+private:
+    Archetype(const Archetype &);
+    Archetype &operator=(const Archetype &);
+
+    ComponentMask m_mask;
+    size_t m_chunk_capacity;
+    size_t m_component_offsets[MAX_COMPONENTS];
+    size_t m_length;
+
+    bbe::PoolAllocator<EcsChunk> &m_chunk_pool;
+    std::vector<EcsChunk *> m_chunks;
+};
+
+}; // namespace arcane
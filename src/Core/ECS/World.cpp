@@ -0,0 +1,181 @@
+#include "World.h"
+
+using namespace arcane;
+
+World::World(size_t chunk_count)
+	: m_chunk_pool(chunk_count), m_entity_count(0), m_empty_archetype(nullptr)
+{
+	m_empty_archetype = getArchetype(0);
+}
+
+World::~World()
+{
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		delete m_archetypes[i];
+	}
+	for (size_t i = 0; i < m_queries.size(); i++)
+	{
+		delete m_queries[i];
+	}
+}
+
+Entity World::createEntity()
+{
+	return allocateEntity(m_empty_archetype);
+}
+
+Entity World::allocateEntity(Archetype *archetype)
+{
+	Entity entity;
+	if (!m_free_entities.empty())
+	{
+		entity.m_index = m_free_entities.back();
+		m_free_entities.pop_back();
+	}
+	else
+	{
+		entity.m_index = (uint32_t)m_entities.size();
+		m_entities.push_back(EntityRecord{nullptr, 0, 0});
+	}
+
+	EntityRecord &record = m_entities[entity.m_index];
+	entity.m_generation = record.m_generation;
+	record.m_archetype = archetype;
+	record.m_row = archetype->addRow(entity);
+	m_entity_count++;
+	return entity;
+}
+
+void World::destroyEntity(Entity entity)
+{
+	EntityRecord &record = getRecord(entity);
+
+	Entity moved = record.m_archetype->removeRow(record.m_row);
+	if (moved != INVALID_ENTITY)
+	{
+		m_entities[moved.m_index].m_row = record.m_row;
+	}
+
+	// Handles of the destroyed entity are recognized as stale from now on
+	record.m_archetype = nullptr;
+	record.m_generation++;
+	m_free_entities.push_back(entity.m_index);
+	m_entity_count--;
+}
+
+bool World::isAlive(Entity entity) const
+{
+	return entity.m_index < m_entities.size() && m_entities[entity.m_index].m_generation == entity.m_generation &&
+		   m_entities[entity.m_index].m_archetype != nullptr;
+}
+
+World::EntityRecord &World::getRecord(Entity entity)
+{
+	ASSERT(isAlive(entity));
+	return m_entities[entity.m_index];
+}
+
+Archetype *World::getArchetype(ComponentMask mask)
+{
+	Archetype **existing = m_archetype_lookup.get(mask);
+	if (existing != nullptr)
+	{
+		return *existing;
+	}
+
+	Archetype *archetype = new Archetype(mask, m_chunk_pool);
+	m_archetypes.push_back(archetype);
+	m_archetype_lookup.add(mask, archetype);
+
+	// Cached queries only learn about new archetypes here
+	for (size_t i = 0; i < m_queries.size(); i++)
+	{
+		if ((mask & m_queries[i]->m_mask) == m_queries[i]->m_mask)
+		{
+			m_queries[i]->m_archetypes.push_back(archetype);
+		}
+	}
+
+	return archetype;
+}
+
+Archetype *World::getAddTarget(Archetype *archetype, uint32_t component)
+{
+	if (archetype->m_add_edges[component] == nullptr)
+	{
+		Archetype *target = getArchetype(archetype->getMask() | (ComponentMask(1) << component));
+		archetype->m_add_edges[component] = target;
+		target->m_remove_edges[component] = archetype;
+	}
+	return archetype->m_add_edges[component];
+}
+
+Archetype *World::getRemoveTarget(Archetype *archetype, uint32_t component)
+{
+	if (archetype->m_remove_edges[component] == nullptr)
+	{
+		Archetype *target = getArchetype(archetype->getMask() & ~(ComponentMask(1) << component));
+		archetype->m_remove_edges[component] = target;
+		target->m_add_edges[component] = archetype;
+	}
+	return archetype->m_remove_edges[component];
+}
+
+void World::moveEntity(Entity entity, Archetype *target)
+{
+	EntityRecord &record = m_entities[entity.m_index];
+	Archetype *source = record.m_archetype;
+
+	const size_t target_row = target->addRow(entity);
+	const ComponentMask shared = source->getMask() & target->getMask();
+	for (uint32_t i = 0; i < MAX_COMPONENTS; i++)
+	{
+		if ((shared >> i) & 1)
+		{
+			getComponentInfo(i).m_move(target->getComponent(target_row, i), source->getComponent(record.m_row, i));
+		}
+	}
+
+	Entity moved = source->removeRow(record.m_row);
+	if (moved != INVALID_ENTITY)
+	{
+		m_entities[moved.m_index].m_row = record.m_row;
+	}
+
+	record.m_archetype = target;
+	record.m_row = target_row;
+}
+
+World::Query &World::getQuery(ComponentMask mask)
+{
+	Query **existing = m_query_lookup.get(mask);
+	if (existing != nullptr)
+	{
+		return **existing;
+	}
+
+	Query *query = new Query();
+	query->m_mask = mask;
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		if ((m_archetypes[i]->getMask() & mask) == mask)
+		{
+			query->m_archetypes.push_back(m_archetypes[i]);
+		}
+	}
+
+	m_queries.push_back(query);
+	m_query_lookup.add(mask, query);
+	return *query;
+}
+
+size_t World::getEntityCount() const
+{
+	return m_entity_count;
+}
+
+size_t World::getArchetypeCount() const
+{
+	return m_archetypes.size();
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Archetype.h"
+
+#include "DataStructures/HashMap.h"
+
+#include <vector>
+
+namespace arcane
+{
+
+// Archetype based entity component storage. Entities with the same set of components share an Archetype,
+// whose chunks come from one PoolAllocator of 16 KB chunks. Adding or removing a component moves the entity
+// to the neighbouring archetype, the edges between archetypes are cached.
+//
+// Queries are cached per component set as well: the list of matching archetypes is built on the first
+// forEach and extended whenever a new archetype is created, so iterating never looks at archetypes which
+// don't match.
+class World
+{
+public:
+    static const size_t DEFAULT_CHUNK_COUNT = 1024;
+
+    // chunk_count chunks of ECS_CHUNK_SIZE bytes are reserved up front
+    explicit World(size_t chunk_count = DEFAULT_CHUNK_COUNT);
+    ~World();
+
+    Entity createEntity();
+
+    template <typename... Components>
+    Entity createEntity(Components &&... components);
+
+    void destroyEntity(Entity entity);
+    bool isAlive(Entity entity) const;
+
+    // Replaces the component if the entity already has one
+    template <typename T, typename... Arguments>
+    T &addComponent(Entity entity, Arguments &&... arguments);
+
+    template <typename T>
+    void removeComponent(Entity entity);
+
+    // nullptr if the entity doesn't have the component
+    template <typename T>
+    T *getComponent(Entity entity);
+
+    template <typename T>
+    bool hasComponent(Entity entity) const;
+
+    // Calls function(Components &...) for every entity which has all of the components
+    template <typename... Components, typename Function>
+    void forEach(const Function &function);
+
+    // Calls function(count, Entity *, Components *...) with the arrays of every matching chunk
+    template <typename... Components, typename Function>
+    void forEachChunk(const Function &function);
+
+    size_t getEntityCount() const;
+    size_t getArchetypeCount() const;
+
+private:
+    struct EntityRecord
+    {
+        Archetype *m_archetype;
+        size_t m_row;
+        uint32_t m_generation;
+    };
+
+    struct Query
+    {
+        ComponentMask m_mask;
+        std::vector<Archetype *> m_archetypes;
+    };
+
+    World(const World &);
+    World &operator=(const World &);
+
+    template <typename Function, typename... Components>
+    static void forEachRow(const Function &function, size_t count, Components *... components);
+
+    Entity allocateEntity(Archetype *archetype);
+    EntityRecord &getRecord(Entity entity);
+
+    Archetype *getArchetype(ComponentMask mask);
+    Archetype *getAddTarget(Archetype *archetype, uint32_t component);
+    Archetype *getRemoveTarget(Archetype *archetype, uint32_t component);
+
+    // Moves the components which both archetypes have, the others are destroyed
+    void moveEntity(Entity entity, Archetype *target);
+
+    Query &getQuery(ComponentMask mask);
+
+    bbe::PoolAllocator<EcsChunk> m_chunk_pool;
+
+    std::vector<EntityRecord> m_entities;
+    std::vector<uint32_t> m_free_entities;
+    size_t m_entity_count;
+
+    std::vector<Archetype *> m_archetypes;
+    bbe::HashMap<ComponentMask, Archetype *> m_archetype_lookup;
+    Archetype *m_empty_archetype;
+
+    std::vector<Query *> m_queries;
+    bbe::HashMap<ComponentMask, Query *> m_query_lookup;
+};
+
+}; // namespace arcane
+
+#include "World.inl"
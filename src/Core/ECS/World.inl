@@ -0,0 +1,111 @@
+#pragma once
+
+#include "World.h"
+
+#include <type_traits>
+
+namespace arcane
+{
+
+template <typename... Components>
+Entity World::createEntity(Components &&... components)
+{
+    Archetype *archetype = getArchetype(getComponentMask<typename std::decay<Components>::type...>());
+    Entity entity = allocateEntity(archetype);
+    const size_t row = getRecord(entity).m_row;
+
+    (new (archetype->getComponent(row, getComponentId<typename std::decay<Components>::type>()))
+         typename std::decay<Components>::type(std::forward<Components>(components)),
+     ...);
+    return entity;
+}
+
+template <typename T, typename... Arguments>
+T &World::addComponent(Entity entity, Arguments &&... arguments)
+{
+    const uint32_t component = getComponentId<T>();
+    EntityRecord &record = getRecord(entity);
+
+    if (record.m_archetype->hasComponent(component))
+    {
+        T *existing = static_cast<T *>(record.m_archetype->getComponent(record.m_row, component));
+        *existing = T(std::forward<Arguments>(arguments)...);
+        return *existing;
+    }
+
+    moveEntity(entity, getAddTarget(record.m_archetype, component));
+    return *new (record.m_archetype->getComponent(record.m_row, component)) T(std::forward<Arguments>(arguments)...);
+}
+
+template <typename T>
+void World::removeComponent(Entity entity)
+{
+    const uint32_t component = getComponentId<T>();
+    EntityRecord &record = getRecord(entity);
+
+    if (record.m_archetype->hasComponent(component))
+    {
+        moveEntity(entity, getRemoveTarget(record.m_archetype, component));
+    }
+}
+
+template <typename T>
+T *World::getComponent(Entity entity)
+{
+    const uint32_t component = getComponentId<T>();
+    EntityRecord &record = getRecord(entity);
+
+    if (!record.m_archetype->hasComponent(component))
+    {
+        return nullptr;
+    }
+    return static_cast<T *>(record.m_archetype->getComponent(record.m_row, component));
+}
+
+template <typename T>
+bool World::hasComponent(Entity entity) const
+{
+    ASSERT(isAlive(entity));
+    return m_entities[entity.m_index].m_archetype->hasComponent(getComponentId<T>());
+}
+
+template <typename Function, typename... Components>
+void World::forEachRow(const Function &function, size_t count, Components *... components)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        function(components[i]...);
+    }
+}
+
+template <typename... Components, typename Function>
+void World::forEach(const Function &function)
+{
+    Query &query = getQuery(getComponentMask<Components...>());
+
+    for (Archetype *archetype : query.m_archetypes)
+    {
+        for (size_t chunk = 0; chunk < archetype->getChunkCount(); chunk++)
+        {
+            forEachRow(function, archetype->getChunkLength(chunk),
+                       static_cast<Components *>(archetype->getComponents(chunk, getComponentId<Components>()))...);
+        }
+    }
+}
+
+template <typename... Components, typename Function>
+void World::forEachChunk(const Function &function)
+{
+    Query &query = getQuery(getComponentMask<Components...>());
+
+    for (Archetype *archetype : query.m_archetypes)
+    {
+        for (size_t chunk = 0; chunk < archetype->getChunkCount(); chunk++)
+        {
+            function(archetype->getChunkLength(chunk), archetype->getEntities(chunk),
+                     static_cast<Components *>(archetype->getComponents(chunk, getComponentId<Components>()))...);
+        }
+    }
+}
+
+}; // namespace arcane
@@ -0,0 +1,257 @@
+#include "../../../MainTest.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../World.h"
+
+namespace arcane
+{
+
+struct Position
+{
+    float x, y, z;
+};
+
+struct Velocity
+{
+    float x, y, z;
+};
+
+struct Rotation
+{
+    float x, y, z, w;
+};
+
+struct Health
+{
+    int32_t m_value;
+};
+
+struct Frozen
+{
+};
+
+TEST(WorldTest, AddAndRemoveComponents)
+{
+    World world;
+
+    Entity a = world.createEntity(Position{1, 2, 3});
+    Entity b = world.createEntity(Position{4, 5, 6}, Velocity{1, 0, 0});
+    Entity c = world.createEntity();
+    EXPECT_EQ(world.getEntityCount(), 3);
+
+    EXPECT_TRUE(world.hasComponent<Position>(a));
+    EXPECT_FALSE(world.hasComponent<Velocity>(a));
+    EXPECT_EQ(world.getComponent<Velocity>(a), nullptr);
+    EXPECT_EQ(world.getComponent<Position>(b)->y, 5);
+
+    // Moving a to the archetype of b keeps its position
+    world.addComponent<Velocity>(a, Velocity{0, 1, 0});
+    EXPECT_EQ(world.getComponent<Position>(a)->x, 1);
+    EXPECT_EQ(world.getComponent<Velocity>(a)->y, 1);
+
+    world.addComponent<Health>(c, Health{100});
+    world.addComponent<Health>(c, Health{50});
+    EXPECT_EQ(world.getComponent<Health>(c)->m_value, 50);
+
+    world.removeComponent<Position>(b);
+    EXPECT_FALSE(world.hasComponent<Position>(b));
+    EXPECT_EQ(world.getComponent<Velocity>(b)->x, 1);
+
+    // Destroying a moves no component of the others
+    world.destroyEntity(a);
+    EXPECT_FALSE(world.isAlive(a));
+    EXPECT_TRUE(world.isAlive(b));
+    EXPECT_EQ(world.getComponent<Velocity>(b)->x, 1);
+    EXPECT_EQ(world.getComponent<Health>(c)->m_value, 50);
+
+    // The index is reused, the old handle stays dead
+    Entity d = world.createEntity(Health{7});
+    EXPECT_EQ(d.m_index, a.m_index);
+    EXPECT_FALSE(world.isAlive(a));
+    EXPECT_TRUE(world.isAlive(d));
+}
+
+TEST(WorldTest, RowsStayConsistentAcrossMoves)
+{
+    World world;
+    std::vector<Entity> entities;
+
+    // Spans several chunks per archetype
+    for (int i = 0; i < 5000; i++)
+    {
+        entities.push_back(world.createEntity(Health{i}, Position{(float)i, 0, 0}));
+    }
+    for (int i = 0; i < 5000; i += 3)
+    {
+        world.addComponent<Frozen>(entities[i]);
+    }
+    for (int i = 0; i < 5000; i += 7)
+    {
+        world.removeComponent<Position>(entities[i]);
+    }
+    for (int i = 1; i < 5000; i += 11)
+    {
+        world.destroyEntity(entities[i]);
+    }
+
+    for (int i = 0; i < 5000; i++)
+    {
+        if (i % 11 == 1)
+        {
+            EXPECT_FALSE(world.isAlive(entities[i]));
+            continue;
+        }
+        ASSERT_EQ(world.getComponent<Health>(entities[i])->m_value, i);
+        EXPECT_EQ(world.hasComponent<Frozen>(entities[i]), i % 3 == 0);
+        if (i % 7 == 0)
+        {
+            EXPECT_FALSE(world.hasComponent<Position>(entities[i]));
+        }
+        else
+        {
+            EXPECT_EQ(world.getComponent<Position>(entities[i])->x, (float)i);
+        }
+    }
+}
+
+TEST(WorldTest, CachedQueriesSeeNewArchetypes)
+{
+    World world;
+    world.createEntity(Position{1, 0, 0}, Velocity{1, 0, 0});
+
+    size_t count = 0;
+    world.forEach<Position, Velocity>([&](Position &, Velocity &) { count++; });
+    EXPECT_EQ(count, 1);
+
+    // Creates an archetype after the query was cached
+    Entity frozen = world.createEntity(Position{2, 0, 0}, Velocity{1, 0, 0}, Frozen{});
+    world.createEntity(Position{3, 0, 0});
+
+    float sum = 0;
+    world.forEach<Position, Velocity>([&](Position &position, Velocity &velocity) {
+        position.x += velocity.x;
+        sum += position.x;
+    });
+    EXPECT_EQ(sum, 2 + 3);
+
+    size_t chunkEntities = 0;
+    world.forEachChunk<Frozen>([&](size_t count, Entity *entities, Frozen *) {
+        chunkEntities += count;
+        EXPECT_EQ(entities[0], frozen);
+    });
+    EXPECT_EQ(chunkEntities, 1);
+}
+
+TEST(WorldTest, DestroysComponents)
+{
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    {
+        World world;
+        std::vector<Entity> entities;
+        for (int i = 0; i < 100; i++)
+        {
+            entities.push_back(world.createEntity(shared, std::string("a string which is too long for the small buffer")));
+        }
+        for (int i = 0; i < 100; i += 2)
+        {
+            world.addComponent<Health>(entities[i], Health{i});
+        }
+        for (int i = 0; i < 100; i += 4)
+        {
+            world.destroyEntity(entities[i]);
+        }
+        EXPECT_EQ(shared.use_count(), 76);
+        EXPECT_EQ(*world.getComponent<std::string>(entities[2]), "a string which is too long for the small buffer");
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+// The object model the gameplay code used before: one heap allocation per object
+struct BenchmarkGameObject
+{
+    Position m_position;
+    Velocity m_velocity;
+    Rotation m_rotation;
+    Health m_health;
+    std::string m_name;
+};
+
+TEST(WorldBenchmark, IterateAndMove)
+{
+    const size_t AMOUNT = 1000000;
+    const size_t MOVES = 100000;
+
+    World world(8192);
+    std::vector<Entity> entities;
+    entities.reserve(AMOUNT);
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        entities.push_back(world.createEntity(Position{0, 0, 0}, Velocity{1, 1, 1}, Rotation{0, 0, 0, 1}, Health{100}));
+    }
+
+    std::vector<BenchmarkGameObject *> objects;
+    objects.reserve(AMOUNT);
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        objects.push_back(new BenchmarkGameObject{{0, 0, 0}, {1, 1, 1}, {0, 0, 0, 1}, {100}, "object"});
+    }
+
+    auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    world.forEach<Position, Velocity>([](Position &position, Velocity &velocity) {
+        position.x += velocity.x;
+        position.y += velocity.y;
+        position.z += velocity.z;
+    });
+    auto two = std::chrono::steady_clock::now();
+    world.forEach<Position, Velocity, Rotation>([](Position &position, Velocity &velocity, Rotation &rotation) {
+        position.x += velocity.x * rotation.w;
+        rotation.x += velocity.y;
+    });
+    auto three = std::chrono::steady_clock::now();
+    world.forEach<Position, Velocity, Rotation, Health>([](Position &position, Velocity &velocity, Rotation &rotation, Health &health) {
+        position.x += velocity.x * rotation.w;
+        health.m_value -= 1;
+    });
+    auto four = std::chrono::steady_clock::now();
+    for (BenchmarkGameObject *object : objects)
+    {
+        object->m_position.x += object->m_velocity.x;
+        object->m_position.y += object->m_velocity.y;
+        object->m_position.z += object->m_velocity.z;
+    }
+    auto objectsEnd = std::chrono::steady_clock::now();
+
+    GTEST_COUT << AMOUNT << " entities: 2 components " << ms(start, two) << "ms, 3 components " << ms(two, three) << "ms, 4 components "
+               << ms(three, four) << "ms, individually allocated objects " << ms(four, objectsEnd) << "ms" << std::endl;
+
+    auto moveStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < MOVES; i++)
+    {
+        world.addComponent<Frozen>(entities[i * (AMOUNT / MOVES)]);
+    }
+    auto addEnd = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < MOVES; i++)
+    {
+        world.removeComponent<Frozen>(entities[i * (AMOUNT / MOVES)]);
+    }
+    auto removeEnd = std::chrono::steady_clock::now();
+
+    GTEST_COUT << "Move between archetypes: add " << ms(moveStart, addEnd) * 1000000.0 / MOVES << "ns, remove "
+               << ms(addEnd, removeEnd) * 1000000.0 / MOVES << "ns per entity" << std::endl;
+
+    EXPECT_EQ(world.getComponent<Health>(entities[0])->m_value, 99);
+    for (BenchmarkGameObject *object : objects)
+    {
+        delete object;
+    }
+}
+
+} // namespace arcane
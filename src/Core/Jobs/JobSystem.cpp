@@ -0,0 +1,253 @@
+#include "JobSystem.h"
+
+#include <chrono>
+#include <cstring>
+
+using namespace arcane;
+
+thread_local JobSystem::Worker *JobSystem::s_current_worker = nullptr;
+
+JobSystem::Job::Job(JobFunction function, Job *parent, bbe::PoolAllocator<Job> *pool)
+	: m_function(function), m_parent(parent), m_pool(pool), m_unfinished_jobs(1)
+{
+}
+
+JobSystem::Worker::Worker(size_t index, size_t scratch_size, size_t jobs_per_worker)
+	: m_index(index), m_random((uint32_t)index * 2654435761u + 1), m_deque(jobs_per_worker), m_pool(jobs_per_worker),
+	  m_scratch_memory(new byte[scratch_size]), m_scratch(scratch_size, m_scratch_memory)
+{
+}
+
+JobSystem::Worker::~Worker()
+{
+	delete[] m_scratch_memory;
+}
+
+JobSystem::JobSystem(size_t worker_count, size_t scratch_size, size_t jobs_per_worker)
+	: m_workers(nullptr), m_worker_count(worker_count), m_running(true), m_sleeping_workers(0)
+{
+	if (m_worker_count == 0)
+	{
+		m_worker_count = std::thread::hardware_concurrency();
+	}
+	if (m_worker_count == 0)
+	{
+		m_worker_count = 1;
+	}
+
+	ASSERT(s_current_worker == nullptr && "Thread is already a worker of another JobSystem!");
+
+	m_workers = new Worker *[m_worker_count];
+	for (size_t i = 0; i < m_worker_count; i++)
+	{
+		m_workers[i] = new Worker(i, scratch_size, jobs_per_worker);
+	}
+
+	s_current_worker = m_workers[0];
+	for (size_t i = 1; i < m_worker_count; i++)
+	{
+		m_workers[i]->m_thread = std::thread(&JobSystem::workerLoop, this, std::ref(*m_workers[i]));
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	m_running.store(false, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_wake.notify_all();
+	}
+
+	for (size_t i = 1; i < m_worker_count; i++)
+	{
+		m_workers[i]->m_thread.join();
+	}
+
+	for (size_t i = 0; i < m_worker_count; i++)
+	{
+		ASSERT(m_workers[i]->m_deque.size() == 0 && "JobSystem destroyed with jobs left!");
+		delete m_workers[i];
+	}
+	delete[] m_workers;
+
+	s_current_worker = nullptr;
+}
+
+JobSystem::Job *JobSystem::createJob(JobFunction function, const void *data, size_t size)
+{
+	return allocateJob(function, nullptr, data, size);
+}
+
+JobSystem::Job *JobSystem::createChildJob(Job *parent, JobFunction function, const void *data, size_t size)
+{
+	ASSERT(parent != nullptr);
+
+	parent->m_unfinished_jobs.fetch_add(1, std::memory_order_relaxed);
+	return allocateJob(function, parent, data, size);
+}
+
+void JobSystem::run(Job *job)
+{
+	Worker &worker = getCurrentWorkerChecked();
+
+	if (!worker.m_deque.push(job))
+	{
+		// Deque is full, the workers are busy anyway
+		execute(worker, job);
+		return;
+	}
+
+	if (m_sleeping_workers.load(std::memory_order_relaxed) != 0)
+	{
+		m_wake.notify_one();
+	}
+}
+
+void JobSystem::wait(Job *job)
+{
+	ASSERT(job != nullptr && job->m_parent == nullptr && "Only jobs created with createJob can be waited on!");
+
+	Worker &worker = getCurrentWorkerChecked();
+	while (job->m_unfinished_jobs.load(std::memory_order_acquire) != 0)
+	{
+		if (!executeNext(worker))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	job->m_pool->deallocate(job);
+}
+
+size_t JobSystem::getWorkerCount() const
+{
+	return m_worker_count;
+}
+
+size_t JobSystem::getCurrentWorker() const
+{
+	return getCurrentWorkerChecked().m_index;
+}
+
+JobSystem::Worker &JobSystem::getCurrentWorkerChecked() const
+{
+	ASSERT(s_current_worker != nullptr && "Thread is not a worker of the JobSystem!");
+	return *s_current_worker;
+}
+
+JobSystem::Job *JobSystem::allocateJob(JobFunction function, Job *parent, const void *data, size_t size)
+{
+	ASSERT(size <= JOB_DATA_SIZE && "Job data too large, pass a pointer instead!");
+
+	Worker &worker = getCurrentWorkerChecked();
+
+	// All jobs of this worker are in flight, help finishing them until one comes back
+	while (!worker.m_pool.hasFreeChunks())
+	{
+		if (!executeNext(worker))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	Job *job = worker.m_pool.allocate(function, parent, &worker.m_pool);
+	if (size != 0)
+	{
+		std::memcpy(job->m_data, data, size);
+	}
+	return job;
+}
+
+JobSystem::Job *JobSystem::findJob(Worker &worker)
+{
+	Job *job = worker.m_deque.pop();
+	if (job != nullptr || m_worker_count == 1)
+	{
+		return job;
+	}
+
+	// xorshift32, starts at a different victim every time so thieves don't all pile onto the same worker
+	worker.m_random ^= worker.m_random << 13;
+	worker.m_random ^= worker.m_random >> 17;
+	worker.m_random ^= worker.m_random << 5;
+
+	const size_t first = worker.m_random % m_worker_count;
+	for (size_t i = 0; i < m_worker_count; i++)
+	{
+		Worker &victim = *m_workers[(first + i) % m_worker_count];
+		if (&victim == &worker)
+		{
+			continue;
+		}
+
+		job = victim.m_deque.steal();
+		if (job != nullptr)
+		{
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+bool JobSystem::executeNext(Worker &worker)
+{
+	Job *job = findJob(worker);
+	if (job == nullptr)
+	{
+		return false;
+	}
+
+	execute(worker, job);
+	return true;
+}
+
+void JobSystem::execute(Worker &worker, Job *job)
+{
+	// A worker waiting inside a job executes other jobs, so only the scratch memory of this job is released
+	void *mark = worker.m_scratch.getMark();
+	job->m_function(*this, job, job->m_data, worker.m_scratch);
+	worker.m_scratch.rewind(mark);
+
+	finish(job);
+}
+
+void JobSystem::finish(Job *job)
+{
+	// Nobody waits on child jobs, so the last one touching them releases them
+	Job *parent = job->m_parent;
+	if (job->m_unfinished_jobs.fetch_sub(1, std::memory_order_acq_rel) == 1 && parent != nullptr)
+	{
+		job->m_pool->deallocate(job);
+		finish(parent);
+	}
+}
+
+void JobSystem::workerLoop(Worker &worker)
+{
+	s_current_worker = &worker;
+	worker.m_pool.setOwnerThread();
+
+	size_t idle_spins = 0;
+	while (m_running.load(std::memory_order_acquire))
+	{
+		if (executeNext(worker))
+		{
+			idle_spins = 0;
+		}
+		else if (idle_spins < IDLE_SPINS)
+		{
+			idle_spins++;
+			std::this_thread::yield();
+		}
+		else
+		{
+			// run() only notifies when someone is sleeping, the timeout covers a wake up racing with going to sleep
+			std::unique_lock<std::mutex> lock(m_sleep_mutex);
+			m_sleeping_workers.fetch_add(1, std::memory_order_relaxed);
+			m_wake.wait_for(lock, std::chrono::milliseconds(1));
+			m_sleeping_workers.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	s_current_worker = nullptr;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../Allocators2/FixedLinearAllocator.h"
+#include "WorkStealingDeque.h"
+
+#include "MemoryManagement/PoolAllocator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace arcane
+{
+
+// Work-stealing job scheduler with one worker per core. The thread which creates the JobSystem is worker 0,
+// jobs may only be created, run and waited on from worker threads (e.g. from inside other jobs).
+//
+// Every worker allocates its jobs from its own PoolAllocator and pushes them to its own deque, idle workers
+// steal from the others. Jobs get the scratch arena of the worker executing them, everything allocated from
+// it is released when the job returns.
+class JobSystem
+{
+public:
+    struct Job;
+
+    typedef void (*JobFunction)(JobSystem &job_system, Job *job, const void *data, FixedLinearAllocator &scratch);
+
+    static constexpr size_t JOB_SIZE = 128;
+    static constexpr size_t JOB_DATA_SIZE = JOB_SIZE - 3 * sizeof(void *) - sizeof(int32_t);
+    static constexpr size_t DEFAULT_SCRATCH_SIZE = 64 * 1024;
+    static constexpr size_t DEFAULT_JOBS_PER_WORKER = 4096;
+
+    // Two cache lines, so workers finishing neighbouring jobs don't share a line
+    struct alignas(64) Job
+    {
+        Job(JobFunction function, Job *parent, bbe::PoolAllocator<Job> *pool);
+
+        JobFunction m_function;
+        Job *m_parent;
+        bbe::PoolAllocator<Job> *m_pool;
+        std::atomic<int32_t> m_unfinished_jobs; // The job itself and its unfinished children
+        byte m_data[JOB_DATA_SIZE];
+    };
+
+    static_assert(sizeof(Job) == JOB_SIZE, "Job doesn't fit JOB_SIZE!");
+
+    // worker_count 0 uses one worker per hardware thread, jobs_per_worker has to be a power of two
+    explicit JobSystem(size_t worker_count = 0, size_t scratch_size = DEFAULT_SCRATCH_SIZE, size_t jobs_per_worker = DEFAULT_JOBS_PER_WORKER);
+    ~JobSystem();
+
+    // data (at most JOB_DATA_SIZE bytes) is copied into the job. A job created with createJob has to be
+    // waited on exactly once, child jobs are released automatically when they are finished.
+    Job *createJob(JobFunction function, const void *data = nullptr, size_t size = 0);
+
+    // The parent isn't finished until all of its children are
+    Job *createChildJob(Job *parent, JobFunction function, const void *data = nullptr, size_t size = 0);
+
+    void run(Job *job);
+
+    // Executes other jobs until job is finished, then releases it
+    void wait(Job *job);
+
+    // Calls function(begin, end, scratch) for ranges of at most granularity elements and waits for all of them
+    template <typename Function>
+    void parallelFor(size_t count, size_t granularity, const Function &function);
+
+    size_t getWorkerCount() const;
+
+    // Index of the calling worker thread
+    size_t getCurrentWorker() const;
+
+private:
+    struct Worker
+    {
+        Worker(size_t index, size_t scratch_size, size_t jobs_per_worker);
+        ~Worker();
+
+        size_t m_index;
+        uint32_t m_random; // Picks the first victim for stealing
+        WorkStealingDeque<Job> m_deque;
+        bbe::PoolAllocator<Job> m_pool;
+        byte *m_scratch_memory;
+        FixedLinearAllocator m_scratch;
+        std::thread m_thread;
+    };
+
+    template <typename Function>
+    struct ParallelForRange
+    {
+        const Function *m_function;
+        size_t m_begin;
+        size_t m_end;
+        size_t m_granularity;
+    };
+
+    // Idle workers yield this many times before they go to sleep
+    static const size_t IDLE_SPINS = 64;
+
+    JobSystem(const JobSystem &);
+    JobSystem &operator=(const JobSystem &);
+
+    static thread_local Worker *s_current_worker;
+
+    template <typename Function>
+    static void parallelForJob(JobSystem &job_system, Job *job, const void *data, FixedLinearAllocator &scratch);
+
+    Worker &getCurrentWorkerChecked() const;
+
+    Job *allocateJob(JobFunction function, Job *parent, const void *data, size_t size);
+    Job *findJob(Worker &worker);
+    bool executeNext(Worker &worker);
+    void execute(Worker &worker, Job *job);
+    void finish(Job *job);
+    void workerLoop(Worker &worker);
+
+    Worker **m_workers;
+    size_t m_worker_count;
+
+    std::atomic<bool> m_running;
+    std::atomic<size_t> m_sleeping_workers;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+};
+
+}; // namespace arcane
+
+#include "JobSystem.inl"
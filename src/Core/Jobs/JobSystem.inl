@@ -0,0 +1,44 @@
+#pragma once
+
+#include "JobSystem.h"
+
+namespace arcane
+{
+
+template <typename Function>
+void JobSystem::parallelFor(size_t count, size_t granularity, const Function &function)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    ParallelForRange<Function> range = {&function, 0, count, granularity != 0 ? granularity : 1};
+
+    Job *root = createJob(&parallelForJob<Function>, &range, sizeof(range));
+    run(root);
+    wait(root);
+}
+
+template <typename Function>
+void JobSystem::parallelForJob(JobSystem &job_system, Job *job, const void *data, FixedLinearAllocator &scratch)
+{
+    static_assert(sizeof(ParallelForRange<Function>) <= JOB_DATA_SIZE, "ParallelForRange doesn't fit into a job!");
+
+    ParallelForRange<Function> range = *static_cast<const ParallelForRange<Function> *>(data);
+
+    // Hands the upper half to the other workers and keeps splitting the lower one
+    while (range.m_end - range.m_begin > range.m_granularity)
+    {
+        const size_t middle = range.m_begin + (range.m_end - range.m_begin) / 2;
+
+        ParallelForRange<Function> upper = {range.m_function, middle, range.m_end, range.m_granularity};
+        job_system.run(job_system.createChildJob(job, &parallelForJob<Function>, &upper, sizeof(upper)));
+
+        range.m_end = middle;
+    }
+
+    (*range.m_function)(range.m_begin, range.m_end, scratch);
+}
+
+}; // namespace arcane
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "JobSystem.h"
+
+#include "DataStructures/List.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace arcane
+{
+
+// Parallel versions of the common loops over a bbe::List. The list is cut into chunks which are a multiple of
+// a cache line, so two workers never write to the same line. Lists shorter than SERIAL_CUTOFF elements are
+// processed on the calling worker, splitting them costs more than it saves.
+namespace parallel
+{
+
+static const size_t CACHE_LINE_SIZE = 64;
+static const size_t SERIAL_CUTOFF = 16 * 1024;
+static const size_t MIN_CHUNK_BYTES = 16 * 1024;
+static const size_t CHUNKS_PER_WORKER = 4; // Lets idle workers steal, if some chunks are slower than others
+
+template <typename T>
+size_t getChunkLength(const JobSystem &job_system, size_t length)
+{
+    const size_t elements_per_line = sizeof(T) < CACHE_LINE_SIZE ? CACHE_LINE_SIZE / sizeof(T) : 1;
+
+    size_t chunk_length = length / (job_system.getWorkerCount() * CHUNKS_PER_WORKER);
+    if (chunk_length < MIN_CHUNK_BYTES / sizeof(T))
+    {
+        chunk_length = MIN_CHUNK_BYTES / sizeof(T);
+    }
+
+    return (chunk_length + elements_per_line - 1) / elements_per_line * elements_per_line;
+}
+
+// Calls function(begin, end) for every chunk
+template <typename T, typename Function>
+void forEachChunk(JobSystem &job_system, size_t length, const Function &function)
+{
+    if (length < SERIAL_CUTOFF || job_system.getWorkerCount() == 1)
+    {
+        function(size_t(0), length);
+        return;
+    }
+
+    const size_t chunk_length = getChunkLength<T>(job_system, length);
+    const size_t chunks = (length + chunk_length - 1) / chunk_length;
+
+    job_system.parallelFor(chunks, 1, [&](size_t first_chunk, size_t end_chunk, FixedLinearAllocator &) {
+        for (size_t chunk = first_chunk; chunk < end_chunk; chunk++)
+        {
+            function(chunk * chunk_length, std::min(length, (chunk + 1) * chunk_length));
+        }
+    });
+}
+
+// function(T &)
+template <typename T, bool keepSorted, typename Function>
+void forEach(JobSystem &job_system, bbe::List<T, keepSorted> &list, const Function &function)
+{
+    T *data = list.getRaw();
+    forEachChunk<T>(job_system, list.getLength(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            function(data[i]);
+        }
+    });
+}
+
+// output[i] = function(input[i]), output gets the length of input
+template <typename T, bool keepSorted, typename U, typename Function>
+void transform(JobSystem &job_system, const bbe::List<T, keepSorted> &input, bbe::List<U> &output, const Function &function)
+{
+    if (output.getLength() != input.getLength())
+    {
+        output.clear();
+        output.resizeCapacityAndLength(input.getLength());
+    }
+
+    const T *in = input.getRaw();
+    U *out = output.getRaw();
+    forEachChunk<U>(job_system, input.getLength(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            out[i] = function(in[i]);
+        }
+    });
+}
+
+// accumulate(R, const T &) folds the elements of a chunk, combine(R, R) the results of the chunks.
+// Both have to be associative, the chunks are combined in order.
+template <typename T, bool keepSorted, typename R, typename Accumulate, typename Combine>
+R reduce(JobSystem &job_system, const bbe::List<T, keepSorted> &list, R identity, const Accumulate &accumulate, const Combine &combine)
+{
+    const T *data = list.getRaw();
+    const size_t length = list.getLength();
+
+    if (length < SERIAL_CUTOFF || job_system.getWorkerCount() == 1)
+    {
+        R result = identity;
+        for (size_t i = 0; i < length; i++)
+        {
+            result = accumulate(result, data[i]);
+        }
+        return result;
+    }
+
+    // Partial results on their own cache lines, the workers write them concurrently
+    struct alignas(CACHE_LINE_SIZE) Partial
+    {
+        R m_value;
+    };
+
+    const size_t chunk_length = getChunkLength<T>(job_system, length);
+    const size_t chunks = (length + chunk_length - 1) / chunk_length;
+    std::unique_ptr<Partial[]> partials(new Partial[chunks]);
+
+    job_system.parallelFor(chunks, 1, [&](size_t first_chunk, size_t end_chunk, FixedLinearAllocator &) {
+        for (size_t chunk = first_chunk; chunk < end_chunk; chunk++)
+        {
+            R result = identity;
+            const size_t end = std::min(length, (chunk + 1) * chunk_length);
+            for (size_t i = chunk * chunk_length; i < end; i++)
+            {
+                result = accumulate(result, data[i]);
+            }
+            partials[chunk].m_value = result;
+        }
+    });
+
+    R result = identity;
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+    {
+        result = combine(result, partials[chunk].m_value);
+    }
+    return result;
+}
+
+template <typename T, bool keepSorted, typename R, typename Combine>
+R reduce(JobSystem &job_system, const bbe::List<T, keepSorted> &list, R identity, const Combine &combine)
+{
+    return reduce(job_system, list, identity, combine, combine);
+}
+
+namespace detail
+{
+
+// Amount of elements taken from a for the first k elements of the stable merge of a and b (merge path)
+template <typename T, typename Compare>
+size_t coRank(size_t k, const T *a, size_t a_length, const T *b, size_t b_length, const Compare &compare)
+{
+    size_t low = k > b_length ? k - b_length : 0;
+    size_t high = std::min(k, a_length);
+
+    while (true)
+    {
+        const size_t i = low + (high - low) / 2;
+        const size_t j = k - i;
+
+        if (i > 0 && j < b_length && compare(b[j], a[i - 1]))
+        {
+            high = i - 1; // a[i - 1] belongs behind b[j]
+        }
+        else if (j > 0 && i < a_length && !compare(b[j - 1], a[i]))
+        {
+            low = i + 1; // On equal elements a comes first, so a[i] belongs in front of b[j - 1]
+        }
+        else
+        {
+            return i;
+        }
+    }
+}
+
+// Merges into out, move constructs into raw memory if construct is set, move assigns otherwise
+template <typename T, typename Compare>
+void mergeMove(T *a, T *a_end, T *b, T *b_end, T *out, bool construct, const Compare &compare)
+{
+    auto put = [&](T &value) {
+        if (construct)
+        {
+            new (out) T(std::move(value));
+        }
+        else
+        {
+            *out = std::move(value);
+        }
+        out++;
+    };
+
+    while (a != a_end && b != b_end)
+    {
+        if (compare(*b, *a))
+        {
+            put(*b++);
+        }
+        else
+        {
+            put(*a++);
+        }
+    }
+    while (a != a_end)
+    {
+        put(*a++);
+    }
+    while (b != b_end)
+    {
+        put(*b++);
+    }
+}
+
+}; // namespace detail
+
+// Stable parallel merge sort: sorts one run per chunk, then merges neighbouring runs until one is left.
+// Every merge is split along its merge path, so even the last one runs on all workers.
+template <typename T, bool keepSorted, typename Compare = std::less<T>>
+void sort(JobSystem &job_system, bbe::List<T, keepSorted> &list, const Compare &compare = Compare())
+{
+    T *data = list.getRaw();
+    const size_t length = list.getLength();
+
+    if (length < SERIAL_CUTOFF || job_system.getWorkerCount() == 1)
+    {
+        std::stable_sort(data, data + length, compare);
+        return;
+    }
+
+    const size_t run_length = getChunkLength<T>(job_system, length);
+    const size_t runs = (length + run_length - 1) / run_length;
+
+    job_system.parallelFor(runs, 1, [&](size_t first_run, size_t end_run, FixedLinearAllocator &) {
+        for (size_t run = first_run; run < end_run; run++)
+        {
+            std::stable_sort(data + run * run_length, data + std::min(length, (run + 1) * run_length), compare);
+        }
+    });
+
+    if (runs == 1)
+    {
+        return;
+    }
+
+    // Ping-pong between the list and a buffer, the first merge pass constructs the elements of the buffer
+    std::unique_ptr<bbe::INTERNAL::ListChunk<T>[]> buffer(new bbe::INTERNAL::ListChunk<T>[length]);
+    T *source = data;
+    T *target = reinterpret_cast<T *>(buffer.get());
+    bool construct = true;
+
+    for (size_t width = run_length; width < length; width *= 2)
+    {
+        const size_t pieces_per_pair = (2 * width + run_length - 1) / run_length;
+        const size_t pairs = (length + 2 * width - 1) / (2 * width);
+        const size_t pieces = pairs * pieces_per_pair;
+
+        // Split point in a of every piece, computed before merging because the merge moves out of the source
+        std::unique_ptr<size_t[]> splits(new size_t[pieces]);
+
+        auto getPiece = [&](size_t piece, size_t &pair_begin, size_t &middle, size_t &pair_end, size_t &k) {
+            pair_begin = (piece / pieces_per_pair) * 2 * width;
+            middle = std::min(length, pair_begin + width);
+            pair_end = std::min(length, pair_begin + 2 * width);
+            k = std::min(pair_end - pair_begin, (piece % pieces_per_pair) * run_length);
+        };
+
+        job_system.parallelFor(pieces, 1, [&](size_t first_piece, size_t end_piece, FixedLinearAllocator &) {
+            for (size_t piece = first_piece; piece < end_piece; piece++)
+            {
+                size_t pair_begin, middle, pair_end, k;
+                getPiece(piece, pair_begin, middle, pair_end, k);
+                splits[piece] = detail::coRank(k, source + pair_begin, middle - pair_begin, source + middle, pair_end - middle, compare);
+            }
+        });
+
+        job_system.parallelFor(pieces, 1, [&](size_t first_piece, size_t end_piece, FixedLinearAllocator &) {
+            for (size_t piece = first_piece; piece < end_piece; piece++)
+            {
+                size_t pair_begin, middle, pair_end, k_begin;
+                getPiece(piece, pair_begin, middle, pair_end, k_begin);
+
+                const bool last_of_pair = piece % pieces_per_pair == pieces_per_pair - 1;
+                const size_t k_end = last_of_pair ? pair_end - pair_begin : std::min(pair_end - pair_begin, k_begin + run_length);
+                if (k_begin == k_end)
+                {
+                    continue;
+                }
+
+                const size_t i_begin = splits[piece];
+                const size_t i_end = last_of_pair ? middle - pair_begin : splits[piece + 1];
+
+                T *a = source + pair_begin;
+                T *b = source + middle;
+                detail::mergeMove(a + i_begin, a + i_end, b + (k_begin - i_begin), b + (k_end - i_end),
+                                  target + pair_begin + k_begin, construct, compare);
+            }
+        });
+
+        std::swap(source, target);
+        construct = false;
+    }
+
+    // The buffer always holds constructed elements from here on
+    T *buffer_data = reinterpret_cast<T *>(buffer.get());
+    forEachChunk<T>(job_system, length, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (source != data)
+            {
+                data[i] = std::move(buffer_data[i]);
+            }
+            buffer_data[i].~T();
+        }
+    });
+}
+
+}; // namespace parallel
+
+}; // namespace arcane
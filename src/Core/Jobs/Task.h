@@ -0,0 +1,314 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "Task.h needs coroutine support, compile with -fcoroutines (gcc, C++17) or C++20"
+#endif
+
+#include "../../Utilities/DataTypes.h"
+#include "../../Utilities/Debug.h"
+
+#include "MemoryManagement/PoolAllocator.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace arcane
+{
+
+// Coroutine frames from the global heap
+class HeapFrameAllocator
+{
+public:
+    static void *allocate(size_t size)
+    {
+        return ::operator new(size);
+    }
+
+    static void deallocate(void *p, size_t)
+    {
+        ::operator delete(p);
+    }
+};
+
+// Coroutine frames from a bbe::PoolAllocator of the creating thread. Frames can be destroyed on any thread,
+// they go back through the remote free list of their pool. Frames which are too large or don't fit into the
+// pool anymore come from the global heap. All frames have to be destroyed before their creating thread exits.
+template <size_t FRAME_SIZE = 512, size_t FRAMES_PER_THREAD = 1024>
+class PoolFrameAllocator
+{
+private:
+    struct alignas(std::max_align_t) Frame
+    {
+        Frame() // Leaves m_data uninitialized
+        {
+        }
+
+        byte m_data[FRAME_SIZE];
+    };
+
+    // Keeps the frame behind it aligned like the global operator new would
+    struct alignas(std::max_align_t) Header
+    {
+        bbe::PoolAllocator<Frame> *m_pool;
+    };
+
+    static bbe::PoolAllocator<Frame> &getPool()
+    {
+        static thread_local bbe::PoolAllocator<Frame> pool(FRAMES_PER_THREAD);
+        return pool;
+    }
+
+public:
+    static void *allocate(size_t size)
+    {
+        Header *header;
+
+        bbe::PoolAllocator<Frame> &pool = getPool();
+        if (size + sizeof(Header) <= FRAME_SIZE && pool.hasFreeChunks())
+        {
+            header = reinterpret_cast<Header *>(pool.allocate());
+            header->m_pool = &pool;
+        }
+        else
+        {
+            header = static_cast<Header *>(::operator new(size + sizeof(Header)));
+            header->m_pool = nullptr;
+        }
+
+        return header + 1;
+    }
+
+    static void deallocate(void *p, size_t)
+    {
+        Header *header = static_cast<Header *>(p) - 1;
+        if (header->m_pool != nullptr)
+        {
+            header->m_pool->deallocate(reinterpret_cast<Frame *>(header));
+        }
+        else
+        {
+            ::operator delete(header);
+        }
+    }
+};
+
+template <typename T, typename FrameAllocator>
+class Task;
+
+namespace task_detail
+{
+
+template <typename FrameAllocator>
+class PromiseBase
+{
+public:
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            PromiseBase &promise = handle.promise();
+
+            // Whoever waits for m_done may destroy the frame right away, so nothing is touched afterwards
+            std::coroutine_handle<> continuation = promise.m_continuation;
+            promise.m_done.store(true, std::memory_order_release);
+
+            if (continuation)
+            {
+                return continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    static void *operator new(size_t size)
+    {
+        return FrameAllocator::allocate(size);
+    }
+
+    static void operator delete(void *p, size_t size)
+    {
+        FrameAllocator::deallocate(p, size);
+    }
+
+    // Tasks start when they are awaited or handed to a TaskExecutor
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception()
+    {
+        std::terminate();
+    }
+
+    std::coroutine_handle<> m_continuation;
+    std::atomic<bool> m_done{false};
+};
+
+template <typename T, typename FrameAllocator>
+class Promise : public PromiseBase<FrameAllocator>
+{
+public:
+    Task<T, FrameAllocator> get_return_object();
+
+    template <typename U>
+    void return_value(U &&value)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T &getValue()
+    {
+        ASSERT(m_value.has_value());
+        return *m_value;
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template <typename FrameAllocator>
+class Promise<void, FrameAllocator> : public PromiseBase<FrameAllocator>
+{
+public:
+    Task<void, FrameAllocator> get_return_object();
+
+    void return_void()
+    {
+    }
+
+    void getValue()
+    {
+    }
+};
+
+}; // namespace task_detail
+
+// Lazily started coroutine. Awaiting a Task from another coroutine runs it and continues the awaiting one
+// when it is finished, top level tasks are started and waited on through a TaskExecutor.
+template <typename T, typename FrameAllocator = HeapFrameAllocator>
+class Task
+{
+public:
+    using promise_type = task_detail::Promise<T, FrameAllocator>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+    }
+
+    Task(const Task &other) = delete;
+    Task &operator=(const Task &other) = delete;
+
+    Task(Task &&other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        destroy();
+    }
+
+    bool isDone() const
+    {
+        return m_handle && m_handle.promise().m_done.load(std::memory_order_acquire);
+    }
+
+    // Only valid once isDone() returns true
+    decltype(auto) getResult()
+    {
+        ASSERT(isDone());
+        return m_handle.promise().getValue();
+    }
+
+    std::coroutine_handle<> getHandle() const
+    {
+        return m_handle;
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        m_handle.promise().m_continuation = awaiting;
+        return m_handle;
+    }
+
+    auto await_resume()
+    {
+        if constexpr (std::is_void<T>::value)
+        {
+            return;
+        }
+        else
+        {
+            return std::move(m_handle.promise().getValue());
+        }
+    }
+
+private:
+    void destroy()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace task_detail
+{
+
+template <typename T, typename FrameAllocator>
+Task<T, FrameAllocator> Promise<T, FrameAllocator>::get_return_object()
+{
+    return Task<T, FrameAllocator>(std::coroutine_handle<Promise>::from_promise(*this));
+}
+
+template <typename FrameAllocator>
+Task<void, FrameAllocator> Promise<void, FrameAllocator>::get_return_object()
+{
+    return Task<void, FrameAllocator>(std::coroutine_handle<Promise>::from_promise(*this));
+}
+
+}; // namespace task_detail
+
+}; // namespace arcane
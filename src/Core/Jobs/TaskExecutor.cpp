@@ -0,0 +1,94 @@
+#include "TaskExecutor.h"
+
+using namespace arcane;
+
+TaskExecutor::TaskExecutor(size_t thread_count)
+	: m_running(true)
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::thread::hardware_concurrency();
+	}
+	if (thread_count == 0)
+	{
+		thread_count = 1;
+	}
+
+	for (size_t i = 0; i < thread_count; i++)
+	{
+		m_threads.emplace_back(&TaskExecutor::threadLoop, this);
+	}
+}
+
+TaskExecutor::~TaskExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+	m_wake.notify_all();
+
+	for (size_t i = 0; i < m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+
+	ASSERT(m_queue.empty() && "TaskExecutor destroyed with suspended coroutines left!");
+}
+
+TaskExecutor::ScheduleAwaiter TaskExecutor::schedule()
+{
+	return ScheduleAwaiter{*this};
+}
+
+void TaskExecutor::enqueue(std::coroutine_handle<> handle)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.push_back(handle);
+	}
+	m_wake.notify_one();
+}
+
+bool TaskExecutor::resumeNext()
+{
+	std::coroutine_handle<> handle;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_queue.empty())
+		{
+			return false;
+		}
+		handle = m_queue.front();
+		m_queue.pop_front();
+	}
+
+	handle.resume();
+	return true;
+}
+
+size_t TaskExecutor::getThreadCount() const
+{
+	return m_threads.size();
+}
+
+void TaskExecutor::threadLoop()
+{
+	while (true)
+	{
+		std::coroutine_handle<> handle;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this]() { return !m_queue.empty() || !m_running; });
+
+			if (m_queue.empty())
+			{
+				return;
+			}
+			handle = m_queue.front();
+			m_queue.pop_front();
+		}
+
+		handle.resume();
+	}
+}
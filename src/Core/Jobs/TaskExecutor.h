@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Task.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace arcane
+{
+
+// Thread pool which resumes coroutines. Tasks are started with start() and moved onto the pool from
+// inside a coroutine with co_await executor.schedule().
+class TaskExecutor
+{
+public:
+    struct ScheduleAwaiter
+    {
+        TaskExecutor &m_executor;
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_executor.enqueue(handle);
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    // thread_count 0 uses one thread per hardware thread
+    explicit TaskExecutor(size_t thread_count = 0);
+    ~TaskExecutor();
+
+    ScheduleAwaiter schedule();
+
+    template <typename T, typename FrameAllocator>
+    void start(Task<T, FrameAllocator> &task)
+    {
+        enqueue(task.getHandle());
+    }
+
+    // Resumes queued coroutines on the calling thread until task is finished
+    template <typename T, typename FrameAllocator>
+    void wait(Task<T, FrameAllocator> &task)
+    {
+        while (!task.isDone())
+        {
+            if (!resumeNext())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void enqueue(std::coroutine_handle<> handle);
+
+    // Returns false if nothing was queued
+    bool resumeNext();
+
+    size_t getThreadCount() const;
+
+private:
+    TaskExecutor(const TaskExecutor &);
+    TaskExecutor &operator=(const TaskExecutor &);
+
+    void threadLoop();
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::coroutine_handle<>> m_queue;
+    bool m_running;
+};
+
+}; // namespace arcane
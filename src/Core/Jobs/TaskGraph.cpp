@@ -0,0 +1,263 @@
+#include "TaskGraph.h"
+
+#include <chrono>
+
+using namespace arcane;
+
+TaskGraph::Node::Node(const char *name, TaskFunction function, void *user_data)
+	: m_name(name), m_function(function), m_user_data(user_data), m_successors(nullptr), m_dependency_count(0),
+	  m_pending_dependencies(0), m_nanoseconds(0), m_path_start(0), m_path_prev(nullptr), m_next(nullptr)
+{
+}
+
+TaskGraph::TaskGraph(FixedLinearAllocator &arena)
+	: m_arena(arena), m_first_node(nullptr), m_last_node(nullptr), m_node_count(0), m_root_job(nullptr)
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+}
+
+TaskGraph::Node *TaskGraph::addNode(const char *name, TaskFunction function, void *user_data)
+{
+	ASSERT(function != nullptr);
+
+	Node *node = allocator::allocateNew<Node>(m_arena, name, function, user_data);
+	if (node == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (m_last_node != nullptr)
+	{
+		m_last_node->m_next = node;
+	}
+	else
+	{
+		m_first_node = node;
+	}
+	m_last_node = node;
+	m_node_count++;
+
+	return node;
+}
+
+bool TaskGraph::addDependency(Node *before, Node *after)
+{
+	ASSERT(before != nullptr && after != nullptr && before != after);
+
+	Edge *edge = allocator::allocateNew<Edge>(m_arena);
+	if (edge == nullptr)
+	{
+		return false;
+	}
+
+	edge->m_target = after;
+	edge->m_next = before->m_successors;
+	before->m_successors = edge;
+	after->m_dependency_count++;
+
+	return true;
+}
+
+void TaskGraph::execute(JobSystem &job_system)
+{
+	if (m_node_count == 0)
+	{
+		return;
+	}
+
+	resetPendingDependencies();
+
+	// Every node runs as child of the root job, so waiting on it waits for the whole graph
+	m_root_job = job_system.createJob(&rootJob);
+	for (Node *node = m_first_node; node != nullptr; node = node->m_next)
+	{
+		if (node->m_dependency_count == 0)
+		{
+			NodeJobData data = {this, node};
+			job_system.run(job_system.createChildJob(m_root_job, &nodeJob, &data, sizeof(data)));
+		}
+	}
+
+	job_system.run(m_root_job);
+	job_system.wait(m_root_job);
+	m_root_job = nullptr;
+
+	// Nodes on a cycle never get all of their dependencies finished, so they were never started
+	for (Node *node = m_first_node; node != nullptr; node = node->m_next)
+	{
+		ASSERT(node->m_pending_dependencies.load(std::memory_order_relaxed) == 0 && "Graph has a cycle!");
+	}
+}
+
+void TaskGraph::executeSerial()
+{
+	// The order and the scratch memory of the nodes are only needed during this call
+	void *mark = m_arena.getMark();
+
+	Node **order = computeTopologicalOrder();
+	ASSERT(order != nullptr && "Graph has a cycle or the arena is full!");
+
+	void *scratch_mark = m_arena.getMark();
+	for (size_t i = 0; i < m_node_count; i++)
+	{
+		executeNode(order[i], m_arena);
+		m_arena.rewind(scratch_mark);
+	}
+
+	m_arena.rewind(mark);
+}
+
+TaskGraph::CriticalPath TaskGraph::computeCriticalPath()
+{
+	CriticalPath path = {0, 0, nullptr, 0};
+
+	Node **order = computeTopologicalOrder();
+	if (order == nullptr)
+	{
+		return path;
+	}
+
+	for (size_t i = 0; i < m_node_count; i++)
+	{
+		order[i]->m_path_start = 0;
+		order[i]->m_path_prev = nullptr;
+	}
+
+	// Predecessors come first in the topological order, so every node has its final start when it is reached
+	Node *last = nullptr;
+	for (size_t i = 0; i < m_node_count; i++)
+	{
+		Node *node = order[i];
+		const uint64_t end = node->m_path_start + node->m_nanoseconds;
+		path.m_total_nanoseconds += node->m_nanoseconds;
+
+		for (Edge *edge = node->m_successors; edge != nullptr; edge = edge->m_next)
+		{
+			if (edge->m_target->m_path_start < end || edge->m_target->m_path_prev == nullptr)
+			{
+				edge->m_target->m_path_start = end;
+				edge->m_target->m_path_prev = node;
+			}
+		}
+
+		if (last == nullptr || end > last->m_path_start + last->m_nanoseconds)
+		{
+			last = node;
+		}
+	}
+
+	path.m_nanoseconds = last->m_path_start + last->m_nanoseconds;
+	for (Node *node = last; node != nullptr; node = node->m_path_prev)
+	{
+		path.m_length++;
+	}
+
+	// The topological order isn't needed anymore, reuse it for the path
+	path.m_nodes = order;
+	size_t index = path.m_length;
+	for (Node *node = last; node != nullptr; node = node->m_path_prev)
+	{
+		index--;
+		path.m_nodes[index] = node;
+	}
+
+	return path;
+}
+
+void TaskGraph::clear()
+{
+	ASSERT(m_root_job == nullptr && "Can't clear a graph while it executes!");
+
+	m_first_node = nullptr;
+	m_last_node = nullptr;
+	m_node_count = 0;
+}
+
+size_t TaskGraph::getNodeCount() const
+{
+	return m_node_count;
+}
+
+void TaskGraph::nodeJob(JobSystem &job_system, JobSystem::Job *, const void *data, FixedLinearAllocator &scratch)
+{
+	const NodeJobData &node_data = *static_cast<const NodeJobData *>(data);
+
+	executeNode(node_data.m_node, scratch);
+
+	// The last finished dependency starts the successor
+	for (Edge *edge = node_data.m_node->m_successors; edge != nullptr; edge = edge->m_next)
+	{
+		if (edge->m_target->m_pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			NodeJobData successor = {node_data.m_graph, edge->m_target};
+			job_system.run(job_system.createChildJob(node_data.m_graph->m_root_job, &nodeJob, &successor, sizeof(successor)));
+		}
+	}
+}
+
+void TaskGraph::rootJob(JobSystem &, JobSystem::Job *, const void *, FixedLinearAllocator &)
+{
+}
+
+void TaskGraph::executeNode(Node *node, FixedLinearAllocator &scratch)
+{
+	auto start = std::chrono::steady_clock::now();
+	node->m_function(node->m_user_data, scratch);
+	node->m_nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+TaskGraph::Node **TaskGraph::computeTopologicalOrder()
+{
+	if (m_node_count == 0)
+	{
+		return nullptr;
+	}
+
+	void *mark = m_arena.getMark();
+	Node **order = allocator::allocateArrayNoConstruct<Node *>(m_arena, m_node_count);
+	if (order == nullptr)
+	{
+		return nullptr;
+	}
+
+	resetPendingDependencies();
+
+	size_t end = 0;
+	for (Node *node = m_first_node; node != nullptr; node = node->m_next)
+	{
+		if (node->m_dependency_count == 0)
+		{
+			order[end++] = node;
+		}
+	}
+
+	for (size_t i = 0; i < end; i++)
+	{
+		for (Edge *edge = order[i]->m_successors; edge != nullptr; edge = edge->m_next)
+		{
+			if (edge->m_target->m_pending_dependencies.fetch_sub(1, std::memory_order_relaxed) == 1)
+			{
+				order[end++] = edge->m_target;
+			}
+		}
+	}
+
+	// Nodes on a cycle never get all of their dependencies finished
+	if (end != m_node_count)
+	{
+		m_arena.rewind(mark);
+		return nullptr;
+	}
+	return order;
+}
+
+void TaskGraph::resetPendingDependencies()
+{
+	for (Node *node = m_first_node; node != nullptr; node = node->m_next)
+	{
+		node->m_pending_dependencies.store(node->m_dependency_count, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "JobSystem.h"
+
+#include <atomic>
+#include <type_traits>
+
+namespace arcane
+{
+
+// Frame described as a DAG of tasks. Nodes and edges live in a per-frame FixedLinearAllocator and are never
+// freed one by one, rebuild the graph after clearing the arena. A node runs as soon as all of its
+// dependencies are finished, independent branches run in parallel on the JobSystem.
+class TaskGraph
+{
+public:
+    typedef void (*TaskFunction)(void *user_data, FixedLinearAllocator &scratch);
+
+    struct Node;
+
+    struct Edge
+    {
+        Node *m_target;
+        Edge *m_next;
+    };
+
+    struct Node
+    {
+        Node(const char *name, TaskFunction function, void *user_data);
+
+        const char *m_name;
+        TaskFunction m_function;
+        void *m_user_data;
+
+        Edge *m_successors;
+        size_t m_dependency_count;
+        std::atomic<size_t> m_pending_dependencies; // Counts down while the graph executes
+
+        uint64_t m_nanoseconds; // Duration of the last execution
+
+        // Longest chain of predecessors, filled by computeCriticalPath()
+        uint64_t m_path_start;
+        Node *m_path_prev;
+
+        Node *m_next; // All nodes of the graph, in creation order
+    };
+
+    struct CriticalPath
+    {
+        uint64_t m_nanoseconds;       // Sum of the nodes on the path, the lower bound for the frame
+        uint64_t m_total_nanoseconds; // Sum of all nodes, what a serial execution would take
+        Node **m_nodes;               // In execution order, allocated from the arena
+        size_t m_length;
+    };
+
+    explicit TaskGraph(FixedLinearAllocator &arena);
+    ~TaskGraph();
+
+    // Returns nullptr if the arena is full
+    Node *addNode(const char *name, TaskFunction function, void *user_data = nullptr);
+
+    // The function object is copied into the arena, so it must not need its destructor
+    template <typename Function>
+    Node *addNode(const char *name, const Function &function);
+
+    // after doesn't start before before is finished
+    bool addDependency(Node *before, Node *after);
+
+    void execute(JobSystem &job_system);
+    void executeSerial();
+
+    // Uses the durations of the last execution
+    CriticalPath computeCriticalPath();
+
+    // Forgets all nodes, call it together with clearing the arena
+    void clear();
+
+    size_t getNodeCount() const;
+
+private:
+    struct NodeJobData
+    {
+        TaskGraph *m_graph;
+        Node *m_node;
+    };
+
+    TaskGraph(const TaskGraph &);
+    TaskGraph &operator=(const TaskGraph &);
+
+    template <typename Function>
+    static void callFunction(void *user_data, FixedLinearAllocator &scratch);
+
+    static void nodeJob(JobSystem &job_system, JobSystem::Job *job, const void *data, FixedLinearAllocator &scratch);
+    static void rootJob(JobSystem &job_system, JobSystem::Job *job, const void *data, FixedLinearAllocator &scratch);
+
+    static void executeNode(Node *node, FixedLinearAllocator &scratch);
+
+    // Kahn's algorithm, the array is allocated from the arena. Returns nullptr and gives the array back on a cycle.
+    Node **computeTopologicalOrder();
+
+    void resetPendingDependencies();
+
+    FixedLinearAllocator &m_arena;
+
+    Node *m_first_node;
+    Node *m_last_node;
+    size_t m_node_count;
+
+    JobSystem::Job *m_root_job;
+};
+
+}; // namespace arcane
+
+#include "TaskGraph.inl"
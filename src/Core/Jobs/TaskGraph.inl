@@ -0,0 +1,28 @@
+#pragma once
+
+#include "TaskGraph.h"
+
+namespace arcane
+{
+
+template <typename Function>
+TaskGraph::Node *TaskGraph::addNode(const char *name, const Function &function)
+{
+    static_assert(std::is_trivially_destructible<Function>::value, "The arena never calls destructors!");
+
+    Function *copy = allocator::allocateNew<Function>(m_arena, function);
+    if (copy == nullptr)
+    {
+        return nullptr;
+    }
+
+    return addNode(name, &callFunction<Function>, copy);
+}
+
+template <typename Function>
+void TaskGraph::callFunction(void *user_data, FixedLinearAllocator &scratch)
+{
+    (*static_cast<Function *>(user_data))(scratch);
+}
+
+}; // namespace arcane
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "../../Utilities/DataTypes.h"
+#include "../../Utilities/Debug.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace arcane
+{
+
+// Chase-Lev deque of pointers with a fixed capacity. The owning thread pushes and pops at the bottom (LIFO),
+// any other thread may steal from the top (FIFO). Only steal() may be called concurrently with the owner.
+template <typename T>
+class WorkStealingDeque
+{
+public:
+    // capacity has to be a power of two
+    explicit WorkStealingDeque(size_t capacity)
+        : m_top(0), m_bottom(0), m_buffer(new std::atomic<T *>[capacity]), m_mask(capacity - 1)
+    {
+        ASSERT(capacity != 0 && (capacity & (capacity - 1)) == 0);
+
+        for (size_t i = 0; i < capacity; i++)
+        {
+            m_buffer[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~WorkStealingDeque()
+    {
+        delete[] m_buffer;
+    }
+
+    // Owner only, returns false if the deque is full
+    bool push(T *item)
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top > (int64_t)m_mask)
+        {
+            return false;
+        }
+
+        m_buffer[bottom & m_mask].store(item, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only, returns nullptr if the deque is empty
+    T *pop()
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *item = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // Last item, race against the thieves for it
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                item = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread, returns nullptr if the deque is empty or another thread won the race for the item
+    T *steal()
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+
+        T *item = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // Only a snapshot while other threads are stealing
+    size_t size() const
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? (size_t)(bottom - top) : 0;
+    }
+
+private:
+    WorkStealingDeque(const WorkStealingDeque &);
+    WorkStealingDeque &operator=(const WorkStealingDeque &);
+
+    // Thieves hammer m_top while the owner works on m_bottom, keep them on separate cache lines
+    alignas(64) std::atomic<int64_t> m_top;
+    alignas(64) std::atomic<int64_t> m_bottom;
+    alignas(64) std::atomic<T *> *m_buffer;
+    size_t m_mask;
+};
+
+}; // namespace arcane
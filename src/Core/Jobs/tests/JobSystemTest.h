@@ -0,0 +1,158 @@
+#include "../../../MainTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "../JobSystem.h"
+
+namespace arcane
+{
+
+TEST(JobSystemTest, ParallelForCoversRange)
+{
+    JobSystem jobs(4);
+    std::vector<std::atomic<int>> hits(100000);
+
+    jobs.parallelFor(hits.size(), 256, [&](size_t begin, size_t end, FixedLinearAllocator &) {
+        EXPECT_LE(end - begin, 256);
+        for (size_t i = begin; i < end; i++)
+        {
+            hits[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (size_t i = 0; i < hits.size(); i++)
+    {
+        ASSERT_EQ(hits[i].load(), 1);
+    }
+}
+
+struct ChildJobData
+{
+    std::atomic<size_t> *m_counter;
+    size_t m_depth;
+};
+
+static void spawnTree(JobSystem &jobs, JobSystem::Job *job, const void *data, FixedLinearAllocator &)
+{
+    const ChildJobData &parent = *static_cast<const ChildJobData *>(data);
+    parent.m_counter->fetch_add(1, std::memory_order_relaxed);
+
+    if (parent.m_depth != 0)
+    {
+        ChildJobData child = {parent.m_counter, parent.m_depth - 1};
+        jobs.run(jobs.createChildJob(job, &spawnTree, &child, sizeof(child)));
+        jobs.run(jobs.createChildJob(job, &spawnTree, &child, sizeof(child)));
+    }
+}
+
+TEST(JobSystemTest, ParentWaitsForChildren)
+{
+    JobSystem jobs(4, JobSystem::DEFAULT_SCRATCH_SIZE, 64);
+    std::atomic<size_t> counter(0);
+
+    // More jobs than fit into a pool, finished children have to be recycled
+    ChildJobData root = {&counter, 12};
+    JobSystem::Job *job = jobs.createJob(&spawnTree, &root, sizeof(root));
+    jobs.run(job);
+    jobs.wait(job);
+
+    EXPECT_EQ(counter.load(), (1u << 13) - 1);
+}
+
+TEST(JobSystemTest, ScratchIsReleasedAfterEveryJob)
+{
+    JobSystem jobs(2, 1024);
+    std::atomic<size_t> failed(0);
+
+    // Every job uses most of the arena, that only works if it is released in between
+    jobs.parallelFor(1000, 1, [&](size_t, size_t, FixedLinearAllocator &scratch) {
+        if (scratch.allocate(768) == nullptr)
+        {
+            failed.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    EXPECT_EQ(failed.load(), 0);
+}
+
+TEST(JobSystemBenchmark, ParallelFor)
+{
+    const size_t COUNT = 1 << 22;
+    std::vector<float> values(COUNT);
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        values[i] = (float)i;
+    }
+
+    auto work = [&](size_t begin, size_t end, FixedLinearAllocator &) {
+        for (size_t i = begin; i < end; i++)
+        {
+            values[i] = std::sqrt(values[i] * 1.5f + 1.0f);
+        }
+    };
+
+    byte scratchMemory[64];
+    FixedLinearAllocator scratch(sizeof(scratchMemory), scratchMemory);
+
+    auto start = std::chrono::steady_clock::now();
+    work(0, COUNT, scratch);
+    auto serial = std::chrono::steady_clock::now();
+    double serialMs = std::chrono::duration<double, std::milli>(serial - start).count();
+    GTEST_COUT << "Serial:    " << serialMs << "ms" << std::endl;
+
+    JobSystem jobs;
+    for (size_t granularity = 1024; granularity <= 65536; granularity *= 8)
+    {
+        start = std::chrono::steady_clock::now();
+        jobs.parallelFor(COUNT, granularity, work);
+        double parallelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        GTEST_COUT << jobs.getWorkerCount() << " workers, granularity " << granularity << ": " << parallelMs
+                   << "ms (" << serialMs / parallelMs << "x)" << std::endl;
+    }
+}
+
+static void emptyJob(JobSystem &, JobSystem::Job *, const void *, FixedLinearAllocator &)
+{
+}
+
+TEST(JobSystemBenchmark, EmptyJobLatency)
+{
+    const size_t AMOUNT = 100000;
+    JobSystem jobs;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        JobSystem::Job *job = jobs.createJob(&emptyJob);
+        jobs.run(job);
+        jobs.wait(job);
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    GTEST_COUT << "Create, run and wait: " << elapsed / AMOUNT << "ns per job" << std::endl;
+}
+
+TEST(JobSystemBenchmark, SpawnThroughput)
+{
+    const size_t AMOUNT = 1000000;
+    JobSystem jobs;
+
+    auto start = std::chrono::steady_clock::now();
+    JobSystem::Job *root = jobs.createJob(&emptyJob);
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        jobs.run(jobs.createChildJob(root, &emptyJob));
+    }
+    jobs.run(root);
+    jobs.wait(root);
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    GTEST_COUT << AMOUNT << " jobs on " << jobs.getWorkerCount() << " workers: " << elapsed << "ms ("
+               << AMOUNT / elapsed << " jobs/ms)" << std::endl;
+}
+
+} // namespace arcane
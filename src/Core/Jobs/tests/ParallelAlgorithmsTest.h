@@ -0,0 +1,138 @@
+#include "../../../MainTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "../ParallelAlgorithms.h"
+
+namespace arcane
+{
+
+TEST(ParallelAlgorithmsTest, ForEachTransformReduce)
+{
+    JobSystem jobs(4);
+    const size_t LENGTH = 1000003; // Not a multiple of the chunk length
+
+    bbe::List<uint32_t> list;
+    for (size_t i = 0; i < LENGTH; i++)
+    {
+        list.pushBack((uint32_t)i);
+    }
+
+    parallel::forEach(jobs, list, [](uint32_t &value) { value *= 2; });
+
+    bbe::List<uint64_t> squares;
+    parallel::transform(jobs, list, squares, [](uint32_t value) { return (uint64_t)value * value; });
+    ASSERT_EQ(squares.getLength(), LENGTH);
+
+    uint64_t expected = 0;
+    for (size_t i = 0; i < LENGTH; i++)
+    {
+        ASSERT_EQ(list[i], 2 * i);
+        ASSERT_EQ(squares[i], (uint64_t)(2 * i) * (2 * i));
+        expected += 2 * i;
+    }
+
+    uint64_t sum = parallel::reduce(jobs, list, (uint64_t)0, [](uint64_t a, uint64_t b) { return a + b; });
+    EXPECT_EQ(sum, expected);
+
+    uint32_t max = parallel::reduce(jobs, list, (uint32_t)0, [](uint32_t a, uint32_t b) { return std::max(a, b); });
+    EXPECT_EQ(max, 2 * (LENGTH - 1));
+}
+
+TEST(ParallelAlgorithmsTest, SortIsStable)
+{
+    JobSystem jobs(4);
+    std::mt19937 random(1);
+
+    for (size_t length : {10, 50000, 1000003})
+    {
+        // Few different keys, so many elements compare equal
+        bbe::List<std::pair<uint32_t, uint32_t>> list;
+        for (size_t i = 0; i < length; i++)
+        {
+            list.pushBack(std::make_pair((uint32_t)(random() % 1000), (uint32_t)i));
+        }
+
+        parallel::sort(jobs, list, [](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b) {
+            return a.first < b.first;
+        });
+
+        for (size_t i = 1; i < length; i++)
+        {
+            ASSERT_LE(list[i - 1].first, list[i].first);
+            if (list[i - 1].first == list[i].first)
+            {
+                ASSERT_LT(list[i - 1].second, list[i].second);
+            }
+        }
+    }
+}
+
+TEST(ParallelAlgorithmsTest, SortNonTrivialType)
+{
+    JobSystem jobs(3);
+    bbe::List<std::string> list;
+    for (size_t i = 0; i < 100000; i++)
+    {
+        list.pushBack(std::to_string((i * 7919) % 100000) + " is a string that doesn't fit into the small buffer");
+    }
+
+    parallel::sort(jobs, list);
+
+    ASSERT_EQ(list.getLength(), 100000);
+    for (size_t i = 1; i < list.getLength(); i++)
+    {
+        ASSERT_LT(list[i - 1], list[i]);
+    }
+}
+
+TEST(ParallelAlgorithmsBenchmark, Scaling)
+{
+    const size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::mt19937 random(42);
+
+    for (size_t length = 10000; length <= 100000000; length *= 10)
+    {
+        bbe::List<float> source;
+        source.resizeCapacity(length);
+        for (size_t i = 0; i < length; i++)
+        {
+            source.pushBack((float)(random() % 1000000));
+        }
+
+        // Doubles the threads, the last step is clamped to maxThreads so all cores are measured even if their count
+        // isn't a power of two
+        for (size_t threads = 1; threads <= maxThreads; threads = (threads < maxThreads && threads * 2 > maxThreads) ? maxThreads : threads * 2)
+        {
+            JobSystem jobs(threads);
+            bbe::List<float> list = source;
+            bbe::List<float> output;
+            output.resizeCapacityAndLength(length);
+
+            auto start = std::chrono::steady_clock::now();
+            parallel::forEach(jobs, list, [](float &value) { value = value * 0.5f + 1.0f; });
+            auto forEachEnd = std::chrono::steady_clock::now();
+            parallel::transform(jobs, list, output, [](float value) { return value * value; });
+            auto transformEnd = std::chrono::steady_clock::now();
+            volatile double sum = parallel::reduce(jobs, output, 0.0, [](double a, float b) { return a + b; }, [](double a, double b) { return a + b; });
+            auto reduceEnd = std::chrono::steady_clock::now();
+            parallel::sort(jobs, list);
+            auto sortEnd = std::chrono::steady_clock::now();
+            (void)sum;
+
+            auto ms = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+                return std::chrono::duration<double, std::milli>(b - a).count();
+            };
+            GTEST_COUT << length << " elements, " << threads << " threads: forEach " << ms(start, forEachEnd)
+                       << "ms, transform " << ms(forEachEnd, transformEnd) << "ms, reduce " << ms(transformEnd, reduceEnd)
+                       << "ms, sort " << ms(reduceEnd, sortEnd) << "ms" << std::endl;
+        }
+    }
+}
+
+} // namespace arcane
@@ -0,0 +1,199 @@
+#include "../../../MainTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../TaskGraph.h"
+
+namespace arcane
+{
+
+struct TaskGraphTest : testing::Test
+{
+    byte *m_memory;
+    FixedLinearAllocator *m_arena;
+    const size_t MEMORY_SIZE = 1024 * 1024;
+
+    TaskGraphTest()
+    {
+        m_memory = new byte[MEMORY_SIZE];
+        m_arena = new FixedLinearAllocator(MEMORY_SIZE, m_memory);
+    }
+
+    virtual ~TaskGraphTest()
+    {
+        m_arena->clear();
+        delete m_arena;
+        delete[] m_memory;
+    }
+};
+
+static void spin(std::chrono::microseconds duration)
+{
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end)
+    {
+    }
+}
+
+TEST_F(TaskGraphTest, RespectsDependencies)
+{
+    JobSystem jobs(4);
+    TaskGraph graph(*m_arena);
+    std::atomic<size_t> clock(0);
+    size_t finished[6] = {};
+
+    // input -> simulation, animation -> culling -> render, audio runs on its own
+    TaskGraph::Node *nodes[6];
+    for (size_t i = 0; i < 6; i++)
+    {
+        nodes[i] = graph.addNode("node", [&, i](FixedLinearAllocator &) {
+            finished[i] = clock.fetch_add(1) + 1;
+        });
+    }
+    graph.addDependency(nodes[0], nodes[1]);
+    graph.addDependency(nodes[0], nodes[2]);
+    graph.addDependency(nodes[1], nodes[3]);
+    graph.addDependency(nodes[2], nodes[3]);
+    graph.addDependency(nodes[3], nodes[4]);
+
+    for (int frame = 0; frame < 100; frame++)
+    {
+        clock = 0;
+        graph.execute(jobs);
+
+        EXPECT_EQ(clock.load(), 6);
+        EXPECT_LT(finished[0], finished[1]);
+        EXPECT_LT(finished[0], finished[2]);
+        EXPECT_LT(finished[1], finished[3]);
+        EXPECT_LT(finished[2], finished[3]);
+        EXPECT_LT(finished[3], finished[4]);
+        EXPECT_NE(finished[5], 0);
+    }
+
+    clock = 0;
+    graph.executeSerial();
+    EXPECT_EQ(clock.load(), 6);
+    EXPECT_LT(finished[3], finished[4]);
+}
+
+TEST_F(TaskGraphTest, CriticalPath)
+{
+    JobSystem jobs(2);
+    TaskGraph graph(*m_arena);
+
+    TaskGraph::Node *input = graph.addNode("input", [](FixedLinearAllocator &) { spin(std::chrono::microseconds(100)); });
+    TaskGraph::Node *physics = graph.addNode("physics", [](FixedLinearAllocator &) { spin(std::chrono::microseconds(5000)); });
+    TaskGraph::Node *audio = graph.addNode("audio", [](FixedLinearAllocator &) { spin(std::chrono::microseconds(100)); });
+    TaskGraph::Node *render = graph.addNode("render", [](FixedLinearAllocator &) { spin(std::chrono::microseconds(100)); });
+    graph.addDependency(input, physics);
+    graph.addDependency(input, audio);
+    graph.addDependency(physics, render);
+    graph.addDependency(audio, render);
+
+    graph.execute(jobs);
+    TaskGraph::CriticalPath path = graph.computeCriticalPath();
+
+    ASSERT_EQ(path.m_length, 3);
+    EXPECT_EQ(path.m_nodes[0], input);
+    EXPECT_EQ(path.m_nodes[1], physics);
+    EXPECT_EQ(path.m_nodes[2], render);
+    EXPECT_GE(path.m_nanoseconds, 5000000);
+    EXPECT_GT(path.m_total_nanoseconds, path.m_nanoseconds);
+}
+
+TEST_F(TaskGraphTest, DetectsCycles)
+{
+    TaskGraph graph(*m_arena);
+    TaskGraph::Node *a = graph.addNode("a", [](FixedLinearAllocator &) {});
+    TaskGraph::Node *b = graph.addNode("b", [](FixedLinearAllocator &) {});
+    graph.addDependency(a, b);
+    graph.addDependency(b, a);
+
+    // Failed queries don't use up the arena
+    void *mark = m_arena->getMark();
+    EXPECT_EQ(graph.computeCriticalPath().m_length, 0);
+    EXPECT_EQ(graph.computeCriticalPath().m_length, 0);
+    EXPECT_EQ(m_arena->getMark(), mark);
+}
+
+// Synthetic frame: input -> simulation -> animation -> culling, every node depends on a few of the previous stage
+static void buildFrameGraph(TaskGraph &graph, std::vector<float> &data, size_t workPerNode)
+{
+    const size_t STAGES[] = {20, 200, 160, 120};
+    std::mt19937 random(42);
+
+    std::vector<TaskGraph::Node *> previous;
+    std::vector<TaskGraph::Node *> current;
+    size_t node = 0;
+    for (size_t stage : STAGES)
+    {
+        current.clear();
+        for (size_t i = 0; i < stage; i++, node++)
+        {
+            float *values = &data[node * workPerNode];
+            current.push_back(graph.addNode("node", [values, workPerNode](FixedLinearAllocator &) {
+                for (size_t k = 0; k < workPerNode; k++)
+                {
+                    values[k] = values[k] * 0.99f + 1.0f;
+                }
+            }));
+
+            for (size_t d = 0; d < 3 && !previous.empty(); d++)
+            {
+                graph.addDependency(previous[random() % previous.size()], current.back());
+            }
+        }
+        previous = current;
+    }
+}
+
+struct TaskGraphBenchmark : TaskGraphTest
+{
+};
+
+TEST_F(TaskGraphBenchmark, Execute500Nodes)
+{
+    const size_t FRAMES = 100;
+    const size_t NODES = 500;
+    JobSystem jobs;
+
+    for (size_t workPerNode : {0, 1000, 20000})
+    {
+        std::vector<float> data(NODES * (workPerNode + 1));
+
+        m_arena->clear();
+        TaskGraph graph(*m_arena);
+
+        auto start = std::chrono::steady_clock::now();
+        buildFrameGraph(graph, data, workPerNode);
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ASSERT_EQ(graph.getNodeCount(), NODES);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < FRAMES; frame++)
+        {
+            graph.executeSerial();
+        }
+        double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+
+        start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < FRAMES; frame++)
+        {
+            graph.execute(jobs);
+        }
+        double parallelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+
+        TaskGraph::CriticalPath path = graph.computeCriticalPath();
+        GTEST_COUT << "Work " << workPerNode << ": build " << buildMs << "ms, serial " << serialMs << "ms, "
+                   << jobs.getWorkerCount() << " workers " << parallelMs << "ms, overhead "
+                   << (parallelMs - serialMs) * 1000000.0 / NODES << "ns per node" << std::endl;
+        GTEST_COUT << "    critical path " << path.m_length << " nodes " << path.m_nanoseconds / 1e6 << "ms of "
+                   << path.m_total_nanoseconds / 1e6 << "ms work" << std::endl;
+    }
+}
+
+} // namespace arcane
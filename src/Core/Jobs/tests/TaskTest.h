@@ -0,0 +1,151 @@
+#include "../../../MainTest.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../TaskExecutor.h"
+
+namespace arcane
+{
+
+typedef PoolFrameAllocator<> TestFrameAllocator;
+
+template <typename FrameAllocator>
+static Task<int, FrameAllocator> add(int a, int b)
+{
+    co_return a + b;
+}
+
+template <typename FrameAllocator>
+static Task<int, FrameAllocator> sumOfSums()
+{
+    int first = co_await add<FrameAllocator>(1, 2);
+    int second = co_await add<FrameAllocator>(3, 4);
+    co_return first + second;
+}
+
+TEST(TaskTest, AwaitsNestedTasks)
+{
+    TaskExecutor executor(2);
+
+    Task<int> heapTask = sumOfSums<HeapFrameAllocator>();
+    Task<int, TestFrameAllocator> poolTask = sumOfSums<TestFrameAllocator>();
+    EXPECT_FALSE(heapTask.isDone());
+
+    executor.start(heapTask);
+    executor.start(poolTask);
+    executor.wait(heapTask);
+    executor.wait(poolTask);
+
+    EXPECT_EQ(heapTask.getResult(), 10);
+    EXPECT_EQ(poolTask.getResult(), 10);
+}
+
+static Task<std::thread::id, TestFrameAllocator> switchThread(TaskExecutor &executor)
+{
+    co_await executor.schedule();
+    co_return std::this_thread::get_id();
+}
+
+static Task<void, TestFrameAllocator> loadAssets(TaskExecutor &executor, std::vector<int> &loaded, std::vector<std::thread::id> &threads)
+{
+    for (int i = 0; i < 10; i++)
+    {
+        threads.push_back(co_await switchThread(executor));
+        loaded.push_back(i);
+    }
+}
+
+TEST(TaskTest, ResumesOnThreadPool)
+{
+    TaskExecutor executor(2);
+    std::vector<int> loaded;
+    std::vector<std::thread::id> threads;
+
+    {
+        // The inner frames are created on the pool threads and freed on them as well
+        Task<void, TestFrameAllocator> task = loadAssets(executor, loaded, threads);
+        task.getHandle().resume();
+        while (!task.isDone())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    ASSERT_EQ(loaded.size(), 10);
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        EXPECT_NE(threads[i], std::this_thread::get_id());
+    }
+}
+
+template <typename FrameAllocator>
+static double benchmarkCreateResume(size_t amount)
+{
+    int64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < amount; i++)
+    {
+        Task<int, FrameAllocator> task = add<FrameAllocator>((int)i, 1);
+        task.getHandle().resume();
+        sum += task.getResult();
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(sum, (int64_t)amount * (int64_t)(amount + 1) / 2);
+    return elapsed / amount;
+}
+
+template <typename FrameAllocator>
+static double benchmarkNested(size_t amount)
+{
+    int64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < amount; i++)
+    {
+        Task<int, FrameAllocator> task = sumOfSums<FrameAllocator>();
+        task.getHandle().resume();
+        sum += task.getResult();
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(sum, (int64_t)amount * 10);
+    return elapsed / amount;
+}
+
+TEST(TaskBenchmark, CreateResumeDestroy)
+{
+    const size_t AMOUNT = 1000000;
+
+    GTEST_COUT << "Single task, heap: " << benchmarkCreateResume<HeapFrameAllocator>(AMOUNT) << "ns" << std::endl;
+    GTEST_COUT << "Single task, pool: " << benchmarkCreateResume<TestFrameAllocator>(AMOUNT) << "ns" << std::endl;
+    GTEST_COUT << "3 nested tasks, heap: " << benchmarkNested<HeapFrameAllocator>(AMOUNT) << "ns" << std::endl;
+    GTEST_COUT << "3 nested tasks, pool: " << benchmarkNested<TestFrameAllocator>(AMOUNT) << "ns" << std::endl;
+}
+
+template <typename FrameAllocator>
+static Task<int, FrameAllocator> hop(TaskExecutor &executor, int value)
+{
+    co_await executor.schedule();
+    co_return value;
+}
+
+TEST(TaskBenchmark, ExecutorRoundTrip)
+{
+    const size_t AMOUNT = 100000;
+    TaskExecutor executor;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < AMOUNT; i++)
+    {
+        Task<int, TestFrameAllocator> task = hop<TestFrameAllocator>(executor, (int)i);
+        task.getHandle().resume();
+        executor.wait(task);
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    GTEST_COUT << "Create, schedule on " << executor.getThreadCount() << " threads and wait: " << elapsed / AMOUNT << "ns" << std::endl;
+}
+
+} // namespace arcane